@@ -1,6 +1,13 @@
 #include "AnalyticsController.h"
+#include "DriveCatalog.h"
+#include "IdHelper.h"
 #include "MongoService.h"
 #include "PlacementService.h"
+#include "StatsService.h"
+#include "RollupService.h"
+#include "PivotService.h"
+#include "ApplyBatcher.h"
+#include "ResumeStore.h"
 #include "JsonHelper.h"
 #include <bsoncxx/builder/basic/document.hpp>
 #include <bsoncxx/builder/basic/kvp.hpp>
@@ -12,7 +19,96 @@ using bsoncxx::builder::basic::make_document;
 void AnalyticsController::getAnalytics(const drogon::HttpRequestPtr &req,
                                         std::function<void(const drogon::HttpResponsePtr &)> &&callback) {
     auto result = PlacementService::getAnalytics();
-    callback(drogon::HttpResponse::newHttpJsonResponse(result));
+    callback(JsonHelper::jsonResponse(result));
+}
+
+void AnalyticsController::reconcileAnalytics(const drogon::HttpRequestPtr &req,
+                                              std::function<void(const drogon::HttpResponsePtr &)> &&callback) {
+    try {
+        auto result = StatsService::instance().reconcile();
+        result["rollups"] = RollupService::rebuild()["rollups"];
+        callback(JsonHelper::jsonResponse(result));
+    } catch (const std::exception& e) {
+        auto resp = JsonHelper::jsonResponse(
+            JsonHelper::errorResponse(std::string("Reconcile failed: ") + e.what()));
+        resp->setStatusCode(drogon::k500InternalServerError);
+        callback(resp);
+    }
+}
+
+void AnalyticsController::getTrends(const drogon::HttpRequestPtr &req,
+                                    std::function<void(const drogon::HttpResponsePtr &)> &&callback) {
+    std::string granularity = req->getParameter("granularity");
+    if (granularity.empty()) granularity = "day";
+    if (granularity != "day" && granularity != "week" && granularity != "month") {
+        auto resp = JsonHelper::jsonResponse(
+            JsonHelper::errorResponse("granularity must be day, week or month"));
+        resp->setStatusCode(drogon::k400BadRequest);
+        callback(resp);
+        return;
+    }
+
+    try {
+        auto result = RollupService::getTrends(req->getParameter("from"), req->getParameter("to"),
+                                               granularity, req->getParameter("group_by"),
+                                               req->getParameter("department"), req->getParameter("status"));
+        auto resp = JsonHelper::jsonResponse(result);
+        if (!result["success"].asBool()) {
+            resp->setStatusCode(drogon::k400BadRequest);
+        }
+        callback(resp);
+    } catch (const std::exception& e) {
+        auto resp = JsonHelper::jsonResponse(
+            JsonHelper::errorResponse(std::string("Failed to load trends: ") + e.what()));
+        resp->setStatusCode(drogon::k500InternalServerError);
+        callback(resp);
+    }
+}
+
+void AnalyticsController::getPivotSchema(const drogon::HttpRequestPtr &req,
+                                         std::function<void(const drogon::HttpResponsePtr &)> &&callback) {
+    auto result = PivotService::instance().schema();
+    auto resp = JsonHelper::jsonResponse(result);
+    if (!result["success"].asBool()) {
+        resp->setStatusCode(drogon::k503ServiceUnavailable);
+    }
+    callback(resp);
+}
+
+void AnalyticsController::runPivot(const drogon::HttpRequestPtr &req,
+                                   std::function<void(const drogon::HttpResponsePtr &)> &&callback) {
+    auto json = req->getJsonObject();
+    if (!json) {
+        auto resp = JsonHelper::jsonResponse(
+            JsonHelper::errorResponse("Invalid JSON body"));
+        resp->setStatusCode(drogon::k400BadRequest);
+        callback(resp);
+        return;
+    }
+
+    auto result = PivotService::instance().pivot(*json);
+    auto resp = JsonHelper::jsonResponse(result);
+    if (!result["success"].asBool()) {
+        resp->setStatusCode(result["building"].asBool() ? drogon::k503ServiceUnavailable
+                                                        : drogon::k400BadRequest);
+    }
+    callback(resp);
+}
+
+void AnalyticsController::getApplyBatcherStats(const drogon::HttpRequestPtr &req,
+                                               std::function<void(const drogon::HttpResponsePtr &)> &&callback) {
+    callback(JsonHelper::jsonResponse(ApplyBatcher::instance().stats()));
+}
+
+void AnalyticsController::getDriveFunnel(const drogon::HttpRequestPtr &req,
+                                          std::function<void(const drogon::HttpResponsePtr &)> &&callback,
+                                          const std::string &id) {
+    auto result = StatsService::instance().driveFunnel(id);
+    auto resp = JsonHelper::jsonResponse(result);
+    if (!result["success"].asBool()) {
+        resp->setStatusCode(drogon::k404NotFound);
+    }
+    callback(resp);
 }
 
 void AnalyticsController::getNotifications(const drogon::HttpRequestPtr &req,
@@ -26,7 +122,7 @@ void AnalyticsController::getNotifications(const drogon::HttpRequestPtr &req,
     opts.limit(50);
 
     auto cursor = notifications.find(
-        make_document(kvp("user_id", userId)),
+        make_document(kvp("user_id", IdHelper::match(userId).view())),
         opts
     );
 
@@ -41,14 +137,14 @@ void AnalyticsController::getNotifications(const drogon::HttpRequestPtr &req,
 
     // Count unread
     int64_t unreadCount = notifications.count_documents(
-        make_document(kvp("user_id", userId), kvp("read", false))
+        make_document(kvp("user_id", IdHelper::match(userId).view()), kvp("read", false))
     );
 
     Json::Value result;
     result["success"] = true;
     result["notifications"] = notifList;
     result["unread_count"] = static_cast<Json::Int64>(unreadCount);
-    callback(drogon::HttpResponse::newHttpJsonResponse(result));
+    callback(JsonHelper::jsonResponse(result));
 }
 
 void AnalyticsController::markNotificationRead(const drogon::HttpRequestPtr &req,
@@ -65,9 +161,9 @@ void AnalyticsController::markNotificationRead(const drogon::HttpRequestPtr &req
         Json::Value result;
         result["success"] = true;
         result["message"] = "Notification marked as read";
-        callback(drogon::HttpResponse::newHttpJsonResponse(result));
+        callback(JsonHelper::jsonResponse(result));
     } catch (const std::exception& e) {
-        auto resp = drogon::HttpResponse::newHttpJsonResponse(
+        auto resp = JsonHelper::jsonResponse(
             JsonHelper::errorResponse("Invalid notification ID"));
         resp->setStatusCode(drogon::k400BadRequest);
         callback(resp);
@@ -84,15 +180,16 @@ void AnalyticsController::getAllStudents(const drogon::HttpRequestPtr &req,
     for (auto& doc : cursor) {
         Json::Value student = JsonHelper::bsonToJson(doc);
         if (doc.find("user_id") != doc.end()) {
-            student["id"] = std::string(doc["user_id"].get_string().value);
+            student["id"] = IdHelper::str(doc["user_id"]);
         }
+        ResumeStore::signResumeUrl(student);
         studentsList.append(student);
     }
 
     Json::Value result;
     result["success"] = true;
     result["students"] = studentsList;
-    callback(drogon::HttpResponse::newHttpJsonResponse(result));
+    callback(JsonHelper::jsonResponse(result));
 }
 
 void AnalyticsController::getAllApplications(const drogon::HttpRequestPtr &req,
@@ -100,7 +197,6 @@ void AnalyticsController::getAllApplications(const drogon::HttpRequestPtr &req,
     auto client = MongoService::instance().acquireClient();
     auto applications = MongoService::instance().getCollection(client, "applications");
     auto students = MongoService::instance().getCollection(client, "students");
-    auto companies = MongoService::instance().getCollection(client, "companies");
 
     auto cursor = applications.find({});
 
@@ -112,23 +208,15 @@ void AnalyticsController::getAllApplications(const drogon::HttpRequestPtr &req,
         }
 
         // Attach student info
-        std::string studentId = std::string(doc["student_id"].get_string().value);
-        auto studentOpt = students.find_one(make_document(kvp("user_id", studentId)));
+        std::string studentId = IdHelper::str(doc["student_id"]);
+        auto studentOpt = students.find_one(make_document(kvp("user_id", IdHelper::match(studentId).view())));
         if (studentOpt) {
             app["student"] = JsonHelper::bsonToJson(studentOpt->view());
+            ResumeStore::signResumeUrl(app["student"]);
         }
 
-        // Attach company info
-        std::string companyId = std::string(doc["company_id"].get_string().value);
-        try {
-            auto companyOpt = companies.find_one(
-                make_document(kvp("_id", bsoncxx::oid{companyId}))
-            );
-            if (companyOpt) {
-                app["company"] = JsonHelper::bsonToJson(companyOpt->view());
-                app["company"]["id"] = companyId;
-            }
-        } catch (...) {}
+        // Attach company info, current as of the drive catalog
+        DriveCatalog::instance().attachCompany(app, doc);
 
         appsList.append(app);
     }
@@ -136,5 +224,5 @@ void AnalyticsController::getAllApplications(const drogon::HttpRequestPtr &req,
     Json::Value result;
     result["success"] = true;
     result["applications"] = appsList;
-    callback(drogon::HttpResponse::newHttpJsonResponse(result));
+    callback(JsonHelper::jsonResponse(result));
 }
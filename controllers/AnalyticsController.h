@@ -6,6 +6,12 @@ class AnalyticsController : public drogon::HttpController<AnalyticsController> {
 public:
     METHOD_LIST_BEGIN
     ADD_METHOD_TO(AnalyticsController::getAnalytics, "/api/analytics", drogon::Get, "AuthFilter", "TpoFilter");
+    ADD_METHOD_TO(AnalyticsController::reconcileAnalytics, "/api/analytics/reconcile", drogon::Post, "AuthFilter", "TpoFilter");
+    ADD_METHOD_TO(AnalyticsController::getTrends, "/api/analytics/trends", drogon::Get, "AuthFilter", "TpoFilter");
+    ADD_METHOD_TO(AnalyticsController::getPivotSchema, "/api/analytics/pivot", drogon::Get, "AuthFilter", "TpoFilter");
+    ADD_METHOD_TO(AnalyticsController::runPivot, "/api/analytics/pivot", drogon::Post, "AuthFilter", "TpoFilter");
+    ADD_METHOD_TO(AnalyticsController::getApplyBatcherStats, "/api/analytics/apply-batcher", drogon::Get, "AuthFilter", "TpoFilter");
+    ADD_METHOD_TO(AnalyticsController::getDriveFunnel, "/api/analytics/drives/{id}", drogon::Get, "AuthFilter", "TpoFilter");
     ADD_METHOD_TO(AnalyticsController::getNotifications, "/api/notifications", drogon::Get, "AuthFilter");
     ADD_METHOD_TO(AnalyticsController::markNotificationRead, "/api/notifications/{id}/read", drogon::Put, "AuthFilter");
     ADD_METHOD_TO(AnalyticsController::getAllStudents, "/api/students", drogon::Get, "AuthFilter", "TpoFilter");
@@ -14,6 +20,19 @@ public:
 
     void getAnalytics(const drogon::HttpRequestPtr &req,
                       std::function<void(const drogon::HttpResponsePtr &)> &&callback);
+    void reconcileAnalytics(const drogon::HttpRequestPtr &req,
+                            std::function<void(const drogon::HttpResponsePtr &)> &&callback);
+    void getTrends(const drogon::HttpRequestPtr &req,
+                   std::function<void(const drogon::HttpResponsePtr &)> &&callback);
+    void getPivotSchema(const drogon::HttpRequestPtr &req,
+                        std::function<void(const drogon::HttpResponsePtr &)> &&callback);
+    void runPivot(const drogon::HttpRequestPtr &req,
+                  std::function<void(const drogon::HttpResponsePtr &)> &&callback);
+    void getApplyBatcherStats(const drogon::HttpRequestPtr &req,
+                              std::function<void(const drogon::HttpResponsePtr &)> &&callback);
+    void getDriveFunnel(const drogon::HttpRequestPtr &req,
+                        std::function<void(const drogon::HttpResponsePtr &)> &&callback,
+                        const std::string &id);
     void getNotifications(const drogon::HttpRequestPtr &req,
                           std::function<void(const drogon::HttpResponsePtr &)> &&callback);
     void markNotificationRead(const drogon::HttpRequestPtr &req,
@@ -1,24 +1,43 @@
 #include "ApplicationController.h"
+#include "IdHelper.h"
 #include "MongoService.h"
 #include "PlacementService.h"
+#include "DriveCatalog.h"
+#include "ApplicationStatus.h"
 #include "JsonHelper.h"
 #include <bsoncxx/builder/basic/document.hpp>
 #include <bsoncxx/builder/basic/kvp.hpp>
+#include <bsoncxx/builder/basic/array.hpp>
+#include <mongocxx/options/find_one_and_update.hpp>
+#include <mongocxx/model/update_one.hpp>
+#include <mongocxx/model/write.hpp>
 #include <bsoncxx/oid.hpp>
+#include <algorithm>
 #include <chrono>
+#include <iostream>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
 
 using bsoncxx::builder::basic::kvp;
 using bsoncxx::builder::basic::make_document;
 
+namespace {
+
+// Largest batch accepted by the bulk status endpoint
+constexpr Json::ArrayIndex kMaxBulkIds = 1000;
+
+} // anonymous namespace
+
 void ApplicationController::updateStatus(const drogon::HttpRequestPtr &req,
                                           std::function<void(const drogon::HttpResponsePtr &)> &&callback,
                                           const std::string &id) {
     auto role = req->attributes()->get<std::string>("role");
-    auto userId = req->attributes()->get<std::string>("user_id");
 
     // Only TPO and recruiter can update status
     if (role != "tpo" && role != "recruiter") {
-        auto resp = drogon::HttpResponse::newHttpJsonResponse(
+        auto resp = JsonHelper::jsonResponse(
             JsonHelper::errorResponse("Only TPO or recruiter can update application status"));
         resp->setStatusCode(drogon::k403Forbidden);
         callback(resp);
@@ -27,7 +46,7 @@ void ApplicationController::updateStatus(const drogon::HttpRequestPtr &req,
 
     auto json = req->getJsonObject();
     if (!json || !json->isMember("status")) {
-        auto resp = drogon::HttpResponse::newHttpJsonResponse(
+        auto resp = JsonHelper::jsonResponse(
             JsonHelper::errorResponse("status is required"));
         resp->setStatusCode(drogon::k400BadRequest);
         callback(resp);
@@ -36,101 +55,297 @@ void ApplicationController::updateStatus(const drogon::HttpRequestPtr &req,
 
     std::string newStatus = (*json)["status"].asString();
 
-    auto client = MongoService::instance().acquireClient();
-    auto applications = MongoService::instance().getCollection(client, "applications");
+    auto target = ApplicationStatus::parse(newStatus);
 
+    // Statuses that may move to the target; the update only matches those,
+    // so two concurrent reviewers cannot both pass the transition check
+    auto from = target ? PlacementService::predecessorsOf(*target) : std::vector<std::string>{};
+    if (from.empty()) {
+        auto resp = JsonHelper::jsonResponse(
+            JsonHelper::errorResponse("Invalid status: " + newStatus));
+        resp->setStatusCode(drogon::k400BadRequest);
+        callback(resp);
+        return;
+    }
+
+    bsoncxx::oid appOid;
     try {
-        auto appOpt = applications.find_one(
-            make_document(kvp("_id", bsoncxx::oid{id}))
-        );
+        appOid = bsoncxx::oid{id};
+    } catch (const std::exception& e) {
+        auto resp = JsonHelper::jsonResponse(
+            JsonHelper::errorResponse("Invalid application ID"));
+        resp->setStatusCode(drogon::k400BadRequest);
+        callback(resp);
+        return;
+    }
 
-        if (!appOpt) {
-            auto resp = drogon::HttpResponse::newHttpJsonResponse(
-                JsonHelper::errorResponse("Application not found"));
-            resp->setStatusCode(drogon::k404NotFound);
-            callback(resp);
-            return;
-        }
+    bsoncxx::builder::basic::array fromArr;
+    for (const auto& status : from) fromArr.append(status);
 
-        std::string currentStatus = std::string(appOpt->view()["status"].get_string().value);
-        std::string companyId = std::string(appOpt->view()["company_id"].get_string().value);
-        std::string studentId = std::string(appOpt->view()["student_id"].get_string().value);
-
-        // Recruiter scoping: verify access to this application's drive
-        if (role == "recruiter") {
-            auto users = MongoService::instance().getCollection(client, "users");
-            auto userOpt = users.find_one(
-                make_document(kvp("_id", bsoncxx::oid{userId}))
-            );
-            bool hasAccess = false;
-            if (userOpt && userOpt->view().find("assigned_drives") != userOpt->view().end()) {
-                auto arr = userOpt->view()["assigned_drives"].get_array().value;
-                for (auto& driveId : arr) {
-                    if (driveId.type() == bsoncxx::type::k_string &&
-                        std::string(driveId.get_string().value) == companyId) {
-                        hasAccess = true;
-                        break;
-                    }
-                }
-            }
-            if (!hasAccess) {
-                auto resp = drogon::HttpResponse::newHttpJsonResponse(
-                    JsonHelper::errorResponse("Access denied to this application"));
-                resp->setStatusCode(drogon::k403Forbidden);
-                callback(resp);
-                return;
-            }
-        }
+    bsoncxx::builder::basic::document filter;
+    filter.append(kvp("_id", appOid));
+    filter.append(kvp("status", make_document(kvp("$in", fromArr))));
 
-        if (!PlacementService::isValidStatusTransition(currentStatus, newStatus)) {
-            auto resp = drogon::HttpResponse::newHttpJsonResponse(
-                JsonHelper::errorResponse("Invalid status transition from " + currentStatus + " to " + newStatus));
-            resp->setStatusCode(drogon::k400BadRequest);
-            callback(resp);
-            return;
-        }
+    // Recruiter scoping: only applications on drives assigned to them
+    std::vector<std::string> assignedDrives;
+    if (role == "recruiter") {
+        assignedDrives = req->attributes()->get<std::vector<std::string>>("assigned_drives");
+        filter.append(kvp("company_id", make_document(kvp("$in", IdHelper::matchAny(assignedDrives)))));
+    }
+
+    auto client = MongoService::instance().acquireClient();
+    auto applications = MongoService::instance().getCollection(client, "applications");
 
-        applications.update_one(
-            make_document(kvp("_id", bsoncxx::oid{id})),
+    try {
+        auto projection = make_document(kvp("status", 1), kvp("student_id", 1), kvp("company_id", 1));
+        mongocxx::options::find_one_and_update opts;
+        opts.projection(projection.view());
+        auto before = applications.find_one_and_update(
+            filter.view(),
             make_document(kvp("$set", make_document(
                 kvp("status", newStatus),
                 kvp("updated_at", bsoncxx::types::b_date{std::chrono::system_clock::now()})
-            )))
+            ))),
+            opts
         );
 
-        // Create notification for the student
-        auto companies = MongoService::instance().getCollection(client, "companies");
-        std::string companyName = "a company";
-        try {
-            auto companyOpt = companies.find_one(
-                make_document(kvp("_id", bsoncxx::oid{companyId}))
-            );
-            if (companyOpt) {
-                companyName = std::string(companyOpt->view()["company_name"].get_string().value);
+        if (!before) {
+            // Off the hot path: find out why nothing matched
+            mongocxx::options::find findOpts;
+            findOpts.projection(projection.view());
+            auto appOpt = applications.find_one(make_document(kvp("_id", appOid)), findOpts);
+            drogon::HttpStatusCode code = drogon::k404NotFound;
+            std::string message = "Application not found";
+            if (appOpt) {
+                std::string companyId = IdHelper::str(appOpt->view()["company_id"]);
+                std::string currentStatus = std::string(appOpt->view()["status"].get_string().value);
+                if (role == "recruiter" &&
+                    std::find(assignedDrives.begin(), assignedDrives.end(), companyId) == assignedDrives.end()) {
+                    code = drogon::k403Forbidden;
+                    message = "Access denied to this application";
+                } else if (!PlacementService::isValidStatusTransition(currentStatus, newStatus)) {
+                    code = drogon::k400BadRequest;
+                    message = "Invalid status transition from " + currentStatus + " to " + newStatus;
+                } else {
+                    // Lost a race; the status moved between the two reads
+                    code = drogon::k409Conflict;
+                    message = "Application status was changed concurrently, please retry";
+                }
             }
-        } catch (...) {}
-
-        std::string notifMsg = "Your application status for " + companyName + " has been updated to " + newStatus;
-        PlacementService::createNotification(studentId, notifMsg, "status_update");
-
-        // If selected, update student's placement_status
-        if (newStatus == "SELECTED") {
-            auto students = MongoService::instance().getCollection(client, "students");
-            students.update_one(
-                make_document(kvp("user_id", studentId)),
-                make_document(kvp("$set", make_document(kvp("placement_status", "SELECTED"))))
-            );
+            auto resp = JsonHelper::jsonResponse(JsonHelper::errorResponse(message));
+            resp->setStatusCode(code);
+            callback(resp);
+            return;
         }
 
+        std::string currentStatus = std::string(before->view()["status"].get_string().value);
+        std::string companyId = IdHelper::str(before->view()["company_id"]);
+        std::string studentId = IdHelper::str(before->view()["student_id"]);
+
+        // Counters, rollups, notification and placement_status off the request path.
+        // The filter only matched predecessors of the target, so this parses.
+        PlacementService::dispatchStatusChange(studentId, companyId,
+                                               *ApplicationStatus::parse(currentStatus), *target, true);
+
         Json::Value result;
         result["success"] = true;
         result["message"] = "Application status updated to " + newStatus;
-        callback(drogon::HttpResponse::newHttpJsonResponse(result));
+        result["previous_status"] = currentStatus;
+        callback(JsonHelper::jsonResponse(result));
 
     } catch (const std::exception& e) {
-        auto resp = drogon::HttpResponse::newHttpJsonResponse(
-            JsonHelper::errorResponse("Invalid application ID"));
+        auto resp = JsonHelper::jsonResponse(
+            JsonHelper::errorResponse(std::string("Failed to update status: ") + e.what()));
+        resp->setStatusCode(drogon::k500InternalServerError);
+        callback(resp);
+    }
+}
+
+void ApplicationController::bulkUpdateStatus(const drogon::HttpRequestPtr &req,
+                                              std::function<void(const drogon::HttpResponsePtr &)> &&callback) {
+    auto role = req->attributes()->get<std::string>("role");
+    if (role != "tpo" && role != "recruiter") {
+        auto resp = JsonHelper::jsonResponse(
+            JsonHelper::errorResponse("Only TPO or recruiter can update application status"));
+        resp->setStatusCode(drogon::k403Forbidden);
+        callback(resp);
+        return;
+    }
+
+    auto json = req->getJsonObject();
+    if (!json || !json->isMember("status") || !(*json)["ids"].isArray() || (*json)["ids"].empty()) {
+        auto resp = JsonHelper::jsonResponse(
+            JsonHelper::errorResponse("ids (non-empty array) and status are required"));
+        resp->setStatusCode(drogon::k400BadRequest);
+        callback(resp);
+        return;
+    }
+    if ((*json)["ids"].size() > kMaxBulkIds) {
+        auto resp = JsonHelper::jsonResponse(
+            JsonHelper::errorResponse("At most " + std::to_string(kMaxBulkIds) + " ids per request"));
+        resp->setStatusCode(drogon::k400BadRequest);
+        callback(resp);
+        return;
+    }
+
+    std::string newStatus = (*json)["status"].asString();
+    auto target = ApplicationStatus::parse(newStatus);
+    if (!target || ApplicationStatus::predecessors(*target) == 0) {
+        auto resp = JsonHelper::jsonResponse(
+            JsonHelper::errorResponse("Invalid status: " + newStatus));
         resp->setStatusCode(drogon::k400BadRequest);
         callback(resp);
+        return;
+    }
+
+    std::set<std::string> assignedDrives;
+    if (role == "recruiter") {
+        auto drives = req->attributes()->get<std::vector<std::string>>("assigned_drives");
+        assignedDrives.insert(drives.begin(), drives.end());
+    }
+
+    // Per-id outcome, in request order
+    std::vector<std::string> ids;
+    std::map<std::string, Json::Value> outcomes;
+    bsoncxx::builder::basic::array oids;
+    for (const auto& idVal : (*json)["ids"]) {
+        std::string id = idVal.asString();
+        if (outcomes.count(id)) continue;
+        ids.push_back(id);
+        try {
+            oids.append(bsoncxx::oid{id});
+            outcomes[id]["error"] = "Application not found";
+        } catch (const std::exception& e) {
+            outcomes[id]["error"] = "Invalid application ID";
+        }
+    }
+
+    struct Candidate {
+        std::string id;
+        std::string studentId;
+        std::string companyId;
+        AppStatus from = AppStatus::Applied;
+        std::string fromName;
+    };
+    std::vector<Candidate> candidates;
+
+    auto client = MongoService::instance().acquireClient();
+    auto applications = MongoService::instance().getCollection(client, "applications");
+    auto notifications = MongoService::instance().getCollection(client, "notifications");
+
+    try {
+        mongocxx::options::find findOpts;
+        findOpts.projection(make_document(kvp("status", 1), kvp("student_id", 1), kvp("company_id", 1)));
+        auto cursor = applications.find(
+            make_document(kvp("_id", make_document(kvp("$in", oids)))), findOpts);
+
+        for (auto& doc : cursor) {
+            Candidate c;
+            c.id = doc["_id"].get_oid().value.to_string();
+            c.studentId = IdHelper::str(doc["student_id"]);
+            c.companyId = IdHelper::str(doc["company_id"]);
+            c.fromName = std::string(doc["status"].get_string().value);
+            auto current = ApplicationStatus::parse(c.fromName);
+
+            auto& outcome = outcomes[c.id];
+            outcome["previous_status"] = c.fromName;
+            if (role == "recruiter" && !assignedDrives.count(c.companyId)) {
+                outcome["error"] = "Access denied to this application";
+            } else if (!current || !ApplicationStatus::canTransition(*current, *target)) {
+                outcome["error"] = "Invalid status transition from " + c.fromName + " to " + newStatus;
+            } else {
+                c.from = *current;
+                outcome["error"] = "Application status was changed concurrently, please retry";
+                candidates.push_back(std::move(c));
+            }
+        }
+
+        // One optimistic update per candidate, conditional on the status just read.
+        // status_op marks which of them this request applied; a timestamp would
+        // not, since two requests can run in the same millisecond.
+        auto now = bsoncxx::types::b_date{std::chrono::system_clock::now()};
+        bsoncxx::oid op;
+        std::vector<Candidate> applied;
+        if (!candidates.empty()) {
+            std::vector<mongocxx::model::write> writes;
+            writes.reserve(candidates.size());
+            for (const auto& c : candidates) {
+                writes.emplace_back(mongocxx::model::update_one{
+                    make_document(kvp("_id", bsoncxx::oid{c.id}), kvp("status", c.fromName)),
+                    make_document(kvp("$set", make_document(
+                        kvp("status", newStatus), kvp("updated_at", now), kvp("status_op", op))))
+                });
+            }
+            mongocxx::options::bulk_write bulkOpts;
+            bulkOpts.ordered(false);
+            auto bulk = applications.bulk_write(writes, bulkOpts);
+
+            if (bulk && bulk->modified_count() == static_cast<int32_t>(candidates.size())) {
+                applied = candidates;
+            } else {
+                std::map<std::string, const Candidate*> byId;
+                bsoncxx::builder::basic::array candidateOids;
+                for (const auto& c : candidates) {
+                    byId[c.id] = &c;
+                    candidateOids.append(bsoncxx::oid{c.id});
+                }
+                mongocxx::options::find idOnly;
+                idOnly.projection(make_document(kvp("_id", 1)));
+                for (auto& doc : applications.find(make_document(
+                         kvp("_id", make_document(kvp("$in", candidateOids))),
+                         kvp("status_op", op)), idOnly)) {
+                    applied.push_back(*byId[doc["_id"].get_oid().value.to_string()]);
+                }
+            }
+        }
+
+        if (!applied.empty()) {
+            std::vector<bsoncxx::document::value> notifs;
+            notifs.reserve(applied.size());
+            for (const auto& c : applied) {
+                outcomes[c.id].removeMember("error");
+                notifs.push_back(make_document(
+                    kvp("user_id", IdHelper::ref(c.studentId).view()),
+                    kvp("message", "Your application status for " + DriveCatalog::instance().companyName(c.companyId) +
+                                   " has been updated to " + newStatus),
+                    kvp("type", "status_update"),
+                    kvp("read", false),
+                    kvp("created_at", now)
+                ));
+                PlacementService::dispatchStatusChange(c.studentId, c.companyId, c.from, *target, false);
+            }
+            mongocxx::options::insert insertOpts;
+            insertOpts.ordered(false);
+            try {
+                notifications.insert_many(notifs, insertOpts);
+            } catch (const std::exception& e) {
+                // Statuses are already committed; a missed notification is not worth failing the batch
+                std::cerr << "Warning: Bulk status notifications: " << e.what() << std::endl;
+            }
+        }
+    } catch (const std::exception& e) {
+        auto resp = JsonHelper::jsonResponse(
+            JsonHelper::errorResponse(std::string("Failed to update statuses: ") + e.what()));
+        resp->setStatusCode(drogon::k500InternalServerError);
+        callback(resp);
+        return;
     }
+
+    Json::Value results(Json::arrayValue);
+    int updated = 0;
+    for (const auto& id : ids) {
+        Json::Value item = outcomes[id];
+        item["id"] = id;
+        item["success"] = !item.isMember("error");
+        if (item["success"].asBool()) ++updated;
+        results.append(item);
+    }
+
+    Json::Value result;
+    result["success"] = true;
+    result["status"] = newStatus;
+    result["updated"] = updated;
+    result["failed"] = static_cast<int>(ids.size()) - updated;
+    result["results"] = results;
+    callback(JsonHelper::jsonResponse(result));
 }
@@ -6,9 +6,12 @@ class ApplicationController : public drogon::HttpController<ApplicationControlle
 public:
     METHOD_LIST_BEGIN
     ADD_METHOD_TO(ApplicationController::updateStatus, "/api/applications/{id}/status", drogon::Put, "AuthFilter");
+    ADD_METHOD_TO(ApplicationController::bulkUpdateStatus, "/api/applications/status", drogon::Put, "AuthFilter");
     METHOD_LIST_END
 
     void updateStatus(const drogon::HttpRequestPtr &req,
                       std::function<void(const drogon::HttpResponsePtr &)> &&callback,
                       const std::string &id);
+    void bulkUpdateStatus(const drogon::HttpRequestPtr &req,
+                          std::function<void(const drogon::HttpResponsePtr &)> &&callback);
 };
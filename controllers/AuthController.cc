@@ -6,7 +6,7 @@ void AuthController::registerUser(const drogon::HttpRequestPtr &req,
                                    std::function<void(const drogon::HttpResponsePtr &)> &&callback) {
     auto json = req->getJsonObject();
     if (!json) {
-        auto resp = drogon::HttpResponse::newHttpJsonResponse(
+        auto resp = JsonHelper::jsonResponse(
             JsonHelper::errorResponse("Invalid JSON body"));
         resp->setStatusCode(drogon::k400BadRequest);
         callback(resp);
@@ -14,7 +14,7 @@ void AuthController::registerUser(const drogon::HttpRequestPtr &req,
     }
 
     auto result = AuthService::registerUser(*json);
-    auto resp = drogon::HttpResponse::newHttpJsonResponse(result);
+    auto resp = JsonHelper::jsonResponse(result);
     if (!result["success"].asBool()) {
         resp->setStatusCode(drogon::k400BadRequest);
     } else {
@@ -28,7 +28,7 @@ void AuthController::loginUser(const drogon::HttpRequestPtr &req,
                                 std::function<void(const drogon::HttpResponsePtr &)> &&callback) {
     auto json = req->getJsonObject();
     if (!json) {
-        auto resp = drogon::HttpResponse::newHttpJsonResponse(
+        auto resp = JsonHelper::jsonResponse(
             JsonHelper::errorResponse("Invalid JSON body"));
         resp->setStatusCode(drogon::k400BadRequest);
         callback(resp);
@@ -36,7 +36,7 @@ void AuthController::loginUser(const drogon::HttpRequestPtr &req,
     }
 
     auto result = AuthService::loginUser(*json);
-    auto resp = drogon::HttpResponse::newHttpJsonResponse(result);
+    auto resp = JsonHelper::jsonResponse(result);
     if (!result["success"].asBool()) {
         // Use 403 for status-based rejections, 401 for invalid credentials
         if (result.isMember("status")) {
@@ -52,7 +52,7 @@ void AuthController::getMe(const drogon::HttpRequestPtr &req,
                              std::function<void(const drogon::HttpResponsePtr &)> &&callback) {
     auto userId = req->attributes()->get<std::string>("user_id");
     auto result = AuthService::getUserById(userId);
-    auto resp = drogon::HttpResponse::newHttpJsonResponse(result);
+    auto resp = JsonHelper::jsonResponse(result);
     if (!result["success"].asBool()) {
         resp->setStatusCode(drogon::k404NotFound);
     }
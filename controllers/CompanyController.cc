@@ -1,14 +1,26 @@
 #include "CompanyController.h"
+#include "IdHelper.h"
 #include "MongoService.h"
 #include "EligibilityService.h"
 #include "BcryptHelper.h"
 #include "PlacementService.h"
+#include "DrivePublishService.h"
+#include "SearchService.h"
+#include "StatsService.h"
+#include "DriveCatalog.h"
 #include "JsonHelper.h"
+#include "ResumeStore.h"
+#include "ZipStream.h"
 #include <bsoncxx/builder/basic/document.hpp>
 #include <bsoncxx/builder/basic/kvp.hpp>
 #include <bsoncxx/builder/basic/array.hpp>
 #include <bsoncxx/oid.hpp>
+#include <algorithm>
+#include <cctype>
 #include <chrono>
+#include <filesystem>
+#include <memory>
+#include <set>
 
 using bsoncxx::builder::basic::kvp;
 using bsoncxx::builder::basic::make_document;
@@ -18,7 +30,7 @@ void CompanyController::createCompany(const drogon::HttpRequestPtr &req,
                                        std::function<void(const drogon::HttpResponsePtr &)> &&callback) {
     auto json = req->getJsonObject();
     if (!json) {
-        auto resp = drogon::HttpResponse::newHttpJsonResponse(
+        auto resp = JsonHelper::jsonResponse(
             JsonHelper::errorResponse("Invalid JSON body"));
         resp->setStatusCode(drogon::k400BadRequest);
         callback(resp);
@@ -34,7 +46,7 @@ void CompanyController::createCompany(const drogon::HttpRequestPtr &req,
     std::string driveDate = json->get("drive_date", "").asString();
 
     if (companyName.empty() || role.empty()) {
-        auto resp = drogon::HttpResponse::newHttpJsonResponse(
+        auto resp = JsonHelper::jsonResponse(
             JsonHelper::errorResponse("company_name and role are required"));
         resp->setStatusCode(drogon::k400BadRequest);
         callback(resp);
@@ -69,13 +81,13 @@ void CompanyController::createCompany(const drogon::HttpRequestPtr &req,
     docBuilder.append(kvp("allowed_backlogs", allowedBacklogs));
     docBuilder.append(kvp("required_skills", skillsArr));
     docBuilder.append(kvp("drive_date", driveDate));
-    docBuilder.append(kvp("created_by", tpoId));
+    docBuilder.append(kvp("created_by", IdHelper::ref(tpoId).view()));
     docBuilder.append(kvp("created_at", now));
 
     // Will set recruiter_id after potential creation
     auto companyResult = companies.insert_one(docBuilder.extract());
     if (!companyResult) {
-        auto resp = drogon::HttpResponse::newHttpJsonResponse(
+        auto resp = JsonHelper::jsonResponse(
             JsonHelper::errorResponse("Failed to create company drive"));
         resp->setStatusCode(drogon::k500InternalServerError);
         callback(resp);
@@ -94,7 +106,7 @@ void CompanyController::createCompany(const drogon::HttpRequestPtr &req,
         try {
             users.update_one(
                 make_document(kvp("_id", bsoncxx::oid{existingRecruiterId})),
-                make_document(kvp("$push", make_document(kvp("assigned_drives", companyId))))
+                make_document(kvp("$push", make_document(kvp("assigned_drives", IdHelper::ref(companyId).view()))))
             );
             recruiterId = existingRecruiterId;
         } catch (...) {}
@@ -107,16 +119,13 @@ void CompanyController::createCompany(const drogon::HttpRequestPtr &req,
         } else {
             std::string hashedPassword = BcryptHelper::hashPassword(recruiterPassword);
 
-            bsoncxx::builder::basic::array drivesArr;
-            drivesArr.append(companyId);
-
             auto recruiterDoc = make_document(
                 kvp("name", recruiterName),
                 kvp("email", recruiterEmail),
                 kvp("password", hashedPassword),
                 kvp("role", "recruiter"),
                 kvp("status", "active"),
-                kvp("assigned_drives", drivesArr),
+                kvp("assigned_drives", IdHelper::refArray({companyId})),
                 kvp("created_at", now)
             );
 
@@ -135,11 +144,26 @@ void CompanyController::createCompany(const drogon::HttpRequestPtr &req,
     if (!recruiterId.empty()) {
         companies.update_one(
             make_document(kvp("_id", bsoncxx::oid{companyId})),
-            make_document(kvp("$set", make_document(kvp("recruiter_id", recruiterId))))
+            make_document(kvp("$set", make_document(kvp("recruiter_id", IdHelper::ref(recruiterId).view()))))
         );
     }
 
-    callback(drogon::HttpResponse::newHttpJsonResponse(res));
+    SearchService::instance().indexDrive(companyId, companyName, role, driveDate);
+    DriveCatalog::instance().put({companyId, companyName, role, driveDate, minGpa, allowedBacklogs});
+    StatsService::instance().onDriveCreated(companyId);
+
+    // Notify eligible students in the background
+    DrivePublishService::Drive drive;
+    drive.id = companyId;
+    drive.companyName = companyName;
+    drive.role = role;
+    drive.driveDate = driveDate;
+    drive.minGpa = minGpa;
+    drive.allowedBacklogs = allowedBacklogs;
+    DrivePublishService::instance().publish(drive);
+    res["publish"]["state"] = "queued";
+
+    callback(JsonHelper::jsonResponse(res));
 }
 
 void CompanyController::getAllCompanies(const drogon::HttpRequestPtr &req,
@@ -162,11 +186,8 @@ void CompanyController::getAllCompanies(const drogon::HttpRequestPtr &req,
                 bsoncxx::builder::basic::array driveOids;
                 auto arr = userOpt->view()["assigned_drives"].get_array().value;
                 for (auto& driveId : arr) {
-                    if (driveId.type() == bsoncxx::type::k_string) {
-                        try {
-                            driveOids.append(bsoncxx::oid{std::string(driveId.get_string().value)});
-                        } catch (...) {}
-                    }
+                    std::string hex = IdHelper::str(driveId);
+                    if (IdHelper::isHexOid(hex)) driveOids.append(bsoncxx::oid{hex});
                 }
                 return companies.find(
                     make_document(kvp("_id", make_document(kvp("$in", driveOids))))
@@ -193,7 +214,7 @@ void CompanyController::getAllCompanies(const drogon::HttpRequestPtr &req,
     Json::Value result;
     result["success"] = true;
     result["companies"] = companiesList;
-    callback(drogon::HttpResponse::newHttpJsonResponse(result));
+    callback(JsonHelper::jsonResponse(result));
 }
 
 void CompanyController::getCompany(const drogon::HttpRequestPtr &req,
@@ -210,7 +231,7 @@ void CompanyController::getCompany(const drogon::HttpRequestPtr &req,
         );
 
         if (!companyOpt) {
-            auto resp = drogon::HttpResponse::newHttpJsonResponse(
+            auto resp = JsonHelper::jsonResponse(
                 JsonHelper::errorResponse("Company not found"));
             resp->setStatusCode(drogon::k404NotFound);
             callback(resp);
@@ -227,15 +248,14 @@ void CompanyController::getCompany(const drogon::HttpRequestPtr &req,
             if (userOpt && userOpt->view().find("assigned_drives") != userOpt->view().end()) {
                 auto arr = userOpt->view()["assigned_drives"].get_array().value;
                 for (auto& driveId : arr) {
-                    if (driveId.type() == bsoncxx::type::k_string &&
-                        std::string(driveId.get_string().value) == id) {
+                    if (IdHelper::str(driveId) == id) {
                         hasAccess = true;
                         break;
                     }
                 }
             }
             if (!hasAccess) {
-                auto resp = drogon::HttpResponse::newHttpJsonResponse(
+                auto resp = JsonHelper::jsonResponse(
                     JsonHelper::errorResponse("Access denied to this drive"));
                 resp->setStatusCode(drogon::k403Forbidden);
                 callback(resp);
@@ -247,9 +267,9 @@ void CompanyController::getCompany(const drogon::HttpRequestPtr &req,
         result["success"] = true;
         result["company"] = JsonHelper::bsonToJson(companyOpt->view());
         result["company"]["id"] = id;
-        callback(drogon::HttpResponse::newHttpJsonResponse(result));
+        callback(JsonHelper::jsonResponse(result));
     } catch (const std::exception& e) {
-        auto resp = drogon::HttpResponse::newHttpJsonResponse(
+        auto resp = JsonHelper::jsonResponse(
             JsonHelper::errorResponse("Invalid company ID"));
         resp->setStatusCode(drogon::k400BadRequest);
         callback(resp);
@@ -261,7 +281,7 @@ void CompanyController::updateCompany(const drogon::HttpRequestPtr &req,
                                        const std::string &id) {
     auto json = req->getJsonObject();
     if (!json) {
-        auto resp = drogon::HttpResponse::newHttpJsonResponse(
+        auto resp = JsonHelper::jsonResponse(
             JsonHelper::errorResponse("Invalid JSON body"));
         resp->setStatusCode(drogon::k400BadRequest);
         callback(resp);
@@ -292,18 +312,22 @@ void CompanyController::updateCompany(const drogon::HttpRequestPtr &req,
         );
 
         if (result && result->matched_count() > 0) {
+            SearchService::instance().updateDrive(id, *json);
+            DriveCatalog::instance().update(id, *json);
+            DriveCatalog::instance().propagate(id, *json);
+
             Json::Value res;
             res["success"] = true;
             res["message"] = "Company drive updated successfully";
-            callback(drogon::HttpResponse::newHttpJsonResponse(res));
+            callback(JsonHelper::jsonResponse(res));
         } else {
-            auto resp = drogon::HttpResponse::newHttpJsonResponse(
+            auto resp = JsonHelper::jsonResponse(
                 JsonHelper::errorResponse("Company not found"));
             resp->setStatusCode(drogon::k404NotFound);
             callback(resp);
         }
     } catch (const std::exception& e) {
-        auto resp = drogon::HttpResponse::newHttpJsonResponse(
+        auto resp = JsonHelper::jsonResponse(
             JsonHelper::errorResponse("Invalid company ID"));
         resp->setStatusCode(drogon::k400BadRequest);
         callback(resp);
@@ -321,18 +345,22 @@ void CompanyController::deleteCompany(const drogon::HttpRequestPtr &req,
         );
 
         if (result && result->deleted_count() > 0) {
+            SearchService::instance().removeDrive(id);
+            DriveCatalog::instance().remove(id);
+            StatsService::instance().onDriveDeleted(id);
+
             Json::Value res;
             res["success"] = true;
             res["message"] = "Company drive deleted successfully";
-            callback(drogon::HttpResponse::newHttpJsonResponse(res));
+            callback(JsonHelper::jsonResponse(res));
         } else {
-            auto resp = drogon::HttpResponse::newHttpJsonResponse(
+            auto resp = JsonHelper::jsonResponse(
                 JsonHelper::errorResponse("Company not found"));
             resp->setStatusCode(drogon::k404NotFound);
             callback(resp);
         }
     } catch (const std::exception& e) {
-        auto resp = drogon::HttpResponse::newHttpJsonResponse(
+        auto resp = JsonHelper::jsonResponse(
             JsonHelper::errorResponse("Invalid company ID"));
         resp->setStatusCode(drogon::k400BadRequest);
         callback(resp);
@@ -356,15 +384,14 @@ void CompanyController::getEligibleStudents(const drogon::HttpRequestPtr &req,
         if (userOpt && userOpt->view().find("assigned_drives") != userOpt->view().end()) {
             auto arr = userOpt->view()["assigned_drives"].get_array().value;
             for (auto& driveId : arr) {
-                if (driveId.type() == bsoncxx::type::k_string &&
-                    std::string(driveId.get_string().value) == id) {
+                if (IdHelper::str(driveId) == id) {
                     hasAccess = true;
                     break;
                 }
             }
         }
         if (!hasAccess) {
-            auto resp = drogon::HttpResponse::newHttpJsonResponse(
+            auto resp = JsonHelper::jsonResponse(
                 JsonHelper::errorResponse("Access denied to this drive"));
             resp->setStatusCode(drogon::k403Forbidden);
             callback(resp);
@@ -373,7 +400,7 @@ void CompanyController::getEligibleStudents(const drogon::HttpRequestPtr &req,
     }
 
     auto result = EligibilityService::getEligibleStudents(id);
-    auto resp = drogon::HttpResponse::newHttpJsonResponse(result);
+    auto resp = JsonHelper::jsonResponse(result);
     if (!result["success"].asBool()) {
         resp->setStatusCode(drogon::k404NotFound);
     }
@@ -397,15 +424,14 @@ void CompanyController::getDriveApplications(const drogon::HttpRequestPtr &req,
         if (userOpt && userOpt->view().find("assigned_drives") != userOpt->view().end()) {
             auto arr = userOpt->view()["assigned_drives"].get_array().value;
             for (auto& driveId : arr) {
-                if (driveId.type() == bsoncxx::type::k_string &&
-                    std::string(driveId.get_string().value) == id) {
+                if (IdHelper::str(driveId) == id) {
                     hasAccess = true;
                     break;
                 }
             }
         }
         if (!hasAccess) {
-            auto resp = drogon::HttpResponse::newHttpJsonResponse(
+            auto resp = JsonHelper::jsonResponse(
                 JsonHelper::errorResponse("Access denied to this drive"));
             resp->setStatusCode(drogon::k403Forbidden);
             callback(resp);
@@ -417,7 +443,7 @@ void CompanyController::getDriveApplications(const drogon::HttpRequestPtr &req,
     auto applications = MongoService::instance().getCollection(client, "applications");
     auto students = MongoService::instance().getCollection(client, "students");
 
-    auto cursor = applications.find(make_document(kvp("company_id", id)));
+    auto cursor = applications.find(make_document(kvp("company_id", IdHelper::match(id).view())));
 
     Json::Value apps(Json::arrayValue);
     for (auto& doc : cursor) {
@@ -427,10 +453,12 @@ void CompanyController::getDriveApplications(const drogon::HttpRequestPtr &req,
         }
 
         // Attach student info
-        std::string studentId = std::string(doc["student_id"].get_string().value);
-        auto studentOpt = students.find_one(make_document(kvp("user_id", studentId)));
+        std::string studentId = IdHelper::str(doc["student_id"]);
+        auto studentOpt = students.find_one(make_document(kvp("user_id", IdHelper::match(studentId).view())));
         if (studentOpt) {
             app["student"] = JsonHelper::bsonToJson(studentOpt->view());
+            // Students reach this route too; they get no links to other resumes
+            if (role != "student") ResumeStore::signResumeUrl(app["student"]);
         }
 
         apps.append(app);
@@ -439,5 +467,141 @@ void CompanyController::getDriveApplications(const drogon::HttpRequestPtr &req,
     Json::Value result;
     result["success"] = true;
     result["applications"] = apps;
-    callback(drogon::HttpResponse::newHttpJsonResponse(result));
+    callback(JsonHelper::jsonResponse(result));
+}
+
+namespace {
+
+// Entry names come from roll numbers, which are free text
+std::string zipEntryName(const std::string& base) {
+    std::string name;
+    for (char c : base) {
+        bool safe = std::isalnum(static_cast<unsigned char>(c)) || c == '-' || c == '_' || c == '.';
+        name += safe ? c : '_';
+    }
+    return name.empty() ? "student" : name;
+}
+
+} // anonymous namespace
+
+void CompanyController::getDriveResumes(const drogon::HttpRequestPtr &req,
+                                         std::function<void(const drogon::HttpResponsePtr &)> &&callback,
+                                         const std::string &id) {
+    auto role = req->attributes()->get<std::string>("role");
+
+    // Same scoping as getDriveApplications; students never get other resumes
+    bool allowed = role == "tpo";
+    if (role == "recruiter") {
+        auto drives = req->attributes()->get<std::vector<std::string>>("assigned_drives");
+        allowed = std::find(drives.begin(), drives.end(), id) != drives.end();
+    }
+    if (!allowed) {
+        auto resp = JsonHelper::jsonResponse(
+            JsonHelper::errorResponse("Access denied to this drive"));
+        resp->setStatusCode(drogon::k403Forbidden);
+        callback(resp);
+        return;
+    }
+
+    auto drive = DriveCatalog::instance().find(id);
+    if (!drive) {
+        auto resp = JsonHelper::jsonResponse(
+            JsonHelper::errorResponse("Company not found"));
+        resp->setStatusCode(drogon::k404NotFound);
+        callback(resp);
+        return;
+    }
+
+    auto client = MongoService::instance().acquireClient();
+    auto applications = MongoService::instance().getCollection(client, "applications");
+    auto students = MongoService::instance().getCollection(client, "students");
+
+    std::vector<std::string> studentIds;
+    mongocxx::options::find appOpts;
+    appOpts.projection(make_document(kvp("student_id", 1)));
+    for (auto& doc : applications.find(make_document(kvp("company_id", IdHelper::match(id).view())), appOpts)) {
+        std::string studentId = IdHelper::str(doc["student_id"]);
+        if (!studentId.empty()) studentIds.push_back(studentId);
+    }
+
+    // Only names and paths are collected here; file contents are read while streaming
+    std::vector<ZipStream::Entry> entries;
+    std::vector<std::string> missing;
+    std::set<std::string> usedNames;
+    uint64_t archiveSize = 0;
+    if (!studentIds.empty()) {
+        mongocxx::options::find studentOpts;
+        studentOpts.projection(make_document(
+            kvp("user_id", 1), kvp("roll_number", 1), kvp("name", 1), kvp("resume_hash", 1)));
+        auto cursor = students.find(make_document(
+            kvp("user_id", make_document(kvp("$in", IdHelper::matchAny(studentIds))))), studentOpts);
+        for (auto& doc : cursor) {
+            std::string userId = IdHelper::str(doc["user_id"]);
+            std::string roll = doc["roll_number"] && doc["roll_number"].type() == bsoncxx::type::k_string
+                ? std::string(doc["roll_number"].get_string().value) : userId;
+            std::string label = roll;
+            if (doc["name"] && doc["name"].type() == bsoncxx::type::k_string) {
+                label += " (" + std::string(doc["name"].get_string().value) + ")";
+            }
+
+            std::string path = doc["resume_hash"] && doc["resume_hash"].type() == bsoncxx::type::k_string
+                ? ResumeStore::blobPath(std::string(doc["resume_hash"].get_string().value))
+                : ResumeStore::uploadDir() + "/resume_" + userId + ".pdf";
+            std::error_code ec;
+            uint64_t size = std::filesystem::file_size(path, ec);
+            if (ec) {
+                missing.push_back(label + ": no resume uploaded");
+                continue;
+            }
+
+            std::string base = zipEntryName(roll);
+            std::string name = base + ".pdf";
+            for (int n = 2; usedNames.count(name); ++n) name = base + "-" + std::to_string(n) + ".pdf";
+
+            // Stay clear of the 4 GiB limit of a non-ZIP64 archive
+            uint64_t entrySize = ZipStream::kEntryOverhead + 2 * name.size() + size;
+            if (archiveSize + entrySize > ZipStream::kMaxArchiveSize - (1 << 20)) {
+                missing.push_back(label + ": left out, archive size limit reached");
+                continue;
+            }
+            archiveSize += entrySize;
+            usedNames.insert(name);
+            entries.push_back({name, path, ""});
+        }
+    }
+
+    if (!missing.empty()) {
+        std::string note;
+        for (const auto& line : missing) note += line + "\n";
+        entries.push_back({"MISSING.txt", "", note});
+    }
+
+    // Pulled by the event loop as the socket drains, so memory stays at one buffer
+    auto zip = std::make_shared<ZipStream>(std::move(entries));
+    auto resp = drogon::HttpResponse::newStreamResponse(
+        [zip](char *buffer, std::size_t length) -> std::size_t {
+            if (!buffer) return 0;  // client went away
+            return zip->read(buffer, length);
+        },
+        zipEntryName(drive->companyName + "-" + drive->role) + "-resumes.zip",
+        drogon::CT_APPLICATION_ZIP);
+    callback(resp);
+}
+
+void CompanyController::getPublishStatus(const drogon::HttpRequestPtr &req,
+                                          std::function<void(const drogon::HttpResponsePtr &)> &&callback,
+                                          const std::string &id) {
+    try {
+        auto result = DrivePublishService::instance().getProgress(id);
+        auto resp = JsonHelper::jsonResponse(result);
+        if (!result["success"].asBool()) {
+            resp->setStatusCode(drogon::k404NotFound);
+        }
+        callback(resp);
+    } catch (const std::exception& e) {
+        auto resp = JsonHelper::jsonResponse(
+            JsonHelper::errorResponse("Invalid company ID"));
+        resp->setStatusCode(drogon::k400BadRequest);
+        callback(resp);
+    }
 }
@@ -12,6 +12,8 @@ public:
     ADD_METHOD_TO(CompanyController::deleteCompany, "/api/companies/{id}", drogon::Delete, "AuthFilter", "TpoFilter");
     ADD_METHOD_TO(CompanyController::getEligibleStudents, "/api/companies/{id}/eligible-students", drogon::Get, "AuthFilter");
     ADD_METHOD_TO(CompanyController::getDriveApplications, "/api/companies/{id}/applications", drogon::Get, "AuthFilter");
+    ADD_METHOD_TO(CompanyController::getDriveResumes, "/api/companies/{id}/resumes.zip", drogon::Get, "AuthFilter");
+    ADD_METHOD_TO(CompanyController::getPublishStatus, "/api/companies/{id}/publish-status", drogon::Get, "AuthFilter", "TpoFilter");
     METHOD_LIST_END
 
     void createCompany(const drogon::HttpRequestPtr &req,
@@ -33,4 +35,11 @@ public:
     void getDriveApplications(const drogon::HttpRequestPtr &req,
                               std::function<void(const drogon::HttpResponsePtr &)> &&callback,
                               const std::string &id);
+    // Every applicant's resume as one ZIP, streamed as it is built
+    void getDriveResumes(const drogon::HttpRequestPtr &req,
+                         std::function<void(const drogon::HttpResponsePtr &)> &&callback,
+                         const std::string &id);
+    void getPublishStatus(const drogon::HttpRequestPtr &req,
+                          std::function<void(const drogon::HttpResponsePtr &)> &&callback,
+                          const std::string &id);
 };
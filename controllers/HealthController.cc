@@ -0,0 +1,22 @@
+#include "HealthController.h"
+#include "StartupService.h"
+
+void HealthController::liveness(const drogon::HttpRequestPtr &req,
+                                std::function<void(const drogon::HttpResponsePtr &)> &&callback) {
+    Json::Value result;
+    result["status"] = "ok";
+    auto resp = drogon::HttpResponse::newHttpJsonResponse(result);
+    resp->addHeader("Cache-Control", "no-store");
+    callback(resp);
+}
+
+void HealthController::readiness(const drogon::HttpRequestPtr &req,
+                                 std::function<void(const drogon::HttpResponsePtr &)> &&callback) {
+    auto status = StartupService::instance().status();
+    auto resp = drogon::HttpResponse::newHttpJsonResponse(status);
+    if (!status["ready"].asBool()) {
+        resp->setStatusCode(drogon::k503ServiceUnavailable);
+    }
+    resp->addHeader("Cache-Control", "no-store");
+    callback(resp);
+}
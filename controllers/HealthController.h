@@ -0,0 +1,19 @@
+#pragma once
+
+#include <drogon/HttpController.h>
+
+// Probes for the load balancer; no auth, no database round trip
+class HealthController : public drogon::HttpController<HealthController> {
+public:
+    METHOD_LIST_BEGIN
+    ADD_METHOD_TO(HealthController::liveness, "/healthz", drogon::Get);
+    ADD_METHOD_TO(HealthController::readiness, "/readyz", drogon::Get);
+    METHOD_LIST_END
+
+    // The process is up and its event loop answers
+    void liveness(const drogon::HttpRequestPtr &req,
+                  std::function<void(const drogon::HttpResponsePtr &)> &&callback);
+    // 503 until startup has warmed the pool and every readiness step is done
+    void readiness(const drogon::HttpRequestPtr &req,
+                   std::function<void(const drogon::HttpResponsePtr &)> &&callback);
+};
@@ -1,4 +1,6 @@
 #include "InterviewController.h"
+#include "DriveCatalog.h"
+#include "IdHelper.h"
 #include "MongoService.h"
 #include "PlacementService.h"
 #include "JsonHelper.h"
@@ -18,7 +20,7 @@ void InterviewController::scheduleInterview(const drogon::HttpRequestPtr &req,
 
     // Only TPO and recruiter can schedule interviews
     if (role != "tpo" && role != "recruiter") {
-        auto resp = drogon::HttpResponse::newHttpJsonResponse(
+        auto resp = JsonHelper::jsonResponse(
             JsonHelper::errorResponse("Only TPO or recruiter can schedule interviews"));
         resp->setStatusCode(drogon::k403Forbidden);
         callback(resp);
@@ -27,7 +29,7 @@ void InterviewController::scheduleInterview(const drogon::HttpRequestPtr &req,
 
     auto json = req->getJsonObject();
     if (!json) {
-        auto resp = drogon::HttpResponse::newHttpJsonResponse(
+        auto resp = JsonHelper::jsonResponse(
             JsonHelper::errorResponse("Invalid JSON body"));
         resp->setStatusCode(drogon::k400BadRequest);
         callback(resp);
@@ -41,7 +43,7 @@ void InterviewController::scheduleInterview(const drogon::HttpRequestPtr &req,
     std::string mode = json->get("mode", "online").asString();
 
     if (studentId.empty() || companyId.empty() || interviewDate.empty()) {
-        auto resp = drogon::HttpResponse::newHttpJsonResponse(
+        auto resp = JsonHelper::jsonResponse(
             JsonHelper::errorResponse("student_id, company_id, and interview_date are required"));
         resp->setStatusCode(drogon::k400BadRequest);
         callback(resp);
@@ -59,15 +61,14 @@ void InterviewController::scheduleInterview(const drogon::HttpRequestPtr &req,
         if (userOpt && userOpt->view().find("assigned_drives") != userOpt->view().end()) {
             auto arr = userOpt->view()["assigned_drives"].get_array().value;
             for (auto& driveId : arr) {
-                if (driveId.type() == bsoncxx::type::k_string &&
-                    std::string(driveId.get_string().value) == companyId) {
+                if (IdHelper::str(driveId) == companyId) {
                     hasAccess = true;
                     break;
                 }
             }
         }
         if (!hasAccess) {
-            auto resp = drogon::HttpResponse::newHttpJsonResponse(
+            auto resp = JsonHelper::jsonResponse(
                 JsonHelper::errorResponse("Access denied to this drive"));
             resp->setStatusCode(drogon::k403Forbidden);
             callback(resp);
@@ -75,13 +76,25 @@ void InterviewController::scheduleInterview(const drogon::HttpRequestPtr &req,
         }
     }
 
+    auto drive = DriveCatalog::instance().find(companyId);
+    if (!drive) {
+        auto resp = JsonHelper::jsonResponse(
+            JsonHelper::errorResponse("Company drive not found"));
+        resp->setStatusCode(drogon::k404NotFound);
+        callback(resp);
+        return;
+    }
+
     auto client = MongoService::instance().acquireClient();
     auto interviews = MongoService::instance().getCollection(client, "interviews");
     auto now = bsoncxx::types::b_date{std::chrono::system_clock::now()};
 
     auto doc = make_document(
-        kvp("student_id", studentId),
-        kvp("company_id", companyId),
+        kvp("student_id", IdHelper::ref(studentId).view()),
+        kvp("company_id", IdHelper::ref(companyId).view()),
+        kvp("company_name", drive->companyName),
+        kvp("role", drive->role),
+        kvp("drive_date", drive->driveDate),
         kvp("interview_date", interviewDate),
         kvp("interview_time", interviewTime),
         kvp("mode", mode),
@@ -91,19 +104,8 @@ void InterviewController::scheduleInterview(const drogon::HttpRequestPtr &req,
     auto result = interviews.insert_one(doc.view());
 
     // Notify student
-    auto companies = MongoService::instance().getCollection(client, "companies");
-    std::string companyName = "a company";
-    try {
-        auto companyOpt = companies.find_one(
-            make_document(kvp("_id", bsoncxx::oid{companyId}))
-        );
-        if (companyOpt) {
-            companyName = std::string(companyOpt->view()["company_name"].get_string().value);
-        }
-    } catch (...) {}
-
     PlacementService::createNotification(studentId,
-        "Interview scheduled with " + companyName + " on " + interviewDate + " (" + mode + ")",
+        "Interview scheduled with " + drive->companyName + " on " + interviewDate + " (" + mode + ")",
         "interview");
 
     Json::Value res;
@@ -112,7 +114,7 @@ void InterviewController::scheduleInterview(const drogon::HttpRequestPtr &req,
     if (result) {
         res["id"] = result->inserted_id().get_oid().value.to_string();
     }
-    callback(drogon::HttpResponse::newHttpJsonResponse(res));
+    callback(JsonHelper::jsonResponse(res));
 }
 
 void InterviewController::getAllInterviews(const drogon::HttpRequestPtr &req,
@@ -122,7 +124,7 @@ void InterviewController::getAllInterviews(const drogon::HttpRequestPtr &req,
 
     // Only TPO and recruiter can view all interviews
     if (role != "tpo" && role != "recruiter") {
-        auto resp = drogon::HttpResponse::newHttpJsonResponse(
+        auto resp = JsonHelper::jsonResponse(
             JsonHelper::errorResponse("Access denied"));
         resp->setStatusCode(drogon::k403Forbidden);
         callback(resp);
@@ -131,7 +133,6 @@ void InterviewController::getAllInterviews(const drogon::HttpRequestPtr &req,
 
     auto client = MongoService::instance().acquireClient();
     auto interviews = MongoService::instance().getCollection(client, "interviews");
-    auto companies = MongoService::instance().getCollection(client, "companies");
     auto students = MongoService::instance().getCollection(client, "students");
 
     // For recruiters, get their assigned drives and only show those interviews
@@ -144,9 +145,8 @@ void InterviewController::getAllInterviews(const drogon::HttpRequestPtr &req,
         if (userOpt && userOpt->view().find("assigned_drives") != userOpt->view().end()) {
             auto arr = userOpt->view()["assigned_drives"].get_array().value;
             for (auto& driveId : arr) {
-                if (driveId.type() == bsoncxx::type::k_string) {
-                    allowedDrives.insert(std::string(driveId.get_string().value));
-                }
+                std::string hex = IdHelper::str(driveId);
+                if (!hex.empty()) allowedDrives.insert(hex);
             }
         }
     }
@@ -156,11 +156,11 @@ void InterviewController::getAllInterviews(const drogon::HttpRequestPtr &req,
 
     mongocxx::cursor cursor = companyIdFilter.empty()
         ? interviews.find({})
-        : interviews.find(make_document(kvp("company_id", companyIdFilter)));
+        : interviews.find(make_document(kvp("company_id", IdHelper::match(companyIdFilter).view())));
 
     Json::Value interviewList(Json::arrayValue);
     for (auto& doc : cursor) {
-        std::string companyId = std::string(doc["company_id"].get_string().value);
+        std::string companyId = IdHelper::str(doc["company_id"]);
 
         // Recruiter scoping - skip interviews for drives they don't have access to
         if (role == "recruiter" && allowedDrives.find(companyId) == allowedDrives.end()) {
@@ -172,20 +172,12 @@ void InterviewController::getAllInterviews(const drogon::HttpRequestPtr &req,
             interview["id"] = doc["_id"].get_oid().value.to_string();
         }
 
-        // Attach company info
-        try {
-            auto companyOpt = companies.find_one(
-                make_document(kvp("_id", bsoncxx::oid{companyId}))
-            );
-            if (companyOpt) {
-                interview["company"] = JsonHelper::bsonToJson(companyOpt->view());
-                interview["company"]["id"] = companyId;
-            }
-        } catch (...) {}
+        // Attach company info, current as of the drive catalog
+        DriveCatalog::instance().attachCompany(interview, doc);
 
         // Attach student info
-        std::string studentId = std::string(doc["student_id"].get_string().value);
-        auto studentOpt = students.find_one(make_document(kvp("user_id", studentId)));
+        std::string studentId = IdHelper::str(doc["student_id"]);
+        auto studentOpt = students.find_one(make_document(kvp("user_id", IdHelper::match(studentId).view())));
         if (studentOpt) {
             interview["student"] = JsonHelper::bsonToJson(studentOpt->view());
         }
@@ -196,7 +188,7 @@ void InterviewController::getAllInterviews(const drogon::HttpRequestPtr &req,
     Json::Value result;
     result["success"] = true;
     result["interviews"] = interviewList;
-    callback(drogon::HttpResponse::newHttpJsonResponse(result));
+    callback(JsonHelper::jsonResponse(result));
 }
 
 void InterviewController::getMyInterviews(const drogon::HttpRequestPtr &req,
@@ -204,9 +196,8 @@ void InterviewController::getMyInterviews(const drogon::HttpRequestPtr &req,
     auto userId = req->attributes()->get<std::string>("user_id");
     auto client = MongoService::instance().acquireClient();
     auto interviews = MongoService::instance().getCollection(client, "interviews");
-    auto companies = MongoService::instance().getCollection(client, "companies");
 
-    auto cursor = interviews.find(make_document(kvp("student_id", userId)));
+    auto cursor = interviews.find(make_document(kvp("student_id", IdHelper::match(userId).view())));
 
     Json::Value interviewList(Json::arrayValue);
     for (auto& doc : cursor) {
@@ -215,16 +206,8 @@ void InterviewController::getMyInterviews(const drogon::HttpRequestPtr &req,
             interview["id"] = doc["_id"].get_oid().value.to_string();
         }
 
-        std::string companyId = std::string(doc["company_id"].get_string().value);
-        try {
-            auto companyOpt = companies.find_one(
-                make_document(kvp("_id", bsoncxx::oid{companyId}))
-            );
-            if (companyOpt) {
-                interview["company"] = JsonHelper::bsonToJson(companyOpt->view());
-                interview["company"]["id"] = companyId;
-            }
-        } catch (...) {}
+        // Attach company info, current as of the drive catalog
+        DriveCatalog::instance().attachCompany(interview, doc);
 
         interviewList.append(interview);
     }
@@ -232,5 +215,5 @@ void InterviewController::getMyInterviews(const drogon::HttpRequestPtr &req,
     Json::Value result;
     result["success"] = true;
     result["interviews"] = interviewList;
-    callback(drogon::HttpResponse::newHttpJsonResponse(result));
+    callback(JsonHelper::jsonResponse(result));
 }
@@ -0,0 +1,11 @@
+#include "MetricsController.h"
+#include "Metrics.h"
+
+void MetricsController::scrape(const drogon::HttpRequestPtr &req,
+                               std::function<void(const drogon::HttpResponsePtr &)> &&callback) {
+    auto resp = drogon::HttpResponse::newHttpResponse();
+    resp->setContentTypeString("text/plain; version=0.0.4; charset=utf-8");
+    resp->setBody(Metrics::instance().render());
+    resp->addHeader("Cache-Control", "no-store");
+    callback(resp);
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <drogon/HttpController.h>
+
+class MetricsController : public drogon::HttpController<MetricsController> {
+public:
+    METHOD_LIST_BEGIN
+    ADD_METHOD_TO(MetricsController::scrape, "/metrics", drogon::Get, "InternalFilter");
+    METHOD_LIST_END
+
+    // Prometheus text exposition format
+    void scrape(const drogon::HttpRequestPtr &req,
+                std::function<void(const drogon::HttpResponsePtr &)> &&callback);
+};
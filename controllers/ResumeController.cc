@@ -0,0 +1,214 @@
+#include "ResumeController.h"
+#include "IdHelper.h"
+#include "MongoService.h"
+#include "ResumeStore.h"
+#include "JsonHelper.h"
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/builder/basic/kvp.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <vector>
+
+using bsoncxx::builder::basic::kvp;
+using bsoncxx::builder::basic::make_document;
+
+namespace {
+
+struct ByteRange {
+    uint64_t offset = 0;
+    uint64_t length = 0;
+};
+
+void sendError(const std::function<void(const drogon::HttpResponsePtr &)> &callback,
+               const std::string &message, drogon::HttpStatusCode code) {
+    auto resp = JsonHelper::jsonResponse(JsonHelper::errorResponse(message));
+    resp->setStatusCode(code);
+    callback(resp);
+}
+
+// Single "bytes=" range. nullopt means serve the whole file (no header or a
+// multi-range request); a zero-length result means unsatisfiable.
+std::optional<ByteRange> parseRange(const std::string &header, uint64_t size) {
+    const std::string prefix = "bytes=";
+    if (header.compare(0, prefix.size(), prefix) != 0) return std::nullopt;
+    std::string spec = header.substr(prefix.size());
+    if (spec.find(',') != std::string::npos) return std::nullopt;
+
+    auto dash = spec.find('-');
+    if (dash == std::string::npos) return std::nullopt;
+    std::string first = spec.substr(0, dash);
+    std::string last = spec.substr(dash + 1);
+    auto digits = [](const std::string &s) {
+        return !s.empty() && s.size() <= 18 && s.find_first_not_of("0123456789") == std::string::npos;
+    };
+
+    ByteRange range;
+    if (first.empty()) {
+        // Suffix range: the last N bytes
+        if (!digits(last)) return std::nullopt;
+        uint64_t n = std::stoull(last);
+        if (n == 0 || size == 0) return ByteRange{};
+        range.length = std::min(n, size);
+        range.offset = size - range.length;
+        return range;
+    }
+
+    if (!digits(first) || (!last.empty() && !digits(last))) return std::nullopt;
+    uint64_t start = std::stoull(first);
+    if (start >= size) return ByteRange{};
+    uint64_t end = last.empty() ? size - 1 : std::min<uint64_t>(std::stoull(last), size - 1);
+    if (end < start) return std::nullopt;
+    range.offset = start;
+    range.length = end - start + 1;
+    return range;
+}
+
+bool etagMatches(const std::string &header, const std::string &etag) {
+    if (header.empty()) return false;
+    if (header == "*") return true;
+    // Comma-separated list; W/ prefixes compare weakly, which is fine for If-None-Match
+    size_t pos = 0;
+    while (pos < header.size()) {
+        size_t comma = header.find(',', pos);
+        std::string tag = header.substr(pos, comma == std::string::npos ? std::string::npos : comma - pos);
+        size_t b = tag.find_first_not_of(' ');
+        size_t e = tag.find_last_not_of(' ');
+        if (b != std::string::npos) {
+            tag = tag.substr(b, e - b + 1);
+            if (tag.compare(0, 2, "W/") == 0) tag = tag.substr(2);
+            if (tag == etag) return true;
+        }
+        if (comma == std::string::npos) break;
+        pos = comma + 1;
+    }
+    return false;
+}
+
+// Recruiters see resumes of students who applied to one of their drives
+bool recruiterCanView(const drogon::HttpRequestPtr &req, const std::string &studentId) {
+    auto drives = req->attributes()->get<std::vector<std::string>>("assigned_drives");
+    if (drives.empty()) return false;
+    auto client = MongoService::instance().acquireClient();
+    auto applications = MongoService::instance().getCollection(client, "applications");
+    mongocxx::options::count opts;
+    opts.limit(1);
+    return applications.count_documents(make_document(
+        kvp("student_id", IdHelper::match(studentId).view()),
+        kvp("company_id", make_document(kvp("$in", IdHelper::matchAny(drives))))), opts) > 0;
+}
+
+// Shared by both routes once the caller is allowed to see the resume. A
+// versioned URL (?v=<hash>) may be cached for versionedMaxAge seconds.
+void serveResume(const drogon::HttpRequestPtr &req,
+                 const std::function<void(const drogon::HttpResponsePtr &)> &callback,
+                 const std::string &studentId, long versionedMaxAge) {
+    auto client = MongoService::instance().acquireClient();
+    auto students = MongoService::instance().getCollection(client, "students");
+    mongocxx::options::find opts;
+    opts.projection(make_document(kvp("resume_hash", 1), kvp("resume_url", 1)));
+    auto student = students.find_one(make_document(kvp("user_id", IdHelper::match(studentId).view())), opts);
+    if (!student) {
+        sendError(callback, "Resume not found", drogon::k404NotFound);
+        return;
+    }
+
+    std::string path;
+    std::string etag;
+    auto hash = student->view()["resume_hash"];
+    if (hash && hash.type() == bsoncxx::type::k_string) {
+        std::string sha256(hash.get_string().value);
+        path = ResumeStore::blobPath(sha256);
+        etag = ResumeStore::etag(sha256);
+    } else {
+        // Uploaded before the content-addressed store; no hash to validate against
+        path = ResumeStore::uploadDir() + "/resume_" + studentId + ".pdf";
+    }
+
+    std::error_code ec;
+    uint64_t size = std::filesystem::file_size(path, ec);
+    if (ec) {
+        sendError(callback, "Resume not found", drogon::k404NotFound);
+        return;
+    }
+
+    // The stored resume_url carries ?v=<hash>, so a versioned URL never
+    // changes content and can be cached; bare URLs revalidate
+    bool versioned = !etag.empty() && req->getParameter("v") == etag.substr(1, etag.size() - 2);
+    std::string cacheControl = versioned
+        ? "private, max-age=" + std::to_string(versionedMaxAge) + ", immutable"
+        : "private, no-cache";
+
+    auto withHeaders = [&](const drogon::HttpResponsePtr &resp) {
+        if (!etag.empty()) resp->addHeader("ETag", etag);
+        resp->addHeader("Cache-Control", cacheControl);
+        resp->addHeader("Accept-Ranges", "bytes");
+        resp->addHeader("X-Content-Type-Options", "nosniff");
+        return resp;
+    };
+
+    if (!etag.empty() && etagMatches(req->getHeader("if-none-match"), etag)) {
+        auto resp = drogon::HttpResponse::newHttpResponse();
+        resp->setStatusCode(drogon::k304NotModified);
+        callback(withHeaders(resp));
+        return;
+    }
+
+    // A Range is only honoured when If-Range (if sent) still names this content
+    std::optional<ByteRange> range;
+    std::string ifRange = req->getHeader("if-range");
+    if (ifRange.empty() || (!etag.empty() && ifRange == etag)) {
+        range = parseRange(req->getHeader("range"), size);
+    }
+    if (range && range->length == 0) {
+        auto resp = drogon::HttpResponse::newHttpResponse();
+        resp->setStatusCode(drogon::k416RequestedRangeNotSatisfiable);
+        resp->addHeader("Content-Range", "bytes */" + std::to_string(size));
+        callback(withHeaders(resp));
+        return;
+    }
+
+    // File responses are sent with sendfile(); the PDF never passes through userspace
+    drogon::HttpResponsePtr resp;
+    if (range) {
+        resp = drogon::HttpResponse::newFileResponse(path, range->offset, range->length, true,
+                                                     "", drogon::CT_APPLICATION_PDF);
+        resp->setStatusCode(drogon::k206PartialContent);
+    } else {
+        resp = drogon::HttpResponse::newFileResponse(path, "", drogon::CT_APPLICATION_PDF);
+    }
+    resp->addHeader("Content-Disposition", "inline; filename=\"resume.pdf\"");
+    callback(withHeaders(resp));
+}
+
+} // anonymous namespace
+
+void ResumeController::download(const drogon::HttpRequestPtr &req,
+                                std::function<void(const drogon::HttpResponsePtr &)> &&callback,
+                                const std::string &studentId) {
+    auto role = req->attributes()->get<std::string>("role");
+    auto userId = req->attributes()->get<std::string>("user_id");
+
+    bool allowed = role == "tpo" || (role == "student" && userId == studentId) ||
+                   (role == "recruiter" && recruiterCanView(req, studentId));
+    if (!allowed) {
+        sendError(callback, "Access denied to this resume", drogon::k403Forbidden);
+        return;
+    }
+    serveResume(req, callback, studentId, 31536000);
+}
+
+void ResumeController::downloadSigned(const drogon::HttpRequestPtr &req,
+                                      std::function<void(const drogon::HttpResponsePtr &)> &&callback,
+                                      const std::string &studentId) {
+    // Links are only handed out in responses whose caller may see this resume
+    long left = ResumeStore::verifySignedUrl(studentId, req->getParameter("expires"),
+                                             req->getParameter("sig"));
+    if (left < 0) {
+        sendError(callback, "Resume link is invalid or has expired", drogon::k403Forbidden);
+        return;
+    }
+    // Cached copies must not outlive the link
+    serveResume(req, callback, studentId, left);
+}
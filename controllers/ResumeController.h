@@ -0,0 +1,23 @@
+#pragma once
+
+#include <drogon/HttpController.h>
+
+class ResumeController : public drogon::HttpController<ResumeController> {
+public:
+    METHOD_LIST_BEGIN
+    ADD_METHOD_TO(ResumeController::download, "/api/resumes/{studentId}", drogon::Get, "AuthFilter");
+    ADD_METHOD_TO(ResumeController::downloadSigned, "/api/resumes/{studentId}/signed", drogon::Get);
+    METHOD_LIST_END
+
+    // TPO, recruiters with an application from the student on one of their
+    // drives, and the student themself. Supports Range and If-None-Match.
+    void download(const drogon::HttpRequestPtr &req,
+                  std::function<void(const drogon::HttpResponsePtr &)> &&callback,
+                  const std::string &studentId);
+
+    // Same file for a ResumeStore::signedUrl link (?expires=&sig=), without
+    // a Bearer token, so the PWA can use plain links
+    void downloadSigned(const drogon::HttpRequestPtr &req,
+                        std::function<void(const drogon::HttpResponsePtr &)> &&callback,
+                        const std::string &studentId);
+};
@@ -0,0 +1,103 @@
+#include "SearchController.h"
+#include "StudentIndexService.h"
+#include "SearchService.h"
+#include "JsonHelper.h"
+#include <algorithm>
+#include <cctype>
+#include <sstream>
+
+namespace {
+
+// Query parameter read from the raw query string. getParameter() decodes
+// '+' as a space, which turns skills like "C++" into "C  "; here only %XX
+// escapes are decoded, so both keywords=c++ and keywords=c%2B%2B work.
+std::string rawParameter(const drogon::HttpRequestPtr &req, const std::string &name) {
+    std::istringstream pairs(req->query());
+    std::string pair;
+    while (std::getline(pairs, pair, '&')) {
+        if (pair.compare(0, name.size() + 1, name + "=") != 0) continue;
+        std::string value;
+        for (size_t i = name.size() + 1; i < pair.size(); ++i) {
+            if (pair[i] == '%' && i + 2 < pair.size() &&
+                std::isxdigit(static_cast<unsigned char>(pair[i + 1])) &&
+                std::isxdigit(static_cast<unsigned char>(pair[i + 2]))) {
+                value += static_cast<char>(std::stoi(pair.substr(i + 1, 2), nullptr, 16));
+                i += 2;
+            } else {
+                value += pair[i];
+            }
+        }
+        return value;
+    }
+    return "";
+}
+
+} // anonymous namespace
+
+void SearchController::searchStudents(const drogon::HttpRequestPtr &req,
+                                       std::function<void(const drogon::HttpResponsePtr &)> &&callback) {
+    // e.g. /api/search/students?skills=React,Node&keywords=docker&min_gpa=7.5&max_backlogs=0
+    // skills are self-reported; keywords are extracted from the uploaded resume
+    StudentIndexService::Query query;
+
+    auto splitList = [](const std::string &param, std::vector<std::string> &out) {
+        std::istringstream list(param);
+        std::string item;
+        while (std::getline(list, item, ',')) {
+            if (!StudentIndexService::normalizeSkill(item).empty()) {
+                out.push_back(item);
+            }
+        }
+    };
+    splitList(rawParameter(req, "skills"), query.skills);
+    splitList(rawParameter(req, "keywords"), query.keywords);
+
+    try {
+        std::string minGpa = req->getParameter("min_gpa");
+        std::string maxBacklogs = req->getParameter("max_backlogs");
+        std::string limit = req->getParameter("limit");
+        if (!minGpa.empty()) query.minGpa = std::stod(minGpa);
+        if (!maxBacklogs.empty()) query.maxBacklogs = std::stoi(maxBacklogs);
+        if (!limit.empty()) query.limit = static_cast<size_t>(std::clamp(std::stoi(limit), 1, 500));
+    } catch (const std::exception& e) {
+        auto resp = JsonHelper::jsonResponse(
+            JsonHelper::errorResponse("min_gpa, max_backlogs and limit must be numbers"));
+        resp->setStatusCode(drogon::k400BadRequest);
+        callback(resp);
+        return;
+    }
+
+    auto result = StudentIndexService::instance().search(query);
+    callback(JsonHelper::jsonResponse(result));
+}
+
+void SearchController::searchDirectory(const drogon::HttpRequestPtr &req,
+                                        std::function<void(const drogon::HttpResponsePtr &)> &&callback) {
+    // e.g. /api/search?q=tamil&type=students&limit=10
+    std::string query = req->getParameter("q");
+    std::string type = req->getParameter("type");
+    if (type.empty()) type = "all";
+
+    if (query.empty() || (type != "all" && type != "students" && type != "drives")) {
+        auto resp = JsonHelper::jsonResponse(
+            JsonHelper::errorResponse("q is required and type must be students, drives or all"));
+        resp->setStatusCode(drogon::k400BadRequest);
+        callback(resp);
+        return;
+    }
+
+    size_t limit = 20;
+    try {
+        std::string limitParam = req->getParameter("limit");
+        if (!limitParam.empty()) limit = static_cast<size_t>(std::clamp(std::stoi(limitParam), 1, 100));
+    } catch (const std::exception& e) {
+        auto resp = JsonHelper::jsonResponse(
+            JsonHelper::errorResponse("limit must be a number"));
+        resp->setStatusCode(drogon::k400BadRequest);
+        callback(resp);
+        return;
+    }
+
+    auto result = SearchService::instance().search(query, type, limit);
+    callback(JsonHelper::jsonResponse(result));
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <drogon/HttpController.h>
+
+class SearchController : public drogon::HttpController<SearchController> {
+public:
+    METHOD_LIST_BEGIN
+    ADD_METHOD_TO(SearchController::searchStudents, "/api/search/students", drogon::Get, "AuthFilter", "RecruiterFilter");
+    ADD_METHOD_TO(SearchController::searchDirectory, "/api/search", drogon::Get, "AuthFilter", "TpoFilter");
+    METHOD_LIST_END
+
+    void searchStudents(const drogon::HttpRequestPtr &req,
+                        std::function<void(const drogon::HttpResponsePtr &)> &&callback);
+    void searchDirectory(const drogon::HttpRequestPtr &req,
+                         std::function<void(const drogon::HttpResponsePtr &)> &&callback);
+};
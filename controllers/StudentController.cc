@@ -1,13 +1,24 @@
 #include "StudentController.h"
+#include "IdHelper.h"
 #include "MongoService.h"
 #include "EligibilityService.h"
 #include "PlacementService.h"
+#include "StudentIndexService.h"
+#include "SearchService.h"
+#include "DriveCatalog.h"
+#include "ApplyBatcher.h"
+#include "ResumeStore.h"
+#include "ResumeTextService.h"
+#include "StatsService.h"
 #include "JsonHelper.h"
 #include <bsoncxx/builder/basic/document.hpp>
 #include <bsoncxx/builder/basic/kvp.hpp>
 #include <bsoncxx/builder/basic/array.hpp>
 #include <bsoncxx/oid.hpp>
+#include <mongocxx/options/find_one_and_update.hpp>
 #include <chrono>
+#include <cstdlib>
+#include <memory>
 #include <fstream>
 
 using bsoncxx::builder::basic::kvp;
@@ -20,10 +31,10 @@ void StudentController::getProfile(const drogon::HttpRequestPtr &req,
     auto client = MongoService::instance().acquireClient();
     auto students = MongoService::instance().getCollection(client, "students");
 
-    auto studentOpt = students.find_one(make_document(kvp("user_id", userId)));
+    auto studentOpt = students.find_one(make_document(kvp("user_id", IdHelper::match(userId).view())));
 
     if (!studentOpt) {
-        auto resp = drogon::HttpResponse::newHttpJsonResponse(
+        auto resp = JsonHelper::jsonResponse(
             JsonHelper::errorResponse("Student profile not found"));
         resp->setStatusCode(drogon::k404NotFound);
         callback(resp);
@@ -34,8 +45,9 @@ void StudentController::getProfile(const drogon::HttpRequestPtr &req,
     result["success"] = true;
     result["profile"] = JsonHelper::bsonToJson(studentOpt->view());
     result["profile"]["id"] = userId;
+    ResumeStore::signResumeUrl(result["profile"]);
 
-    callback(drogon::HttpResponse::newHttpJsonResponse(result));
+    callback(JsonHelper::jsonResponse(result));
 }
 
 void StudentController::updateProfile(const drogon::HttpRequestPtr &req,
@@ -44,7 +56,7 @@ void StudentController::updateProfile(const drogon::HttpRequestPtr &req,
     auto json = req->getJsonObject();
 
     if (!json) {
-        auto resp = drogon::HttpResponse::newHttpJsonResponse(
+        auto resp = JsonHelper::jsonResponse(
             JsonHelper::errorResponse("Invalid JSON body"));
         resp->setStatusCode(drogon::k400BadRequest);
         callback(resp);
@@ -75,91 +87,150 @@ void StudentController::updateProfile(const drogon::HttpRequestPtr &req,
 
     updateDoc.append(kvp("$set", setDoc));
 
-    auto result = students.update_one(
-        make_document(kvp("user_id", userId)),
-        updateDoc.extract()
+    // The pre-image's department moves the per-department counters
+    mongocxx::options::find_one_and_update opts;
+    opts.projection(make_document(kvp("department", 1)).view());
+    auto before = students.find_one_and_update(
+        make_document(kvp("user_id", IdHelper::match(userId).view())),
+        updateDoc.extract(),
+        opts
     );
 
-    if (result && result->modified_count() > 0) {
+    if (before) {
+        StudentIndexService::instance().applyProfileUpdate(userId, *json);
+        SearchService::instance().updateStudent(userId, *json);
+        if (json->isMember("department")) {
+            auto dept = before->view()["department"];
+            std::string oldDept = dept && dept.type() == bsoncxx::type::k_string
+                ? std::string(dept.get_string().value) : "";
+            StatsService::instance().onDepartmentChanged(oldDept, (*json)["department"].asString());
+        }
+
         Json::Value res;
         res["success"] = true;
         res["message"] = "Profile updated successfully";
-        callback(drogon::HttpResponse::newHttpJsonResponse(res));
+        callback(JsonHelper::jsonResponse(res));
     } else {
-        auto resp = drogon::HttpResponse::newHttpJsonResponse(
+        auto resp = JsonHelper::jsonResponse(
             JsonHelper::errorResponse("Failed to update profile"));
         resp->setStatusCode(drogon::k400BadRequest);
         callback(resp);
     }
 }
 
-void StudentController::uploadResume(const drogon::HttpRequestPtr &req,
-                                      std::function<void(const drogon::HttpResponsePtr &)> &&callback) {
-    auto userId = req->attributes()->get<std::string>("user_id");
+namespace {
 
-    drogon::MultiPartParser fileParser;
-    if (fileParser.parse(req) != 0) {
-        auto resp = drogon::HttpResponse::newHttpJsonResponse(
-            JsonHelper::errorResponse("Failed to parse file upload"));
-        resp->setStatusCode(drogon::k400BadRequest);
-        callback(resp);
+// Multipart slack on top of the file itself: boundaries and part headers
+constexpr size_t kMultipartOverhead = 64 * 1024;
+
+struct ResumeUpload {
+    std::string userId;
+    ResumeStore::Upload file;
+    bool sawFile = false;
+    bool inFile = false;
+};
+
+void sendError(const std::function<void(const drogon::HttpResponsePtr &)> &callback,
+               const std::string &message, drogon::HttpStatusCode code) {
+    auto resp = JsonHelper::jsonResponse(JsonHelper::errorResponse(message));
+    resp->setStatusCode(code);
+    callback(resp);
+}
+
+void finishResumeUpload(ResumeUpload &upload,
+                        const std::function<void(const drogon::HttpResponsePtr &)> &callback) {
+    if (!upload.sawFile) {
+        sendError(callback, "No file uploaded", drogon::k400BadRequest);
         return;
     }
 
-    auto &files = fileParser.getFiles();
-    if (files.empty()) {
-        auto resp = drogon::HttpResponse::newHttpJsonResponse(
-            JsonHelper::errorResponse("No file uploaded"));
-        resp->setStatusCode(drogon::k400BadRequest);
-        callback(resp);
+    ResumeStore::Stored stored;
+    if (!ResumeStore::attach(upload.userId, upload.file, stored)) {
+        auto error = upload.file.error();
+        sendError(callback, ResumeStore::errorMessage(error),
+                  error == ResumeStore::Error::TooLarge ? drogon::k413RequestEntityTooLarge
+                  : error == ResumeStore::Error::Io ? drogon::k500InternalServerError
+                  : error == ResumeStore::Error::NoStudent ? drogon::k404NotFound
+                  : drogon::k400BadRequest);
         return;
     }
 
-    auto &file = files[0];
-    std::string ext(file.getFileExtension());
+    // Keyword extraction happens in the background; the upload is done now
+    bool queued = ResumeTextService::instance().enqueue(upload.userId, stored.sha256);
 
-    if (ext != "pdf") {
-        auto resp = drogon::HttpResponse::newHttpJsonResponse(
-            JsonHelper::errorResponse("Only PDF files are allowed"));
-        resp->setStatusCode(drogon::k400BadRequest);
-        callback(resp);
-        return;
-    }
+    Json::Value result;
+    result["success"] = true;
+    result["resume_url"] = ResumeStore::signedUrl(upload.userId, stored.sha256);
+    result["resume_hash"] = stored.sha256;
+    result["resume_size"] = static_cast<Json::UInt64>(stored.size);
+    result["keywords"] = queued ? "queued" : "deferred";
+    result["message"] = stored.unchanged ? "Resume unchanged" : "Resume uploaded successfully";
+    callback(JsonHelper::jsonResponse(result));
+}
 
-    // Max 5MB
-    if (file.fileLength() > 5 * 1024 * 1024) {
-        auto resp = drogon::HttpResponse::newHttpJsonResponse(
-            JsonHelper::errorResponse("File size must be under 5MB"));
-        resp->setStatusCode(drogon::k400BadRequest);
-        callback(resp);
+} // anonymous namespace
+
+void StudentController::uploadResume(const drogon::HttpRequestPtr &req,
+                                      drogon::RequestStreamPtr &&stream,
+                                      std::function<void(const drogon::HttpResponsePtr &)> &&callback) {
+    // Refuse oversized uploads from the headers, before any of the body is read
+    std::string contentLength = req->getHeader("content-length");
+    if (!contentLength.empty() &&
+        std::strtoull(contentLength.c_str(), nullptr, 10) > ResumeStore::kMaxBytes + kMultipartOverhead) {
+        sendError(callback, ResumeStore::errorMessage(ResumeStore::Error::TooLarge),
+                  drogon::k413RequestEntityTooLarge);
         return;
     }
 
-    std::string filename = "resume_" + userId + ".pdf";
-    std::string savePath = "./uploads/" + filename;
-    file.saveAs(savePath);
-
-    std::string resumeUrl = "/uploads/" + filename;
+    auto upload = std::make_shared<ResumeUpload>();
+    upload->userId = req->attributes()->get<std::string>("user_id");
 
-    auto client = MongoService::instance().acquireClient();
-    auto students = MongoService::instance().getCollection(client, "students");
-    students.update_one(
-        make_document(kvp("user_id", userId)),
-        make_document(kvp("$set", make_document(kvp("resume_url", resumeUrl))))
-    );
+    if (!stream) {
+        // The whole (small) body arrived with the headers; nothing left to stream
+        drogon::MultiPartParser fileParser;
+        if (fileParser.parse(req) != 0) {
+            sendError(callback, "Failed to parse file upload", drogon::k400BadRequest);
+            return;
+        }
+        auto &files = fileParser.getFiles();
+        if (!files.empty()) {
+            upload->sawFile = true;
+            upload->file.append(files[0].fileData(), files[0].fileLength());
+        }
+        finishResumeUpload(*upload, callback);
+        return;
+    }
 
-    Json::Value result;
-    result["success"] = true;
-    result["resume_url"] = resumeUrl;
-    result["message"] = "Resume uploaded successfully";
-    callback(drogon::HttpResponse::newHttpJsonResponse(result));
+    // Only the first file part is kept; its bytes go straight to a temp file
+    auto reader = drogon::RequestStreamReader::newMultipartReader(
+        req,
+        [upload](drogon::MultipartHeader &&header) {
+            upload->inFile = !upload->sawFile && !header.filename.empty();
+            if (upload->inFile) upload->sawFile = true;
+        },
+        [upload](const char *data, size_t length) {
+            if (!upload->inFile) return;
+            if (length == 0) {
+                upload->inFile = false;
+                return;
+            }
+            upload->file.append(data, length);
+        },
+        [upload, callback = std::move(callback)](std::exception_ptr ex) {
+            if (ex) {
+                sendError(callback, "Failed to parse file upload", drogon::k400BadRequest);
+                return;
+            }
+            finishResumeUpload(*upload, callback);
+        });
+    stream->setStreamReader(std::move(reader));
 }
 
 void StudentController::getEligibleDrives(const drogon::HttpRequestPtr &req,
                                            std::function<void(const drogon::HttpResponsePtr &)> &&callback) {
     auto userId = req->attributes()->get<std::string>("user_id");
     auto result = EligibilityService::getEligibleDrives(userId);
-    auto resp = drogon::HttpResponse::newHttpJsonResponse(result);
+    auto resp = JsonHelper::jsonResponse(result);
     if (!result["success"].asBool()) {
         resp->setStatusCode(drogon::k404NotFound);
     }
@@ -170,7 +241,7 @@ void StudentController::getRecommendedDrives(const drogon::HttpRequestPtr &req,
                                               std::function<void(const drogon::HttpResponsePtr &)> &&callback) {
     auto userId = req->attributes()->get<std::string>("user_id");
     auto result = EligibilityService::getRecommendedDrives(userId);
-    auto resp = drogon::HttpResponse::newHttpJsonResponse(result);
+    auto resp = JsonHelper::jsonResponse(result);
     if (!result["success"].asBool()) {
         resp->setStatusCode(drogon::k404NotFound);
     }
@@ -183,7 +254,7 @@ void StudentController::applyToDrive(const drogon::HttpRequestPtr &req,
     auto json = req->getJsonObject();
 
     if (!json || !json->isMember("company_id")) {
-        auto resp = drogon::HttpResponse::newHttpJsonResponse(
+        auto resp = JsonHelper::jsonResponse(
             JsonHelper::errorResponse("company_id is required"));
         resp->setStatusCode(drogon::k400BadRequest);
         callback(resp);
@@ -192,55 +263,39 @@ void StudentController::applyToDrive(const drogon::HttpRequestPtr &req,
 
     std::string companyId = (*json)["company_id"].asString();
 
-    auto client = MongoService::instance().acquireClient();
-
     // Verify company exists
-    auto companies = MongoService::instance().getCollection(client, "companies");
-    auto companyOpt = companies.find_one(
-        make_document(kvp("_id", bsoncxx::oid{companyId}))
-    );
-    if (!companyOpt) {
-        auto resp = drogon::HttpResponse::newHttpJsonResponse(
+    auto drive = DriveCatalog::instance().find(companyId);
+    if (!drive) {
+        auto resp = JsonHelper::jsonResponse(
             JsonHelper::errorResponse("Company drive not found"));
         resp->setStatusCode(drogon::k404NotFound);
         callback(resp);
         return;
     }
 
-    // Check if already applied
-    auto applications = MongoService::instance().getCollection(client, "applications");
-    auto existingApp = applications.find_one(
-        make_document(kvp("student_id", userId), kvp("company_id", companyId))
-    );
-    if (existingApp) {
-        auto resp = drogon::HttpResponse::newHttpJsonResponse(
-            JsonHelper::errorResponse("Already applied to this drive"));
-        resp->setStatusCode(drogon::k400BadRequest);
-        callback(resp);
-        return;
-    }
-
-    // Create application
-    auto now = bsoncxx::types::b_date{std::chrono::system_clock::now()};
-    auto appDoc = make_document(
-        kvp("student_id", userId),
-        kvp("company_id", companyId),
-        kvp("status", "APPLIED"),
-        kvp("applied_at", now)
-    );
-
-    applications.insert_one(appDoc.view());
-
-    // Create notification for student
-    auto companyDoc = companyOpt->view();
-    std::string companyName = std::string(companyDoc["company_name"].get_string().value);
-    PlacementService::createNotification(userId,
-        "You have applied to " + companyName, "application");
+    // Batched insert; the unique {student_id, company_id} index reports repeats
+    ApplyBatcher::instance().submit(userId, *drive,
+        [callback = std::move(callback)](ApplyBatcher::Outcome outcome) {
+            if (outcome == ApplyBatcher::Outcome::Duplicate) {
+                auto resp = JsonHelper::jsonResponse(
+                    JsonHelper::errorResponse("Already applied to this drive"));
+                resp->setStatusCode(drogon::k400BadRequest);
+                callback(resp);
+                return;
+            }
+            if (outcome == ApplyBatcher::Outcome::Failed) {
+                auto resp = JsonHelper::jsonResponse(
+                    JsonHelper::errorResponse("Failed to submit application, please retry"));
+                resp->setStatusCode(drogon::k500InternalServerError);
+                callback(resp);
+                return;
+            }
 
-    Json::Value result;
-    result["success"] = true;
-    result["message"] = "Application submitted successfully";
-    callback(drogon::HttpResponse::newHttpJsonResponse(result));
+            Json::Value result;
+            result["success"] = true;
+            result["message"] = "Application submitted successfully";
+            callback(JsonHelper::jsonResponse(result));
+        });
 }
 
 void StudentController::getApplications(const drogon::HttpRequestPtr &req,
@@ -248,9 +303,8 @@ void StudentController::getApplications(const drogon::HttpRequestPtr &req,
     auto userId = req->attributes()->get<std::string>("user_id");
     auto client = MongoService::instance().acquireClient();
     auto applications = MongoService::instance().getCollection(client, "applications");
-    auto companies = MongoService::instance().getCollection(client, "companies");
 
-    auto cursor = applications.find(make_document(kvp("student_id", userId)));
+    auto cursor = applications.find(make_document(kvp("student_id", IdHelper::match(userId).view())));
 
     Json::Value apps(Json::arrayValue);
     for (auto& doc : cursor) {
@@ -259,17 +313,8 @@ void StudentController::getApplications(const drogon::HttpRequestPtr &req,
             app["id"] = doc["_id"].get_oid().value.to_string();
         }
 
-        // Attach company info
-        std::string companyId = std::string(doc["company_id"].get_string().value);
-        try {
-            auto companyOpt = companies.find_one(
-                make_document(kvp("_id", bsoncxx::oid{companyId}))
-            );
-            if (companyOpt) {
-                app["company"] = JsonHelper::bsonToJson(companyOpt->view());
-                app["company"]["id"] = companyId;
-            }
-        } catch (...) {}
+        // Attach company info, current as of the drive catalog
+        DriveCatalog::instance().attachCompany(app, doc);
 
         apps.append(app);
     }
@@ -277,5 +322,5 @@ void StudentController::getApplications(const drogon::HttpRequestPtr &req,
     Json::Value result;
     result["success"] = true;
     result["applications"] = apps;
-    callback(drogon::HttpResponse::newHttpJsonResponse(result));
+    callback(JsonHelper::jsonResponse(result));
 }
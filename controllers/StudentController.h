@@ -1,6 +1,7 @@
 #pragma once
 
 #include <drogon/HttpController.h>
+#include <drogon/RequestStream.h>
 
 class StudentController : public drogon::HttpController<StudentController> {
 public:
@@ -18,7 +19,9 @@ public:
                     std::function<void(const drogon::HttpResponsePtr &)> &&callback);
     void updateProfile(const drogon::HttpRequestPtr &req,
                        std::function<void(const drogon::HttpResponsePtr &)> &&callback);
+    // Streamed: the body is written to disk as it arrives
     void uploadResume(const drogon::HttpRequestPtr &req,
+                      drogon::RequestStreamPtr &&stream,
                       std::function<void(const drogon::HttpResponsePtr &)> &&callback);
     void getEligibleDrives(const drogon::HttpRequestPtr &req,
                            std::function<void(const drogon::HttpResponsePtr &)> &&callback);
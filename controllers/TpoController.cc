@@ -1,18 +1,22 @@
 #include "TpoController.h"
 #include "TpoService.h"
 #include "JsonHelper.h"
+#include "IdHelper.h"
+#include "IdMigrationService.h"
+#include "ResumeStore.h"
+#include "ResumeTextService.h"
 
 void TpoController::getPendingStudents(const drogon::HttpRequestPtr &req,
                                         std::function<void(const drogon::HttpResponsePtr &)> &&callback) {
     auto result = TpoService::getPendingStudents();
-    callback(drogon::HttpResponse::newHttpJsonResponse(result));
+    callback(JsonHelper::jsonResponse(result));
 }
 
 void TpoController::approveStudent(const drogon::HttpRequestPtr &req,
                                     std::function<void(const drogon::HttpResponsePtr &)> &&callback,
                                     const std::string &id) {
     auto result = TpoService::approveStudent(id);
-    auto resp = drogon::HttpResponse::newHttpJsonResponse(result);
+    auto resp = JsonHelper::jsonResponse(result);
     if (!result["success"].asBool()) {
         resp->setStatusCode(drogon::k400BadRequest);
     }
@@ -23,7 +27,7 @@ void TpoController::rejectStudent(const drogon::HttpRequestPtr &req,
                                    std::function<void(const drogon::HttpResponsePtr &)> &&callback,
                                    const std::string &id) {
     auto result = TpoService::rejectStudent(id);
-    auto resp = drogon::HttpResponse::newHttpJsonResponse(result);
+    auto resp = JsonHelper::jsonResponse(result);
     if (!result["success"].asBool()) {
         resp->setStatusCode(drogon::k400BadRequest);
     }
@@ -33,5 +37,49 @@ void TpoController::rejectStudent(const drogon::HttpRequestPtr &req,
 void TpoController::getRecruiters(const drogon::HttpRequestPtr &req,
                                    std::function<void(const drogon::HttpResponsePtr &)> &&callback) {
     auto result = TpoService::getAllRecruiters();
-    callback(drogon::HttpResponse::newHttpJsonResponse(result));
+    callback(JsonHelper::jsonResponse(result));
+}
+
+void TpoController::startIdMigration(const drogon::HttpRequestPtr &req,
+                                      std::function<void(const drogon::HttpResponsePtr &)> &&callback) {
+    // Converting while the server still matches plain strings would hide the rewritten documents
+    if (IdHelper::format() != IdHelper::Format::Dual) {
+        auto resp = JsonHelper::jsonResponse(
+            JsonHelper::errorResponse("Run the ID migration with ID_FORMAT=dual"));
+        resp->setStatusCode(drogon::k409Conflict);
+        callback(resp);
+        return;
+    }
+    if (!IdMigrationService::instance().start()) {
+        auto resp = JsonHelper::jsonResponse(
+            JsonHelper::errorResponse("ID migration is already running"));
+        resp->setStatusCode(drogon::k409Conflict);
+        callback(resp);
+        return;
+    }
+    auto resp = JsonHelper::jsonResponse(IdMigrationService::instance().status());
+    resp->setStatusCode(drogon::k202Accepted);
+    callback(resp);
+}
+
+void TpoController::getIdMigration(const drogon::HttpRequestPtr &req,
+                                    std::function<void(const drogon::HttpResponsePtr &)> &&callback) {
+    callback(JsonHelper::jsonResponse(IdMigrationService::instance().status()));
+}
+
+void TpoController::collectResumeGarbage(const drogon::HttpRequestPtr &req,
+                                          std::function<void(const drogon::HttpResponsePtr &)> &&callback) {
+    try {
+        callback(JsonHelper::jsonResponse(ResumeStore::collectGarbage()));
+    } catch (const std::exception& e) {
+        auto resp = JsonHelper::jsonResponse(
+            JsonHelper::errorResponse(std::string("Resume cleanup failed: ") + e.what()));
+        resp->setStatusCode(drogon::k500InternalServerError);
+        callback(resp);
+    }
+}
+
+void TpoController::getResumeText(const drogon::HttpRequestPtr &req,
+                                   std::function<void(const drogon::HttpResponsePtr &)> &&callback) {
+    callback(JsonHelper::jsonResponse(ResumeTextService::instance().status()));
 }
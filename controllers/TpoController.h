@@ -9,6 +9,10 @@ public:
     ADD_METHOD_TO(TpoController::approveStudent, "/api/tpo/students/{id}/approve", drogon::Put, "AuthFilter", "TpoFilter");
     ADD_METHOD_TO(TpoController::rejectStudent, "/api/tpo/students/{id}/reject", drogon::Put, "AuthFilter", "TpoFilter");
     ADD_METHOD_TO(TpoController::getRecruiters, "/api/tpo/recruiters", drogon::Get, "AuthFilter", "TpoFilter");
+    ADD_METHOD_TO(TpoController::startIdMigration, "/api/tpo/maintenance/id-migration", drogon::Post, "AuthFilter", "TpoFilter");
+    ADD_METHOD_TO(TpoController::getIdMigration, "/api/tpo/maintenance/id-migration", drogon::Get, "AuthFilter", "TpoFilter");
+    ADD_METHOD_TO(TpoController::collectResumeGarbage, "/api/tpo/maintenance/resume-gc", drogon::Post, "AuthFilter", "TpoFilter");
+    ADD_METHOD_TO(TpoController::getResumeText, "/api/tpo/maintenance/resume-text", drogon::Get, "AuthFilter", "TpoFilter");
     METHOD_LIST_END
 
     void getPendingStudents(const drogon::HttpRequestPtr &req,
@@ -21,4 +25,13 @@ public:
                        const std::string &id);
     void getRecruiters(const drogon::HttpRequestPtr &req,
                        std::function<void(const drogon::HttpResponsePtr &)> &&callback);
+    void startIdMigration(const drogon::HttpRequestPtr &req,
+                          std::function<void(const drogon::HttpResponsePtr &)> &&callback);
+    void getIdMigration(const drogon::HttpRequestPtr &req,
+                        std::function<void(const drogon::HttpResponsePtr &)> &&callback);
+    void collectResumeGarbage(const drogon::HttpRequestPtr &req,
+                              std::function<void(const drogon::HttpResponsePtr &)> &&callback);
+    // Keyword extraction workers and queue depth
+    void getResumeText(const drogon::HttpRequestPtr &req,
+                       std::function<void(const drogon::HttpResponsePtr &)> &&callback);
 };
@@ -1,12 +1,30 @@
 #include <drogon/drogon.h>
 #include "MongoService.h"
+#include "StudentIndexService.h"
+#include "SearchService.h"
+#include "StatsService.h"
+#include "PivotService.h"
+#include "DriveCatalog.h"
+#include "IndexRegistry.h"
+#include "ResumeStore.h"
+#include "ResumeTextService.h"
+#include "StartupService.h"
+#include "RequestMetrics.h"
+#include "RequestTracing.h"
+#include "Metrics.h"
 #include <iostream>
 #include <cstdlib>
+#include <stdexcept>
 #include <vector>
 #include <string>
 #include <sstream>
 
 int main() {
+    // First, so the startup breakdown is measured from here
+    auto &startup = StartupService::instance();
+    // Ready only once the listener accepts, whatever finishes first
+    startup.expect("listening");
+
     // Initialize MongoDB
     const char* mongoUri = std::getenv("MONGO_URI");
     const char* dbName = std::getenv("MONGO_DB");
@@ -18,7 +36,7 @@ int main() {
         dbName = "placementdb";
     }
 
-    MongoService::instance().init(mongoUri, dbName);
+    startup.measure("mongo_connect", [&]() { MongoService::instance().init(mongoUri, dbName); });
     std::cout << "MongoDB initialized successfully" << std::endl;
 
     // Configure Drogon
@@ -32,6 +50,9 @@ int main() {
     app.setLogLevel(trantor::Logger::kInfo);
     app.setUploadPath("./uploads");
     app.setClientMaxBodySize(10 * 1024 * 1024);  // 10MB
+    // Handlers that take a RequestStreamPtr (resume upload) get the body in
+    // chunks and enforce their own size limits
+    app.enableRequestStream();
 
     // CORS configuration — supports multiple origins (comma-separated in env)
     const char* corsOriginEnv = std::getenv("CORS_ORIGIN");
@@ -60,7 +81,7 @@ int main() {
             auto resp = drogon::HttpResponse::newHttpResponse();
             resp->addHeader("Access-Control-Allow-Origin", getMatchedOrigin(req));
             resp->addHeader("Access-Control-Allow-Methods", "GET, POST, PUT, DELETE, OPTIONS");
-            resp->addHeader("Access-Control-Allow-Headers", "Content-Type, Authorization");
+            resp->addHeader("Access-Control-Allow-Headers", "Content-Type, Authorization, X-Request-Id");
             resp->addHeader("Access-Control-Allow-Credentials", "true");
             resp->addHeader("Access-Control-Max-Age", "86400");
             stop(resp);
@@ -69,19 +90,88 @@ int main() {
         pass();
     });
 
+    // Resumes are served by ResumeController with access checks; the upload
+    // directory must not be reachable through the static file handler
+    app.registerPreRoutingAdvice([](const drogon::HttpRequestPtr &req,
+                                    drogon::FilterCallback &&stop,
+                                    drogon::FilterChainCallback &&pass) {
+        if (req->path().rfind("/uploads", 0) == 0) {
+            auto resp = drogon::HttpResponse::newHttpResponse();
+            resp->setStatusCode(drogon::k404NotFound);
+            stop(resp);
+            return;
+        }
+        pass();
+    });
+
     app.registerPostHandlingAdvice([getMatchedOrigin](const drogon::HttpRequestPtr &req,
                                        const drogon::HttpResponsePtr &resp) {
         resp->addHeader("Access-Control-Allow-Origin", getMatchedOrigin(req));
         resp->addHeader("Access-Control-Allow-Methods", "GET, POST, PUT, DELETE, OPTIONS");
-        resp->addHeader("Access-Control-Allow-Headers", "Content-Type, Authorization");
+        resp->addHeader("Access-Control-Allow-Headers", "Content-Type, Authorization, X-Request-Id");
         resp->addHeader("Access-Control-Allow-Credentials", "true");
+        // Let the PWA read per-request timings (see RequestTracing)
+        resp->addHeader("Access-Control-Expose-Headers", "Server-Timing, X-Request-Id");
+        resp->addHeader("Timing-Allow-Origin", getMatchedOrigin(req));
     });
 
-    // Create indexes
-    MongoService::instance().createIndexes();
+    // Create indexes, then INDEX_CHECK=warn|strict explains the registered
+    // query shapes. Both run alongside the cache loads below; in strict mode
+    // a failed check keeps /readyz at 503 instead of exiting.
+    startup.background("indexes", IndexRegistry::strict(), []() {
+        MongoService::instance().createIndexes();
+        if (!IndexRegistry::runStartupCheck()) {
+            throw std::runtime_error("index check failed in strict mode");
+        }
+    });
+
+    // Open pool connections before traffic arrives; /readyz waits for this.
+    // MONGO_MIN_POOL=0 turns pre-warming off.
+    const char* minPoolEnv = std::getenv("MONGO_MIN_POOL");
+    long minPool = minPoolEnv ? std::strtol(minPoolEnv, nullptr, 10) : 8;
+    if (minPool < 0) minPool = 8;
+    startup.background("mongo_prewarm", true, [minPool]() {
+        MongoService::instance().prewarm(static_cast<size_t>(minPool));
+    });
+
+    // The steps below are independent of each other and load concurrently
+    // on the startup workers; /readyz waits for all of them and stays at 503
+    // if one throws.
+
+    // Profiles saved with static /uploads URLs now go through /api/resumes
+    startup.background("legacy_urls", true, []() { ResumeStore::rewriteLegacyUrls(); });
 
     // Auto-seed TPO account if none exists
-    MongoService::instance().seedTpo();
+    startup.background("tpo_seed", true, []() { MongoService::instance().seedTpo(); });
+
+    // Drive lookups for the application hot paths
+    startup.background("drive_catalog", true, []() { DriveCatalog::instance().load(); });
+
+    // Build in-memory search indexes
+    startup.background("student_index", true, []() {
+        StudentIndexService::instance().load();
+        // Extract keywords from resumes uploaded while the queue was full or
+        // the server was down; after the load so it cannot overwrite them
+        ResumeTextService::instance().backfill();
+    });
+    startup.background("search_index", true, []() { SearchService::instance().load(); });
+
+    // Load dashboard counters (rebuilt from source on first run)
+    startup.background("stats", true, []() { StatsService::instance().load(); });
+
+    // Columnar snapshot for ad-hoc pivots, refreshed in the background
+    startup.measure("pivot", []() { PivotService::instance().start(); });
+
+    // Latency and status per route, plus a few queue gauges, on /metrics
+    RequestMetrics::install();
+    // Server-Timing on every response, sampled span timelines in the log
+    RequestTracing::install();
+    Metrics::instance().gauge("startup_ready", "1 once /readyz reports ready",
+                              []() { return StartupService::instance().ready() ? 1.0 : 0.0; });
+    Metrics::instance().gauge("resume_text_queue_depth", "Resume keyword jobs waiting for a worker",
+                              []() { return ResumeTextService::instance().status()["queued"].asDouble(); });
+
+    app.registerBeginningAdvice([]() { StartupService::instance().open("listening"); });
 
     std::cout << "Server starting on port " << port << "..." << std::endl;
     app.run();
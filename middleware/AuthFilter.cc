@@ -1,4 +1,5 @@
 #include "AuthFilter.h"
+#include "IdHelper.h"
 #include "JwtHelper.h"
 #include "MongoService.h"
 #include <drogon/HttpResponse.h>
@@ -6,6 +7,8 @@
 #include <bsoncxx/builder/basic/document.hpp>
 #include <bsoncxx/builder/basic/kvp.hpp>
 #include <bsoncxx/oid.hpp>
+#include <string>
+#include <vector>
 
 using bsoncxx::builder::basic::kvp;
 using bsoncxx::builder::basic::make_document;
@@ -42,11 +45,14 @@ void AuthFilter::doFilter(const drogon::HttpRequestPtr &req,
     std::string role = payload["role"].asString();
 
     // Verify user still has active status in database
+    std::vector<std::string> assignedDrives;
     try {
         auto client = MongoService::instance().acquireClient();
         auto users = MongoService::instance().getCollection(client, "users");
+        mongocxx::options::find opts;
+        opts.projection(make_document(kvp("status", 1), kvp("assigned_drives", 1)));
         auto userOpt = users.find_one(
-            make_document(kvp("_id", bsoncxx::oid{userId}))
+            make_document(kvp("_id", bsoncxx::oid{userId})), opts
         );
 
         if (!userOpt) {
@@ -75,6 +81,15 @@ void AuthFilter::doFilter(const drogon::HttpRequestPtr &req,
             cb(resp);
             return;
         }
+
+        // Recruiter drive scope, so handlers need not re-read the user
+        auto drives = userDoc["assigned_drives"];
+        if (drives && drives.type() == bsoncxx::type::k_array) {
+            for (auto& driveId : drives.get_array().value) {
+                std::string hex = IdHelper::str(driveId);
+                if (!hex.empty()) assignedDrives.push_back(std::move(hex));
+            }
+        }
     } catch (const std::exception& e) {
         Json::Value err;
         err["success"] = false;
@@ -88,6 +103,7 @@ void AuthFilter::doFilter(const drogon::HttpRequestPtr &req,
     // Attach user info to request attributes
     req->attributes()->insert("user_id", userId);
     req->attributes()->insert("role", role);
+    req->attributes()->insert("assigned_drives", assignedDrives);
 
     ccb();
 }
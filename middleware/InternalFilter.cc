@@ -0,0 +1,36 @@
+#include "InternalFilter.h"
+#include <drogon/HttpResponse.h>
+#include <json/json.h>
+#include <openssl/crypto.h>
+#include <cstdlib>
+#include <string>
+
+void InternalFilter::doFilter(const drogon::HttpRequestPtr &req,
+                               drogon::FilterCallback &&cb,
+                               drogon::FilterChainCallback &&ccb) {
+    const char* tokenEnv = std::getenv("METRICS_TOKEN");
+    bool allowed;
+    if (tokenEnv && *tokenEnv) {
+        std::string expected = std::string("Bearer ") + tokenEnv;
+        const std::string& given = req->getHeader("Authorization");
+        allowed = given.size() == expected.size() &&
+                  CRYPTO_memcmp(given.data(), expected.data(), given.size()) == 0;
+    } else {
+        // Behind a proxy every peer looks internal; the forwarded header gives it away
+        const auto& peer = req->peerAddr();
+        allowed = (peer.isLoopbackIp() || peer.isIntranetIp()) &&
+                  req->getHeader("X-Forwarded-For").empty();
+    }
+
+    if (!allowed) {
+        Json::Value err;
+        err["success"] = false;
+        err["error"] = "Not found";
+        auto resp = drogon::HttpResponse::newHttpJsonResponse(err);
+        resp->setStatusCode(drogon::k404NotFound);
+        cb(resp);
+        return;
+    }
+
+    ccb();
+}
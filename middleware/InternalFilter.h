@@ -0,0 +1,13 @@
+#pragma once
+
+#include <drogon/HttpFilter.h>
+
+// Operational endpoints (/metrics): with METRICS_TOKEN set, requires it as a
+// bearer token; without it, only loopback and private-network peers that did
+// not come through a proxy (no X-Forwarded-For) are let in.
+class InternalFilter : public drogon::HttpFilter<InternalFilter> {
+public:
+    void doFilter(const drogon::HttpRequestPtr &req,
+                  drogon::FilterCallback &&cb,
+                  drogon::FilterChainCallback &&ccb) override;
+};
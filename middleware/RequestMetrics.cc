@@ -0,0 +1,98 @@
+#include "RequestMetrics.h"
+#include "Metrics.h"
+#include "MongoMonitor.h"
+#include <drogon/drogon.h>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+
+namespace {
+
+struct RouteSeries {
+    Metrics::Histogram* latency;
+    Metrics::Counter* requests;
+    Metrics::Counter* mongoCommands;
+    Metrics::Counter* overBudget;
+    std::chrono::steady_clock::time_point lastWarned;
+};
+
+uint32_t queryBudget() {
+    static const uint32_t budget = [] {
+        const char* env = std::getenv("MONGO_QUERY_BUDGET");
+        long n = env ? std::strtol(env, nullptr, 10) : 50;
+        return static_cast<uint32_t>(n > 0 ? n : 0);
+    }();
+    return budget;
+}
+
+// Registry lookups take a shared lock and build label strings; each IO
+// thread remembers the handles it has already resolved instead
+RouteSeries& seriesFor(const std::string& route, const char* method, int status) {
+    thread_local std::unordered_map<std::string, RouteSeries> cache;
+
+    std::string key = route;
+    key += ' ';
+    key += method;
+    key += ' ';
+    key += std::to_string(status);
+    auto it = cache.find(key);
+    if (it != cache.end()) return it->second;
+
+    auto& metrics = Metrics::instance();
+    RouteSeries series{
+        &metrics.histogram("http_request_duration_seconds",
+                           "Time from request parsed to response sent, filters included",
+                           {{"route", route}, {"method", method}}),
+        &metrics.counter("http_requests_total", "Responses by route, method and status code",
+                         {{"route", route}, {"method", method}, {"status", std::to_string(status)}}),
+        &metrics.counter("http_request_mongo_commands_total", "Mongo commands issued while serving the route",
+                         {{"route", route}, {"method", method}}),
+        &metrics.counter("mongo_query_budget_exceeded_total", "Requests that issued more than MONGO_QUERY_BUDGET commands",
+                         {{"route", route}, {"method", method}}),
+        {},
+    };
+    return cache.emplace(std::move(key), series).first->second;
+}
+
+} // anonymous namespace
+
+void RequestMetrics::install() {
+    // After routing but before filters, so AuthFilter's user lookup counts too
+    drogon::app().registerPostRoutingAdvice([](const drogon::HttpRequestPtr &req) {
+        auto commands = std::make_shared<std::atomic<uint32_t>>(0);
+        req->attributes()->insert("mongo_commands", commands);
+        MongoMonitor::attribute(std::move(commands));
+    });
+
+    // Pre-sending rather than post-handling advice: it also sees responses
+    // produced by filters (401/403) and unmatched routes (404)
+    drogon::app().registerPreSendingAdvice([](const drogon::HttpRequestPtr &req,
+                                              const drogon::HttpResponsePtr &resp) {
+        int64_t micros = trantor::Date::now().microSecondsSinceEpoch() -
+                         req->creationDate().microSecondsSinceEpoch();
+
+        std::string route(req->getMatchedPathPattern());
+        if (route.empty()) route = "unmatched";
+        auto& series = seriesFor(route, req->methodString(), static_cast<int>(resp->statusCode()));
+        series.latency->recordMicros(micros > 0 ? static_cast<uint64_t>(micros) : 0);
+        series.requests->add();
+
+        if (!req->attributes()->find("mongo_commands")) return;
+        auto commands = req->attributes()->get<MongoMonitor::Counter>("mongo_commands");
+        uint32_t issued = commands ? commands->load(std::memory_order_relaxed) : 0;
+        series.mongoCommands->add(issued);
+
+        uint32_t budget = queryBudget();
+        if (budget > 0 && issued > budget) {
+            series.overBudget->add();
+            auto now = std::chrono::steady_clock::now();
+            if (now - series.lastWarned >= std::chrono::minutes(1)) {
+                series.lastWarned = now;
+                std::cerr << "Warning: Query budget exceeded: " << req->methodString() << " " << route
+                          << " issued " << issued << " Mongo commands (budget " << budget << ")" << std::endl;
+            }
+        }
+    });
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+// Per-route request latency and status counts, recorded from drogon advice.
+// Routes are labelled by their registered pattern ("/api/companies/{id}"),
+// never the raw path, so the series count stays bounded.
+//
+// Each request also counts the Mongo commands it issues (MongoMonitor).
+// A request above MONGO_QUERY_BUDGET commands (default 50, 0 = off) bumps
+// mongo_query_budget_exceeded_total{route} and logs a warning, at most once
+// a minute per route and IO thread.
+class RequestMetrics {
+public:
+    // Call once before app().run()
+    static void install();
+};
@@ -0,0 +1,105 @@
+#include "RequestTracing.h"
+#include "RequestTrace.h"
+#include <drogon/drogon.h>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+
+namespace {
+
+double sampleRate() {
+    static const double rate = [] {
+        const char* env = std::getenv("TRACE_SAMPLE_RATE");
+        double r = env ? std::strtod(env, nullptr) : 0.01;
+        return r < 0 ? 0.0 : (r > 1 ? 1.0 : r);
+    }();
+    return rate;
+}
+
+int64_t slowMicros() {
+    static const int64_t value = [] {
+        const char* env = std::getenv("TRACE_SLOW_MS");
+        long ms = env ? std::strtol(env, nullptr, 10) : 1000;
+        return static_cast<int64_t>(ms > 0 ? ms : 0) * 1000;
+    }();
+    return value;
+}
+
+std::mt19937_64& rng() {
+    thread_local std::mt19937_64 engine(std::random_device{}());
+    return engine;
+}
+
+// Ids come back in headers and logs, so only pass through ones that cannot
+// smuggle anything into either
+bool usableId(const std::string& id) {
+    if (id.empty() || id.size() > 64) return false;
+    for (char c : id) {
+        bool ok = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+                  c == '-' || c == '_' || c == '.';
+        if (!ok) return false;
+    }
+    return true;
+}
+
+std::string newId() {
+    static const char hex[] = "0123456789abcdef";
+    uint64_t bits = rng()();
+    std::string id(16, '0');
+    for (int i = 15; i >= 0; --i) {
+        id[i] = hex[bits & 0xf];
+        bits >>= 4;
+    }
+    return id;
+}
+
+std::shared_ptr<RequestTrace> traceOf(const drogon::HttpRequestPtr& req) {
+    if (!req->attributes()->find("trace")) return nullptr;
+    return req->attributes()->get<std::shared_ptr<RequestTrace>>("trace");
+}
+
+} // anonymous namespace
+
+void RequestTracing::install() {
+    drogon::app().registerPostRoutingAdvice([](const drogon::HttpRequestPtr &req) {
+        std::string id = req->getHeader("x-request-id");
+        if (!usableId(id)) id = newId();
+        double rate = sampleRate();
+        bool sampled = rate > 0 && std::generate_canonical<double, 53>(rng()) < rate;
+
+        auto trace = std::make_shared<RequestTrace>(std::move(id), sampled);
+        req->attributes()->insert("trace", trace);
+        RequestTrace::attach(std::move(trace));
+    });
+
+    drogon::app().registerPreHandlingAdvice([](const drogon::HttpRequestPtr &req) {
+        if (auto trace = traceOf(req)) trace->markHandlerStart();
+    });
+
+    drogon::app().registerPostHandlingAdvice([](const drogon::HttpRequestPtr &req,
+                                                const drogon::HttpResponsePtr &) {
+        if (auto trace = traceOf(req)) trace->markHandlerEnd();
+    });
+
+    drogon::app().registerPreSendingAdvice([](const drogon::HttpRequestPtr &req,
+                                              const drogon::HttpResponsePtr &resp) {
+        auto trace = traceOf(req);
+        if (!trace) return;
+        // Nothing after this point belongs to the request. Handlers that
+        // answer later (ApplyBatcher) may find another request's trace bound.
+        if (RequestTrace::current() == trace.get()) RequestTrace::attach(nullptr);
+
+        int64_t micros = trantor::Date::now().microSecondsSinceEpoch() -
+                         req->creationDate().microSecondsSinceEpoch();
+        resp->addHeader("Server-Timing", trace->serverTiming(micros));
+        resp->addHeader("X-Request-Id", trace->id());
+
+        int64_t slow = slowMicros();
+        if (!trace->sampled() && (slow == 0 || micros < slow)) return;
+        std::string route(req->getMatchedPathPattern());
+        if (route.empty()) route = "unmatched";
+        std::cout << trace->timeline(req->methodString(), route, static_cast<int>(resp->statusCode()), micros)
+                  << std::endl;
+    });
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+// Request-scoped spans (see RequestTrace) wired into drogon advice.
+//   - every response carries Server-Timing (filter, db, transform,
+//     serialize, app, total) and X-Request-Id; an incoming X-Request-Id is
+//     kept when it looks like an id, otherwise one is generated
+//   - TRACE_SAMPLE_RATE of requests (default 0.01) log their full span
+//     timeline as one JSON line; requests slower than TRACE_SLOW_MS
+//     (default 1000, 0 = off) log their phase totals whether sampled or not
+class RequestTracing {
+public:
+    // Call once before app().run()
+    static void install();
+};
@@ -0,0 +1,237 @@
+#include "ApplyBatcher.h"
+#include "IdHelper.h"
+#include "ApplicationStatus.h"
+#include "MongoService.h"
+#include "RollupService.h"
+#include "StatsService.h"
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/builder/basic/kvp.hpp>
+#include <mongocxx/exception/bulk_write_exception.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <iterator>
+#include <memory>
+#include <iostream>
+#include <map>
+#include <set>
+#include <utility>
+
+using bsoncxx::builder::basic::kvp;
+using bsoncxx::builder::basic::make_document;
+
+namespace {
+
+constexpr int32_t kDuplicateKey = 11000;
+
+long envOr(const char* name, long fallback) {
+    const char* env = std::getenv(name);
+    long value = env ? std::strtol(env, nullptr, 10) : 0;
+    return value > 0 ? value : fallback;
+}
+
+} // anonymous namespace
+
+std::set<std::pair<std::string, std::string>> ApplyBatcher::existingApplications(const std::vector<Pending>& batch) {
+    std::set<std::pair<std::string, std::string>> found;
+    // The unique index compares raw BSON, so it only catches a repeat when
+    // both rows store the same id type. In dual mode a pre-migration string
+    // row has to be found with an explicit read.
+    if (IdHelper::format() != IdHelper::Format::Dual) return found;
+
+    std::vector<std::string> students;
+    std::vector<std::string> drives;
+    for (const auto& p : batch) {
+        students.push_back(p.studentId);
+        drives.push_back(p.drive.id);
+    }
+
+    auto client = MongoService::instance().acquireClient();
+    auto applications = MongoService::instance().getCollection(client, "applications");
+    mongocxx::options::find opts;
+    opts.projection(make_document(kvp("_id", 0), kvp("student_id", 1), kvp("company_id", 1)));
+    auto cursor = applications.find(make_document(
+        kvp("student_id", make_document(kvp("$in", IdHelper::matchAny(students)))),
+        kvp("company_id", make_document(kvp("$in", IdHelper::matchAny(drives))))
+    ), opts);
+    for (auto& doc : cursor) {
+        found.emplace(IdHelper::str(doc["student_id"]), IdHelper::str(doc["company_id"]));
+    }
+    return found;
+}
+
+ApplyBatcher& ApplyBatcher::instance() {
+    static ApplyBatcher batcher;
+    return batcher;
+}
+
+ApplyBatcher::ApplyBatcher()
+    : maxBatch_(static_cast<size_t>(envOr("APPLY_BATCH_MAX", 500))),
+      maxWait_(envOr("APPLY_BATCH_WAIT_MS", 2)),
+      flusher_([this]() { run(); }) {}
+
+ApplyBatcher::~ApplyBatcher() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    if (flusher_.joinable()) flusher_.join();
+}
+
+void ApplyBatcher::submit(const std::string& studentId, const DriveCatalog::Drive& drive, Callback done) {
+    submitted_++;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_.push_back({studentId, drive, std::move(done)});
+    }
+    cv_.notify_one();
+}
+
+void ApplyBatcher::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        cv_.wait(lock, [this]() { return stopping_ || !pending_.empty(); });
+        if (pending_.empty()) return;
+
+        // Give concurrent applies a moment to join this batch
+        cv_.wait_for(lock, maxWait_, [this]() { return stopping_ || pending_.size() >= maxBatch_; });
+
+        std::vector<Pending> batch;
+        if (pending_.size() > maxBatch_) {
+            batch.assign(std::make_move_iterator(pending_.begin()),
+                         std::make_move_iterator(pending_.begin() + maxBatch_));
+            pending_.erase(pending_.begin(), pending_.begin() + maxBatch_);
+        } else {
+            batch.swap(pending_);
+        }
+
+        lock.unlock();
+        flush(batch);
+        lock.lock();
+    }
+}
+
+void ApplyBatcher::flush(std::vector<Pending>& batch) {
+    batches_++;
+    uint64_t size = batch.size();
+    uint64_t largest = largestBatch_.load();
+    while (size > largest && !largestBatch_.compare_exchange_weak(largest, size)) {}
+
+    std::vector<Outcome> outcomes(batch.size(), Outcome::Applied);
+    std::set<std::pair<std::string, std::string>> existing;
+    try {
+        existing = existingApplications(batch);
+    } catch (const std::exception& e) {
+        std::cerr << "Warning: Apply batch duplicate check failed: " << e.what() << std::endl;
+        std::fill(outcomes.begin(), outcomes.end(), Outcome::Failed);
+    }
+
+    auto now = bsoncxx::types::b_date{std::chrono::system_clock::now()};
+    std::vector<bsoncxx::document::value> docs;
+    // docs[i] belongs to batch[slots[i]]
+    std::vector<size_t> slots;
+    docs.reserve(batch.size());
+    for (size_t i = 0; i < batch.size(); ++i) {
+        const auto& p = batch[i];
+        if (outcomes[i] == Outcome::Failed) continue;
+        if (existing.count({p.studentId, p.drive.id})) {
+            outcomes[i] = Outcome::Duplicate;
+            continue;
+        }
+        slots.push_back(i);
+        docs.push_back(make_document(
+            kvp("student_id", IdHelper::ref(p.studentId).view()),
+            kvp("company_id", IdHelper::ref(p.drive.id).view()),
+            kvp("company_name", p.drive.companyName),
+            kvp("role", p.drive.role),
+            kvp("drive_date", p.drive.driveDate),
+            kvp("status", std::string(ApplicationStatus::name(AppStatus::Applied))),
+            kvp("applied_at", now)
+        ));
+    }
+
+    try {
+        if (!docs.empty()) {
+            auto client = MongoService::instance().acquireClient();
+            auto applications = MongoService::instance().getCollection(client, "applications");
+            mongocxx::options::insert opts;
+            opts.ordered(false);
+            applications.insert_many(docs, opts);
+        }
+    } catch (const mongocxx::bulk_write_exception& e) {
+        // Unordered: every document without a write error was inserted
+        bool attributed = false;
+        if (e.raw_server_error()) {
+            auto writeErrors = e.raw_server_error()->view()["writeErrors"];
+            if (writeErrors && writeErrors.type() == bsoncxx::type::k_array) {
+                attributed = true;
+                for (auto& err : writeErrors.get_array().value) {
+                    auto index = static_cast<size_t>(err["index"].get_int32().value);
+                    if (index >= slots.size()) continue;
+                    outcomes[slots[index]] = err["code"].get_int32().value == kDuplicateKey
+                        ? Outcome::Duplicate : Outcome::Failed;
+                }
+            }
+        }
+        if (!attributed) {
+            std::cerr << "Warning: Apply batch failed: " << e.what() << std::endl;
+            for (size_t slot : slots) outcomes[slot] = Outcome::Failed;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Warning: Apply batch failed: " << e.what() << std::endl;
+        for (size_t slot : slots) outcomes[slot] = Outcome::Failed;
+    }
+
+    std::map<std::string, int64_t> perDrive;
+    std::vector<std::string> appliedStudents;
+    auto notifications = std::make_shared<std::vector<bsoncxx::document::value>>();
+    for (size_t i = 0; i < batch.size(); ++i) {
+        auto& p = batch[i];
+        switch (outcomes[i]) {
+            case Outcome::Applied:
+                applied_++;
+                perDrive[p.drive.id] += 1;
+                appliedStudents.push_back(p.studentId);
+                notifications->push_back(make_document(
+                    kvp("user_id", IdHelper::ref(p.studentId).view()),
+                    kvp("message", "You have applied to " + p.drive.companyName),
+                    kvp("type", "application"),
+                    kvp("read", false),
+                    kvp("created_at", now)
+                ));
+                break;
+            case Outcome::Duplicate: duplicates_++; break;
+            case Outcome::Failed: failed_++; break;
+        }
+        p.done(outcomes[i]);
+    }
+
+    if (appliedStudents.empty()) return;
+    effects_.post([perDrive, appliedStudents, notifications]() {
+        StatsService::instance().onApplicationsCreated(perDrive);
+        RollupService::recordMany(appliedStudents, std::string(ApplicationStatus::name(AppStatus::Applied)));
+
+        auto client = MongoService::instance().acquireClient();
+        auto coll = MongoService::instance().getCollection(client, "notifications");
+        mongocxx::options::insert opts;
+        opts.ordered(false);
+        coll.insert_many(*notifications, opts);
+    });
+}
+
+Json::Value ApplyBatcher::stats() const {
+    Json::Value result;
+    result["success"] = true;
+    result["submitted"] = static_cast<Json::UInt64>(submitted_.load());
+    result["batches"] = static_cast<Json::UInt64>(batches_.load());
+    result["applied"] = static_cast<Json::UInt64>(applied_.load());
+    result["duplicates"] = static_cast<Json::UInt64>(duplicates_.load());
+    result["failed"] = static_cast<Json::UInt64>(failed_.load());
+    result["largest_batch"] = static_cast<Json::UInt64>(largestBatch_.load());
+    uint64_t batches = batches_.load();
+    uint64_t completed = applied_.load() + duplicates_.load() + failed_.load();
+    result["avg_batch"] = batches ? static_cast<double>(completed) / batches : 0.0;
+    result["max_batch"] = static_cast<Json::UInt64>(maxBatch_);
+    result["max_wait_ms"] = static_cast<Json::Int64>(maxWait_.count());
+    return result;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "DriveCatalog.h"
+#include "WorkQueue.h"
+#include <json/json.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Coalesces concurrent drive applications into unordered insert_many batches.
+// Duplicates are rejected by the unique {student_id, company_id} index rather
+// than a pre-check read, except with ID_FORMAT=dual (see
+// existingApplications); each caller is completed with its own outcome.
+class ApplyBatcher {
+public:
+    enum class Outcome { Applied, Duplicate, Failed };
+    using Callback = std::function<void(Outcome)>;
+
+    static ApplyBatcher& instance();
+
+    void submit(const std::string& studentId, const DriveCatalog::Drive& drive, Callback done);
+
+    Json::Value stats() const;
+
+private:
+    struct Pending {
+        std::string studentId;
+        DriveCatalog::Drive drive;
+        Callback done;
+    };
+
+    ApplyBatcher();
+    ~ApplyBatcher();
+    ApplyBatcher(const ApplyBatcher&) = delete;
+    ApplyBatcher& operator=(const ApplyBatcher&) = delete;
+
+    void run();
+    void flush(std::vector<Pending>& batch);
+    // {student, drive} pairs in the batch that already have an application
+    // stored under either id type; empty outside ID_FORMAT=dual
+    static std::set<std::pair<std::string, std::string>> existingApplications(const std::vector<Pending>& batch);
+
+    size_t maxBatch_;
+    std::chrono::milliseconds maxWait_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::vector<Pending> pending_;
+    bool stopping_ = false;
+
+    std::atomic<uint64_t> submitted_{0};
+    std::atomic<uint64_t> batches_{0};
+    std::atomic<uint64_t> applied_{0};
+    std::atomic<uint64_t> duplicates_{0};
+    std::atomic<uint64_t> failed_{0};
+    std::atomic<uint64_t> largestBatch_{0};
+
+    // Counters, rollups and notifications for flushed batches
+    WorkQueue effects_{"apply-effects", 1};
+
+    // Started last so every member above is initialised first
+    std::thread flusher_;
+};
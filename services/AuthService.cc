@@ -1,9 +1,13 @@
 #include "AuthService.h"
+#include "IdHelper.h"
 #include "MongoService.h"
 #include "BcryptHelper.h"
 #include "JwtHelper.h"
 #include "JsonHelper.h"
 #include "PlacementService.h"
+#include "StudentIndexService.h"
+#include "SearchService.h"
+#include "StatsService.h"
 #include <bsoncxx/builder/basic/document.hpp>
 #include <bsoncxx/builder/basic/kvp.hpp>
 #include <bsoncxx/oid.hpp>
@@ -75,7 +79,7 @@ Json::Value AuthService::registerUser(const Json::Value& body) {
     // Create student profile with department and roll_number
     auto students = MongoService::instance().getCollection(client, "students");
     auto studentDoc = make_document(
-        kvp("user_id", userId),
+        kvp("user_id", IdHelper::ref(userId).view()),
         kvp("name", name),
         kvp("department", department),
         kvp("roll_number", rollNumber),
@@ -90,6 +94,9 @@ Json::Value AuthService::registerUser(const Json::Value& body) {
         kvp("created_at", now)
     );
     students.insert_one(studentDoc.view());
+    StudentIndexService::instance().upsert(studentDoc.view(), false);
+    SearchService::instance().indexStudent(userId, name, email, rollNumber, department);
+    StatsService::instance().onStudentRegistered(department);
 
     // Create notification for TPO about new pending registration
     // Find TPO user(s)
@@ -203,9 +210,8 @@ Json::Value AuthService::getUserById(const std::string& userId) {
         Json::Value drives(Json::arrayValue);
         auto arr = userDoc["assigned_drives"].get_array().value;
         for (auto& driveId : arr) {
-            if (driveId.type() == bsoncxx::type::k_string) {
-                drives.append(std::string(driveId.get_string().value));
-            }
+            std::string hex = IdHelper::str(driveId);
+            if (!hex.empty()) drives.append(hex);
         }
         result["user"]["assigned_drives"] = drives;
     }
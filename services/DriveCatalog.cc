@@ -0,0 +1,198 @@
+#include "DriveCatalog.h"
+#include "MongoService.h"
+#include "IdHelper.h"
+#include "WorkQueue.h"
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/builder/basic/kvp.hpp>
+#include <bsoncxx/oid.hpp>
+#include <iostream>
+#include <memory>
+#include <mutex>
+
+using bsoncxx::builder::basic::kvp;
+using bsoncxx::builder::basic::make_document;
+
+namespace {
+
+std::string stringOf(const bsoncxx::document::element& el) {
+    if (!el || el.type() != bsoncxx::type::k_string) return "";
+    return std::string(el.get_string().value);
+}
+
+double numberOf(const bsoncxx::document::element& el) {
+    if (!el) return 0.0;
+    switch (el.type()) {
+        case bsoncxx::type::k_double: return el.get_double().value;
+        case bsoncxx::type::k_int32: return el.get_int32().value;
+        case bsoncxx::type::k_int64: return static_cast<double>(el.get_int64().value);
+        default: return 0.0;
+    }
+}
+
+DriveCatalog::Drive fromDoc(const bsoncxx::document::view& doc) {
+    DriveCatalog::Drive drive;
+    drive.id = doc["_id"].get_oid().value.to_string();
+    drive.companyName = stringOf(doc["company_name"]);
+    drive.role = stringOf(doc["role"]);
+    drive.driveDate = stringOf(doc["drive_date"]);
+    drive.minGpa = numberOf(doc["min_gpa"]);
+    drive.allowedBacklogs = static_cast<int>(numberOf(doc["allowed_backlogs"]));
+    return drive;
+}
+
+mongocxx::options::find catalogProjection() {
+    mongocxx::options::find opts;
+    opts.projection(make_document(
+        kvp("company_name", 1), kvp("role", 1), kvp("drive_date", 1),
+        kvp("min_gpa", 1), kvp("allowed_backlogs", 1)));
+    return opts;
+}
+
+// Fields copied onto applications and interviews at write time
+constexpr const char* kDenormalized[] = {"company_name", "role", "drive_date"};
+
+WorkQueue& propagationQueue() {
+    static WorkQueue queue("drive-propagation", 1);
+    return queue;
+}
+
+} // anonymous namespace
+
+DriveCatalog& DriveCatalog::instance() {
+    static DriveCatalog catalog;
+    return catalog;
+}
+
+void DriveCatalog::load() {
+    try {
+        std::unordered_map<std::string, Drive> loaded;
+        {
+            auto client = MongoService::instance().acquireClient();
+            auto companies = MongoService::instance().getCollection(client, "companies");
+            for (auto& doc : companies.find({}, catalogProjection())) {
+                auto drive = fromDoc(doc);
+                loaded.emplace(drive.id, std::move(drive));
+            }
+        }
+
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        drives_ = std::move(loaded);
+        std::cout << "Drive catalog loaded: " << drives_.size() << " drives" << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Warning: Drive catalog load: " << e.what() << std::endl;
+        throw;
+    }
+}
+
+void DriveCatalog::put(const Drive& drive) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    drives_[drive.id] = drive;
+}
+
+void DriveCatalog::update(const std::string& id, const Json::Value& changes) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto it = drives_.find(id);
+    if (it == drives_.end()) return;
+    auto& drive = it->second;
+    if (changes.isMember("company_name")) drive.companyName = changes["company_name"].asString();
+    if (changes.isMember("role")) drive.role = changes["role"].asString();
+    if (changes.isMember("drive_date")) drive.driveDate = changes["drive_date"].asString();
+    if (changes.isMember("min_gpa")) drive.minGpa = changes["min_gpa"].asDouble();
+    if (changes.isMember("allowed_backlogs")) drive.allowedBacklogs = changes["allowed_backlogs"].asInt();
+}
+
+void DriveCatalog::propagate(const std::string& id, const Json::Value& changes) {
+    bsoncxx::builder::basic::document setDoc;
+    bool changed = false;
+    for (const char* field : kDenormalized) {
+        if (!changes.isMember(field)) continue;
+        setDoc.append(kvp(field, changes[field].asString()));
+        changed = true;
+    }
+    if (!changed) return;
+
+    auto fields = setDoc.extract();
+    auto set = std::make_shared<bsoncxx::document::value>(make_document(kvp("$set", fields.view())));
+    propagationQueue().post([id, set]() {
+        try {
+            auto client = MongoService::instance().acquireClient();
+            auto filter = make_document(kvp("company_id", IdHelper::match(id).view()));
+            int64_t updated = 0;
+            for (const char* name : {"applications", "interviews"}) {
+                auto coll = MongoService::instance().getCollection(client, name);
+                auto result = coll.update_many(filter.view(), set->view());
+                if (result) updated += result->modified_count();
+            }
+            std::cout << "Drive " << id << " changes copied to " << updated << " documents" << std::endl;
+        } catch (const std::exception& e) {
+            std::cerr << "Warning: Drive change propagation for " << id << ": " << e.what() << std::endl;
+        }
+    });
+}
+
+void DriveCatalog::remove(const std::string& id) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    drives_.erase(id);
+}
+
+std::optional<DriveCatalog::Drive> DriveCatalog::find(const std::string& id) {
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        auto it = drives_.find(id);
+        if (it != drives_.end()) return it->second;
+    }
+
+    try {
+        auto client = MongoService::instance().acquireClient();
+        auto companies = MongoService::instance().getCollection(client, "companies");
+        auto doc = companies.find_one(make_document(kvp("_id", bsoncxx::oid{id})), catalogProjection());
+        if (!doc) return std::nullopt;
+        auto drive = fromDoc(doc->view());
+        put(drive);
+        return drive;
+    } catch (const std::exception&) {
+        // Malformed id or Mongo unavailable
+        return std::nullopt;
+    }
+}
+
+std::string DriveCatalog::companyName(const std::string& id) {
+    auto drive = find(id);
+    return drive && !drive->companyName.empty() ? drive->companyName : "a company";
+}
+
+Json::Value DriveCatalog::companyJson(const bsoncxx::document::view& doc) {
+    std::string id = IdHelper::str(doc["company_id"]);
+    auto drive = find(id);
+
+    // The stored copy can be stale: an apply or interview queued before a
+    // rename may be written after propagate() ran, so the catalog wins
+    Json::Value company;
+    if (drive) {
+        company["company_name"] = drive->companyName;
+        company["role"] = drive->role;
+        company["drive_date"] = drive->driveDate;
+    } else if (doc["company_name"] && doc["company_name"].type() == bsoncxx::type::k_string) {
+        company["company_name"] = stringOf(doc["company_name"]);
+        company["role"] = stringOf(doc["role"]);
+        company["drive_date"] = stringOf(doc["drive_date"]);
+    } else {
+        return Json::Value();
+    }
+    if (drive) {
+        company["min_gpa"] = drive->minGpa;
+        company["allowed_backlogs"] = drive->allowedBacklogs;
+    }
+    company["id"] = id;
+    return company;
+}
+
+void DriveCatalog::attachCompany(Json::Value& target, const bsoncxx::document::view& doc) {
+    Json::Value company = companyJson(doc);
+    if (company.isNull()) return;
+    // Keep the denormalized top-level copies in step with the company block
+    for (const char* field : {"company_name", "role", "drive_date"}) {
+        if (target.isMember(field)) target[field] = company[field];
+    }
+    target["company"] = company;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <bsoncxx/document/view.hpp>
+#include <json/json.h>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+// In-memory copy of the company drives that request hot paths consult
+// instead of reading the companies collection on every call.
+class DriveCatalog {
+public:
+    struct Drive {
+        std::string id;
+        std::string companyName;
+        std::string role;
+        std::string driveDate;
+        double minGpa = 0.0;
+        int allowedBacklogs = 0;
+    };
+
+    static DriveCatalog& instance();
+
+    // Logs and rethrows on failure so the startup step stays failed
+    void load();
+
+    void put(const Drive& drive);
+    // Apply the fields accepted by CompanyController::updateCompany
+    void update(const std::string& id, const Json::Value& changes);
+    // Copy renamed company_name / role / drive_date onto the drive's
+    // applications and interviews in the background
+    void propagate(const std::string& id, const Json::Value& changes);
+    void remove(const std::string& id);
+
+    // Falls back to Mongo on a miss, so drives created by another instance are found
+    std::optional<Drive> find(const std::string& id);
+    // "a company" when the drive is unknown
+    std::string companyName(const std::string& id);
+
+    // Company block for an application or interview: the catalog entry, or
+    // the company_name, role and drive_date stored on the document when the
+    // drive is no longer in the catalog. Null when neither is available.
+    Json::Value companyJson(const bsoncxx::document::view& doc);
+    // Sets target["company"] from companyJson and refreshes the stored
+    // company_name, role and drive_date copies already in target
+    void attachCompany(Json::Value& target, const bsoncxx::document::view& doc);
+
+private:
+    DriveCatalog() = default;
+    DriveCatalog(const DriveCatalog&) = delete;
+    DriveCatalog& operator=(const DriveCatalog&) = delete;
+
+    mutable std::shared_mutex mutex_;
+    std::unordered_map<std::string, Drive> drives_;
+};
@@ -0,0 +1,238 @@
+#include "DrivePublishService.h"
+#include "IdHelper.h"
+#include "MongoService.h"
+#include "JsonHelper.h"
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/builder/basic/kvp.hpp>
+#include <bsoncxx/builder/basic/array.hpp>
+#include <bsoncxx/oid.hpp>
+#include <mongocxx/pipeline.hpp>
+#include <chrono>
+#include <iostream>
+#include <iterator>
+#include <vector>
+
+using bsoncxx::builder::basic::kvp;
+using bsoncxx::builder::basic::make_document;
+using bsoncxx::builder::basic::make_array;
+
+namespace {
+
+// 3412 -> "3,412"
+std::string withThousands(int64_t n) {
+    std::string digits = std::to_string(n);
+    std::string out;
+    int count = 0;
+    for (auto it = digits.rbegin(); it != digits.rend(); ++it) {
+        if (count > 0 && count % 3 == 0 && *it != '-') out.insert(out.begin(), ',');
+        out.insert(out.begin(), *it);
+        ++count;
+    }
+    return out;
+}
+
+} // anonymous namespace
+
+DrivePublishService& DrivePublishService::instance() {
+    static DrivePublishService svc;
+    return svc;
+}
+
+void DrivePublishService::publish(const Drive& drive) {
+    Progress queued;
+    queued.state = "queued";
+    setProgress(drive.id, queued);
+
+    worker_.post([this, drive]() { run(drive); });
+}
+
+void DrivePublishService::setProgress(const std::string& companyId, const Progress& progress) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (progress_.size() >= kMaxTracked && progress_.find(companyId) == progress_.end()) {
+        for (auto it = progress_.begin(); it != progress_.end();) {
+            bool finished = it->second.state == "done" || it->second.state == "failed";
+            it = finished ? progress_.erase(it) : std::next(it);
+        }
+    }
+    progress_[companyId] = progress;
+}
+
+void DrivePublishService::persist(const std::string& companyId, const Progress& progress) {
+    auto client = MongoService::instance().acquireClient();
+    auto companies = MongoService::instance().getCollection(client, "companies");
+    bsoncxx::builder::basic::document publish;
+    publish.append(kvp("state", progress.state),
+                   kvp("eligible", progress.eligible),
+                   kvp("notified", progress.notified),
+                   kvp("completed_at", bsoncxx::types::b_date{std::chrono::system_clock::now()}));
+    if (!progress.error.empty()) publish.append(kvp("error", progress.error));
+    companies.update_one(
+        make_document(kvp("_id", bsoncxx::oid{companyId})),
+        make_document(kvp("$set", make_document(kvp("publish", publish.extract()))))
+    );
+}
+
+void DrivePublishService::forget(const std::string& companyId) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    progress_.erase(companyId);
+}
+
+void DrivePublishService::run(const Drive& drive) {
+    Progress progress;
+    progress.state = "running";
+    setProgress(drive.id, progress);
+
+    auto started = std::chrono::steady_clock::now();
+
+    try {
+        auto client = MongoService::instance().acquireClient();
+        auto students = MongoService::instance().getCollection(client, "students");
+        auto notifications = MongoService::instance().getCollection(client, "notifications");
+
+        // Eligible + active students in one aggregation. user_id may still be a
+        // hex string (see IdHelper), so convert it before joining against users._id.
+        mongocxx::pipeline pipe;
+        pipe.match(make_document(
+            kvp("gpa", make_document(kvp("$gte", drive.minGpa))),
+            kvp("backlogs", make_document(kvp("$lte", drive.allowedBacklogs)))
+        ));
+        pipe.lookup(make_document(
+            kvp("from", "users"),
+            kvp("let", make_document(kvp("uid", make_document(kvp("$convert", make_document(
+                kvp("input", "$user_id"),
+                kvp("to", "objectId"),
+                kvp("onError", bsoncxx::types::b_null{}),
+                kvp("onNull", bsoncxx::types::b_null{})
+            )))))),
+            kvp("pipeline", make_array(
+                make_document(kvp("$match", make_document(
+                    kvp("$expr", make_document(kvp("$eq", make_array("$_id", "$$uid"))))
+                ))),
+                make_document(kvp("$project", make_document(kvp("status", 1))))
+            )),
+            kvp("as", "user")
+        ));
+        // Accounts without a status field are treated as active elsewhere too
+        pipe.match(make_document(
+            kvp("user", make_document(kvp("$ne", make_array()))),
+            kvp("user.status", make_document(kvp("$nin", make_array("pending_approval", "rejected"))))
+        ));
+        pipe.project(make_document(kvp("_id", 0), kvp("user_id", 1)));
+
+        std::vector<std::string> userIds;
+        auto cursor = students.aggregate(pipe);
+        for (auto& doc : cursor) {
+            std::string userId = IdHelper::str(doc["user_id"]);
+            if (!userId.empty()) userIds.push_back(std::move(userId));
+        }
+
+        progress.eligible = static_cast<int64_t>(userIds.size());
+        setProgress(drive.id, progress);
+
+        std::string message = "New drive: " + drive.companyName + " is hiring for " + drive.role;
+        if (!drive.driveDate.empty()) {
+            message += " on " + drive.driveDate;
+        }
+        message += ". You are eligible to apply.";
+
+        mongocxx::options::insert opts;
+        opts.ordered(false);
+
+        std::vector<bsoncxx::document::value> chunk;
+        chunk.reserve(kChunkSize);
+        auto flush = [&]() {
+            if (chunk.empty()) return;
+            notifications.insert_many(chunk, opts);
+            progress.notified += static_cast<int64_t>(chunk.size());
+            chunk.clear();
+            setProgress(drive.id, progress);
+        };
+
+        auto now = bsoncxx::types::b_date{std::chrono::system_clock::now()};
+        for (const auto& userId : userIds) {
+            chunk.push_back(make_document(
+                kvp("user_id", IdHelper::ref(userId).view()),
+                kvp("message", message),
+                kvp("type", "drive"),
+                kvp("company_id", IdHelper::ref(drive.id).view()),
+                kvp("read", false),
+                kvp("created_at", now)
+            ));
+            if (chunk.size() >= kChunkSize) flush();
+        }
+        flush();
+
+        progress.state = "done";
+        setProgress(drive.id, progress);
+
+        // Persist the outcome so it survives restarts and other instances see
+        // it; from then on getProgress reads it from there
+        persist(drive.id, progress);
+        forget(drive.id);
+
+        auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - started).count();
+        std::cout << "Drive " << drive.id << " published: notified " << progress.notified
+                  << " students in " << elapsedMs << "ms" << std::endl;
+
+    } catch (const std::exception& e) {
+        progress.state = "failed";
+        progress.error = e.what();
+        setProgress(drive.id, progress);
+        std::cerr << "Warning: Drive publish " << drive.id << ": " << e.what() << std::endl;
+        // Kept in memory only if the failure cannot be stored either
+        try {
+            persist(drive.id, progress);
+            forget(drive.id);
+        } catch (const std::exception& persistError) {
+            std::cerr << "Warning: Drive publish " << drive.id << " outcome not saved: "
+                      << persistError.what() << std::endl;
+        }
+    }
+}
+
+Json::Value DrivePublishService::getProgress(const std::string& companyId) {
+    Json::Value result;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = progress_.find(companyId);
+        if (it != progress_.end()) {
+            const auto& p = it->second;
+            result["success"] = true;
+            result["publish"]["state"] = p.state;
+            result["publish"]["eligible"] = static_cast<Json::Int64>(p.eligible);
+            result["publish"]["notified"] = static_cast<Json::Int64>(p.notified);
+            result["publish"]["message"] = "notified " + withThousands(p.notified) + " students";
+            if (!p.error.empty()) {
+                result["publish"]["error"] = p.error;
+            }
+            return result;
+        }
+    }
+
+    // Not published by this process; fall back to the persisted outcome
+    auto client = MongoService::instance().acquireClient();
+    auto companies = MongoService::instance().getCollection(client, "companies");
+    auto companyOpt = companies.find_one(make_document(kvp("_id", bsoncxx::oid{companyId})));
+    if (!companyOpt) {
+        return JsonHelper::errorResponse("Company drive not found");
+    }
+
+    auto doc = companyOpt->view();
+    result["success"] = true;
+    if (doc.find("publish") != doc.end() && doc["publish"].type() == bsoncxx::type::k_document) {
+        auto publish = doc["publish"].get_document().value;
+        int64_t notified = publish["notified"].get_int64().value;
+        result["publish"]["state"] = std::string(publish["state"].get_string().value);
+        result["publish"]["eligible"] = static_cast<Json::Int64>(publish["eligible"].get_int64().value);
+        result["publish"]["notified"] = static_cast<Json::Int64>(notified);
+        result["publish"]["message"] = "notified " + withThousands(notified) + " students";
+        if (publish["error"] && publish["error"].type() == bsoncxx::type::k_string) {
+            result["publish"]["error"] = std::string(publish["error"].get_string().value);
+        }
+    } else {
+        result["publish"]["state"] = "unknown";
+    }
+    return result;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "WorkQueue.h"
+#include <json/json.h>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+
+// Fans a "new drive" notification out to every eligible, active student.
+// Runs on a background worker so drive creation returns immediately.
+class DrivePublishService {
+public:
+    struct Drive {
+        std::string id;
+        std::string companyName;
+        std::string role;
+        std::string driveDate;
+        double minGpa = 0.0;
+        int allowedBacklogs = 0;
+    };
+
+    static DrivePublishService& instance();
+
+    void publish(const Drive& drive);
+    Json::Value getProgress(const std::string& companyId);
+
+private:
+    struct Progress {
+        std::string state;          // queued | running | done | failed
+        int64_t eligible = 0;
+        int64_t notified = 0;
+        std::string error;
+    };
+
+    static constexpr size_t kChunkSize = 500;
+    // Finished outcomes kept in memory only when they could not be persisted;
+    // beyond this many they are dropped
+    static constexpr size_t kMaxTracked = 1024;
+
+    DrivePublishService() : worker_("drive-publish", 1) {}
+    DrivePublishService(const DrivePublishService&) = delete;
+    DrivePublishService& operator=(const DrivePublishService&) = delete;
+
+    void run(const Drive& drive);
+    void setProgress(const std::string& companyId, const Progress& progress);
+    // Stores a finished outcome on the drive; getProgress falls back to it
+    void persist(const std::string& companyId, const Progress& progress);
+    void forget(const std::string& companyId);
+
+    std::mutex mutex_;
+    // Drives queued or publishing in this process
+    std::map<std::string, Progress> progress_;
+    WorkQueue worker_;
+};
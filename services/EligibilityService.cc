@@ -1,4 +1,5 @@
 #include "EligibilityService.h"
+#include "IdHelper.h"
 #include "MongoService.h"
 #include "JsonHelper.h"
 #include <bsoncxx/builder/basic/document.hpp>
@@ -16,7 +17,7 @@ Json::Value EligibilityService::getEligibleDrives(const std::string& studentId)
 
     auto client = MongoService::instance().acquireClient();
     auto students = MongoService::instance().getCollection(client, "students");
-    auto studentOpt = students.find_one(make_document(kvp("user_id", studentId)));
+    auto studentOpt = students.find_one(make_document(kvp("user_id", IdHelper::match(studentId).view())));
 
     if (!studentOpt) {
         return JsonHelper::errorResponse("Student profile not found");
@@ -38,10 +39,10 @@ Json::Value EligibilityService::getEligibleDrives(const std::string& studentId)
     // Get already applied companies
     auto applications = MongoService::instance().getCollection(client, "applications");
     std::set<std::string> appliedCompanies;
-    auto appCursor = applications.find(make_document(kvp("student_id", studentId)));
+    auto appCursor = applications.find(make_document(kvp("student_id", IdHelper::match(studentId).view())));
     for (auto& app : appCursor) {
         appliedCompanies.insert(
-            std::string(app["company_id"].get_string().value));
+            IdHelper::str(app["company_id"]));
     }
 
     Json::Value drives(Json::arrayValue);
@@ -104,7 +105,7 @@ Json::Value EligibilityService::getRecommendedDrives(const std::string& studentI
 
     auto client = MongoService::instance().acquireClient();
     auto students = MongoService::instance().getCollection(client, "students");
-    auto studentOpt = students.find_one(make_document(kvp("user_id", studentId)));
+    auto studentOpt = students.find_one(make_document(kvp("user_id", IdHelper::match(studentId).view())));
 
     if (!studentOpt) {
         return JsonHelper::errorResponse("Student profile not found");
@@ -178,7 +179,7 @@ Json::Value EligibilityService::getEligibleStudents(const std::string& companyId
     for (auto& doc : cursor) {
         // Only include students whose user account is active
         if (doc.find("user_id") != doc.end()) {
-            std::string userId = std::string(doc["user_id"].get_string().value);
+            std::string userId = IdHelper::str(doc["user_id"]);
             try {
                 auto userOpt = users.find_one(
                     make_document(kvp("_id", bsoncxx::oid{userId}))
@@ -197,7 +198,7 @@ Json::Value EligibilityService::getEligibleStudents(const std::string& companyId
 
         Json::Value student = JsonHelper::bsonToJson(doc);
         if (doc.find("user_id") != doc.end()) {
-            student["id"] = std::string(doc["user_id"].get_string().value);
+            student["id"] = IdHelper::str(doc["user_id"]);
         }
         studentsList.append(student);
     }
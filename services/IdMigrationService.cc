@@ -0,0 +1,335 @@
+#include "IdMigrationService.h"
+#include "IdHelper.h"
+#include "MongoService.h"
+#include "JsonHelper.h"
+#include <bsoncxx/builder/basic/array.hpp>
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/builder/basic/kvp.hpp>
+#include <bsoncxx/oid.hpp>
+#include <bsoncxx/types.hpp>
+#include <mongocxx/exception/bulk_write_exception.hpp>
+#include <mongocxx/model/update_one.hpp>
+#include <mongocxx/model/write.hpp>
+#include <mongocxx/options/replace.hpp>
+#include <mongocxx/pipeline.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <optional>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using bsoncxx::builder::basic::kvp;
+using bsoncxx::builder::basic::make_document;
+
+namespace {
+
+constexpr int32_t kDuplicateKey = 11000;
+// Row ids listed per field in the report; the count keeps going
+constexpr Json::ArrayIndex kMaxReportedDuplicates = 50;
+
+struct Target {
+    const char* collection;
+    const char* field;
+    bool isArray;
+};
+
+const Target kTargets[] = {
+    {"students", "user_id", false},
+    {"applications", "student_id", false},
+    {"applications", "company_id", false},
+    {"interviews", "student_id", false},
+    {"interviews", "company_id", false},
+    {"notifications", "user_id", false},
+    {"companies", "recruiter_id", false},
+    {"companies", "created_by", false},
+    {"users", "assigned_drives", true},
+};
+
+const char* const kMeasured[] = {"students", "applications", "interviews", "notifications", "companies", "users"};
+
+constexpr size_t kLatencySamples = 200;
+
+size_t batchSize() {
+    const char* env = std::getenv("ID_MIGRATION_BATCH");
+    long n = env ? std::strtol(env, nullptr, 10) : 0;
+    return n > 0 ? static_cast<size_t>(n) : 1000;
+}
+
+std::string nowIso() {
+    std::time_t t = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+    std::tm tm{};
+    gmtime_r(&t, &tm);
+    char buf[32];
+    std::strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%SZ", &tm);
+    return buf;
+}
+
+} // anonymous namespace
+
+IdMigrationService& IdMigrationService::instance() {
+    static IdMigrationService svc;
+    return svc;
+}
+
+void IdMigrationService::update(const std::function<void(Json::Value&)>& fn) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    fn(state_);
+}
+
+bool IdMigrationService::start() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (running_) return false;
+        running_ = true;
+        state_ = Json::Value(Json::objectValue);
+        state_["state"] = "queued";
+        state_["id_format"] = IdHelper::formatName();
+        state_["started_at"] = nowIso();
+    }
+    worker_.post([this]() { run(); });
+    return true;
+}
+
+Json::Value IdMigrationService::status() {
+    Json::Value result;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        result = state_;
+    }
+    if (result.empty()) {
+        // Nothing run since this process started; show the last persisted report
+        try {
+            auto client = MongoService::instance().acquireClient();
+            auto maintenance = MongoService::instance().getCollection(client, "maintenance");
+            auto doc = maintenance.find_one(make_document(kvp("_id", "id-migration")));
+            if (doc) result = JsonHelper::parse(bsoncxx::to_json(doc->view()["report"].get_document().value));
+        } catch (const std::exception& e) {
+            std::cerr << "Warning: ID migration status: " << e.what() << std::endl;
+        }
+    }
+    if (result.empty()) result["state"] = "never_run";
+    result["success"] = true;
+    result["id_format"] = IdHelper::formatName();
+    return result;
+}
+
+Json::Value IdMigrationService::measure() {
+    Json::Value out;
+    auto client = MongoService::instance().acquireClient();
+    auto db = MongoService::instance().getDb(client);
+
+    int64_t totalIndexBytes = 0;
+    for (const char* name : kMeasured) {
+        auto stats = db.run_command(make_document(kvp("collStats", name)));
+        auto view = stats.view();
+        Json::Value coll;
+        if (view["totalIndexSize"]) {
+            auto el = view["totalIndexSize"];
+            int64_t size = el.type() == bsoncxx::type::k_int32 ? el.get_int32().value
+                         : el.type() == bsoncxx::type::k_int64 ? el.get_int64().value
+                         : static_cast<int64_t>(el.get_double().value);
+            coll["total_index_bytes"] = static_cast<Json::Int64>(size);
+            totalIndexBytes += size;
+        }
+        if (view["indexSizes"] && view["indexSizes"].type() == bsoncxx::type::k_document) {
+            for (auto& idx : view["indexSizes"].get_document().value) {
+                int64_t size = idx.type() == bsoncxx::type::k_int32 ? idx.get_int32().value
+                             : idx.type() == bsoncxx::type::k_int64 ? idx.get_int64().value
+                             : static_cast<int64_t>(idx.get_double().value);
+                coll["indexes"][std::string(idx.key())] = static_cast<Json::Int64>(size);
+            }
+        }
+        out["collections"][name] = coll;
+    }
+    out["total_index_bytes"] = static_cast<Json::Int64>(totalIndexBytes);
+
+    // Lookup latency: applications by student reference, on a random sample
+    auto applications = MongoService::instance().getCollection(client, "applications");
+    mongocxx::pipeline sample;
+    sample.sample(kLatencySamples);
+    sample.project(make_document(kvp("_id", 0), kvp("student_id", 1)));
+    std::vector<std::string> ids;
+    for (auto& doc : applications.aggregate(sample)) {
+        std::string id = IdHelper::str(doc["student_id"]);
+        if (!id.empty()) ids.push_back(id);
+    }
+
+    std::vector<int64_t> micros;
+    mongocxx::options::find opts;
+    opts.projection(make_document(kvp("_id", 1)));
+    for (const auto& id : ids) {
+        auto started = std::chrono::steady_clock::now();
+        applications.find_one(make_document(kvp("student_id", IdHelper::match(id).view())), opts);
+        micros.push_back(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - started).count());
+    }
+    if (!micros.empty()) {
+        std::sort(micros.begin(), micros.end());
+        int64_t sum = 0;
+        for (auto us : micros) sum += us;
+        out["lookup"]["samples"] = static_cast<Json::UInt64>(micros.size());
+        out["lookup"]["avg_us"] = static_cast<Json::Int64>(sum / static_cast<int64_t>(micros.size()));
+        out["lookup"]["p95_us"] = static_cast<Json::Int64>(micros[micros.size() * 95 / 100]);
+    }
+    out["id_format"] = IdHelper::formatName();
+    return out;
+}
+
+void IdMigrationService::run() {
+    update([](Json::Value& s) { s["state"] = "running"; });
+
+    try {
+        Json::Value before = measure();
+        update([&before](Json::Value& s) { s["before"] = before; });
+
+        size_t limit = batchSize();
+        for (const auto& target : kTargets) {
+            std::string key = std::string(target.collection) + "." + target.field;
+            int64_t converted = 0;
+            int64_t skipped = 0;
+            // Rows whose converted value collides with a unique index (an
+            // application repeated under both id types); left as strings
+            int64_t duplicates = 0;
+            Json::Value duplicateIds(Json::arrayValue);
+
+            auto client = MongoService::instance().acquireClient();
+            auto coll = MongoService::instance().getCollection(client, target.collection);
+
+            // Page by _id so rows that cannot be converted are not revisited
+            std::optional<bsoncxx::oid> last;
+            while (true) {
+                bsoncxx::builder::basic::document filter;
+                filter.append(kvp(target.field, make_document(kvp("$type", "string"))));
+                if (last) filter.append(kvp("_id", make_document(kvp("$gt", *last))));
+
+                mongocxx::options::find opts;
+                opts.sort(make_document(kvp("_id", 1)));
+                opts.limit(static_cast<int64_t>(limit));
+                opts.projection(make_document(kvp(target.field, 1)));
+
+                std::vector<mongocxx::model::write> writes;
+                // writes[i] rewrites row writeIds[i]
+                std::vector<bsoncxx::oid> writeIds;
+                size_t seen = 0;
+                for (auto& doc : coll.find(filter.view(), opts)) {
+                    ++seen;
+                    last = doc["_id"].get_oid().value;
+                    auto value = doc[target.field];
+
+                    if (target.isArray) {
+                        if (value.type() != bsoncxx::type::k_array) { ++skipped; continue; }
+                        std::vector<std::string> refs;
+                        bool ok = true;
+                        for (auto& el : value.get_array().value) {
+                            std::string hex = IdHelper::str(el);
+                            if (!IdHelper::isHexOid(hex)) { ok = false; break; }
+                            refs.push_back(hex);
+                        }
+                        if (!ok) { ++skipped; continue; }
+                        bsoncxx::builder::basic::array oids;
+                        for (const auto& hex : refs) oids.append(bsoncxx::oid{hex});
+                        // Conditional on the array as read: a drive $pushed in the
+                        // meantime makes this a no-op for the next run to retry
+                        // instead of being overwritten
+                        writes.emplace_back(mongocxx::model::update_one{
+                            make_document(kvp("_id", *last),
+                                          kvp(target.field, bsoncxx::types::b_array{value.get_array().value})),
+                            make_document(kvp("$set", make_document(kvp(target.field, oids))))
+                        });
+                        writeIds.push_back(*last);
+                    } else {
+                        std::string hex(value.get_string().value);
+                        if (!IdHelper::isHexOid(hex)) { ++skipped; continue; }
+                        // Conditional on the old value so a concurrent rewrite is not clobbered
+                        writes.emplace_back(mongocxx::model::update_one{
+                            make_document(kvp("_id", *last), kvp(target.field, hex)),
+                            make_document(kvp("$set", make_document(kvp(target.field, bsoncxx::oid{hex}))))
+                        });
+                        writeIds.push_back(*last);
+                    }
+                }
+
+                if (!writes.empty()) {
+                    mongocxx::options::bulk_write bulkOpts;
+                    bulkOpts.ordered(false);
+                    try {
+                        auto result = coll.bulk_write(writes, bulkOpts);
+                        if (result) converted += result->modified_count();
+                    } catch (const mongocxx::bulk_write_exception& e) {
+                        // Unordered: the rest of the batch was applied. Duplicate
+                        // keys are reported for a manual merge; anything else aborts.
+                        if (!e.raw_server_error()) throw;
+                        auto reply = e.raw_server_error()->view();
+                        auto writeErrors = reply["writeErrors"];
+                        if (!writeErrors || writeErrors.type() != bsoncxx::type::k_array) throw;
+                        for (auto& err : writeErrors.get_array().value) {
+                            if (err["code"].get_int32().value != kDuplicateKey) throw;
+                            ++duplicates;
+                            auto index = static_cast<size_t>(err["index"].get_int32().value);
+                            if (index < writeIds.size() && duplicateIds.size() < kMaxReportedDuplicates) {
+                                duplicateIds.append(writeIds[index].to_string());
+                            }
+                        }
+                        auto modified = reply["nModified"];
+                        if (modified && modified.type() == bsoncxx::type::k_int32) {
+                            converted += modified.get_int32().value;
+                        } else if (modified && modified.type() == bsoncxx::type::k_int64) {
+                            converted += modified.get_int64().value;
+                        }
+                    }
+                }
+                update([&](Json::Value& s) {
+                    s["fields"][key]["converted"] = static_cast<Json::Int64>(converted);
+                    s["fields"][key]["skipped"] = static_cast<Json::Int64>(skipped);
+                    if (duplicates > 0) {
+                        s["fields"][key]["duplicates"] = static_cast<Json::Int64>(duplicates);
+                        s["fields"][key]["duplicate_ids"] = duplicateIds;
+                    }
+                });
+                if (seen < limit) break;
+                // Leave room for foreground traffic between batches
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            }
+        }
+
+        Json::Value after = measure();
+        update([&after](Json::Value& s) {
+            s["after"] = after;
+            s["state"] = "done";
+            s["completed_at"] = nowIso();
+            s["note"] = "Index sizes shrink once the indexes are rebuilt or compacted. "
+                        "Rows listed under duplicate_ids repeat another row once converted; "
+                        "merge or delete them before switching to ID_FORMAT=oid";
+        });
+    } catch (const std::exception& e) {
+        std::cerr << "Warning: ID migration failed: " << e.what() << std::endl;
+        update([&e](Json::Value& s) {
+            s["state"] = "failed";
+            s["error"] = e.what();
+        });
+    }
+
+    // Persist the report so it survives the restart into ID_FORMAT=oid
+    Json::Value report;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+        report = state_;
+    }
+    try {
+        auto client = MongoService::instance().acquireClient();
+        auto maintenance = MongoService::instance().getCollection(client, "maintenance");
+        mongocxx::options::replace opts;
+        opts.upsert(true);
+        maintenance.replace_one(
+            make_document(kvp("_id", "id-migration")),
+            make_document(kvp("_id", "id-migration"),
+                          kvp("report", bsoncxx::types::b_document{JsonHelper::jsonToBson(report).view()})),
+            opts);
+    } catch (const std::exception& e) {
+        std::cerr << "Warning: ID migration report: " << e.what() << std::endl;
+    }
+}
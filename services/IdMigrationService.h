@@ -0,0 +1,34 @@
+#pragma once
+
+#include "WorkQueue.h"
+#include <json/json.h>
+#include <functional>
+#include <mutex>
+
+// Online rewrite of string references to ObjectId, in id-ordered batches.
+// Run it with ID_FORMAT=dual so reads accept both forms, then restart with
+// ID_FORMAT=oid once every reference reports converted.
+class IdMigrationService {
+public:
+    static IdMigrationService& instance();
+
+    // false when a run is already in progress
+    bool start();
+    Json::Value status();
+
+private:
+    IdMigrationService() = default;
+    IdMigrationService(const IdMigrationService&) = delete;
+    IdMigrationService& operator=(const IdMigrationService&) = delete;
+
+    void run();
+    // Index sizes per collection and reference lookup latency
+    static Json::Value measure();
+    void update(const std::function<void(Json::Value&)>& fn);
+
+    std::mutex mutex_;
+    Json::Value state_;
+    bool running_ = false;
+
+    WorkQueue worker_{"id-migration", 1};
+};
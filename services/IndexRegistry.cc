@@ -0,0 +1,284 @@
+#include "IndexRegistry.h"
+#include "IdHelper.h"
+#include "MongoService.h"
+#include <bsoncxx/builder/basic/array.hpp>
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/builder/basic/kvp.hpp>
+#include <bsoncxx/types.hpp>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <set>
+
+using bsoncxx::builder::basic::kvp;
+using bsoncxx::builder::basic::make_array;
+using bsoncxx::builder::basic::make_document;
+
+namespace {
+
+// Placeholder reference for explain; only the shape of the filter matters
+const std::string kSampleId = "000000000000000000000000";
+
+struct PlanSummary {
+    bool collscan = false;
+    bool blockingSort = false;
+    std::set<std::string> indexNames;
+};
+
+// Walks the whole plan tree; the classic and SBE explain formats nest stages differently
+void walkPlan(const bsoncxx::document::view& node, PlanSummary& out);
+
+void walkValue(const bsoncxx::types::bson_value::view& value, PlanSummary& out) {
+    if (value.type() == bsoncxx::type::k_document) {
+        walkPlan(value.get_document().value, out);
+    } else if (value.type() == bsoncxx::type::k_array) {
+        for (auto& el : value.get_array().value) walkValue(el.get_value(), out);
+    }
+}
+
+void walkPlan(const bsoncxx::document::view& node, PlanSummary& out) {
+    for (auto& el : node) {
+        if (el.key() == "stage" && el.type() == bsoncxx::type::k_string) {
+            std::string stage(el.get_string().value);
+            if (stage == "COLLSCAN") out.collscan = true;
+            if (stage == "SORT") out.blockingSort = true;
+        } else if (el.key() == "indexName" && el.type() == bsoncxx::type::k_string) {
+            out.indexNames.emplace(el.get_string().value);
+        } else {
+            walkValue(el.get_value(), out);
+        }
+    }
+}
+
+std::string checkMode() {
+    const char* env = std::getenv("INDEX_CHECK");
+    if (!env || std::strcmp(env, "") == 0 || std::strcmp(env, "off") == 0 || std::strcmp(env, "0") == 0) {
+        return "off";
+    }
+    return std::strcmp(env, "strict") == 0 ? "strict" : "warn";
+}
+
+} // anonymous namespace
+
+std::string IndexRegistry::indexName(const bsoncxx::document::view& keys) {
+    std::string name;
+    for (auto& el : keys) {
+        if (!name.empty()) name += "_";
+        name += std::string(el.key()) + "_";
+        switch (el.type()) {
+            case bsoncxx::type::k_int32: name += std::to_string(el.get_int32().value); break;
+            case bsoncxx::type::k_int64: name += std::to_string(el.get_int64().value); break;
+            case bsoncxx::type::k_double: name += std::to_string(static_cast<int>(el.get_double().value)); break;
+            case bsoncxx::type::k_string: name += std::string(el.get_string().value); break;
+            default: break;
+        }
+    }
+    return name;
+}
+
+bool IndexRegistry::strict() {
+    return checkMode() == "strict";
+}
+
+const std::vector<IndexRegistry::IndexSpec>& IndexRegistry::indexes() {
+    static const std::vector<IndexSpec> specs = [] {
+        std::vector<IndexSpec> v;
+        // Login and registration lookups
+        v.push_back({"users", make_document(kvp("email", 1)), true});
+        // Pending approvals, recruiter and TPO listings
+        v.push_back({"users", make_document(kvp("role", 1), kvp("status", 1)), false});
+
+        v.push_back({"students", make_document(kvp("user_id", 1)), true});
+        // Drive eligibility: gpa >= min, backlogs <= allowed
+        v.push_back({"students", make_document(kvp("gpa", 1), kvp("backlogs", 1)), false});
+        // Resume keywords already extracted from the same file
+        v.push_back({"students", make_document(kvp("resume_keywords_hash", 1)), false});
+
+        v.push_back({"companies", make_document(kvp("recruiter_id", 1)), false});
+        v.push_back({"companies", make_document(kvp("created_by", 1)), false});
+        // Eligible drives for a student: min_gpa <= gpa, allowed_backlogs >= backlogs
+        v.push_back({"companies", make_document(kvp("min_gpa", 1), kvp("allowed_backlogs", 1)), false});
+
+        // One application per drive; its prefix serves lookups by student_id alone
+        v.push_back({"applications", make_document(kvp("student_id", 1), kvp("company_id", 1)), true});
+        // Drive applicant lists and per-drive status breakdowns
+        v.push_back({"applications", make_document(kvp("company_id", 1), kvp("status", 1)), false});
+
+        v.push_back({"interviews", make_document(kvp("student_id", 1)), false});
+        // Drive interview schedules
+        v.push_back({"interviews", make_document(kvp("company_id", 1), kvp("interview_date", 1)), false});
+
+        // Notification feed (newest first) and the unread count
+        v.push_back({"notifications", make_document(kvp("user_id", 1), kvp("created_at", -1)), false});
+        v.push_back({"notifications", make_document(kvp("user_id", 1), kvp("read", 1)), false});
+
+        // Trend range scans by day
+        v.push_back({"rollups", make_document(kvp("day", 1), kvp("department", 1), kvp("status", 1)), false});
+        return v;
+    }();
+    return specs;
+}
+
+std::vector<IndexRegistry::QueryShape> IndexRegistry::queryShapes() {
+    auto match = [](const std::string& hex) { return IdHelper::match(hex); };
+    auto none = [] { return make_document(); };
+
+    std::vector<QueryShape> v;
+    v.push_back({"AuthService::loginUser", "users",
+                 make_document(kvp("email", "someone@example.com")), none()});
+    v.push_back({"TpoService::getPendingStudents", "users",
+                 make_document(kvp("role", "student"), kvp("status", "pending_approval")), none()});
+    v.push_back({"TpoService::getAllRecruiters", "users",
+                 make_document(kvp("role", "recruiter")), none()});
+    v.push_back({"StudentIndexService::load (inactive students)", "users",
+                 make_document(kvp("role", "student"),
+                               kvp("status", make_document(kvp("$in", make_array("pending_approval", "rejected"))))),
+                 none()});
+
+    v.push_back({"StudentController::getProfile", "students",
+                 make_document(kvp("user_id", match(kSampleId).view())), none()});
+    v.push_back({"ResumeTextService::reuse", "students",
+                 make_document(kvp("resume_keywords_hash", std::string(64, '0'))), none()});
+    v.push_back({"EligibilityService::getEligibleStudents", "students",
+                 make_document(kvp("gpa", make_document(kvp("$gte", 7.0))),
+                               kvp("backlogs", make_document(kvp("$lte", 0)))), none()});
+
+    v.push_back({"EligibilityService::getEligibleDrives", "companies",
+                 make_document(kvp("min_gpa", make_document(kvp("$lte", 7.0))),
+                               kvp("allowed_backlogs", make_document(kvp("$gte", 0)))), none()});
+
+    v.push_back({"StudentController::getApplications", "applications",
+                 make_document(kvp("student_id", match(kSampleId).view())), none()});
+    v.push_back({"ResumeController::download (recruiter scope)", "applications",
+                 make_document(kvp("student_id", match(kSampleId).view()),
+                               kvp("company_id", make_document(kvp("$in", IdHelper::matchAny({kSampleId}))))),
+                 none()});
+    v.push_back({"CompanyController::getDriveApplications", "applications",
+                 make_document(kvp("company_id", match(kSampleId).view())), none()});
+
+    v.push_back({"InterviewController::getMyInterviews", "interviews",
+                 make_document(kvp("student_id", match(kSampleId).view())), none()});
+    v.push_back({"InterviewController::getAllInterviews", "interviews",
+                 make_document(kvp("company_id", match(kSampleId).view())), none()});
+
+    v.push_back({"AnalyticsController::getNotifications", "notifications",
+                 make_document(kvp("user_id", match(kSampleId).view())),
+                 make_document(kvp("created_at", -1))});
+    v.push_back({"AnalyticsController::getNotifications (unread count)", "notifications",
+                 make_document(kvp("user_id", match(kSampleId).view()), kvp("read", false)), none()});
+
+    v.push_back({"RollupService::getTrends", "rollups",
+                 make_document(kvp("day", make_document(kvp("$gte", "2026-01-01"), kvp("$lte", "2026-01-31")))),
+                 none()});
+    return v;
+}
+
+Json::Value IndexRegistry::check() {
+    Json::Value report;
+    Json::Value shapes(Json::arrayValue);
+    Json::Value undeclared(Json::arrayValue);
+    int problems = 0;
+
+    auto client = MongoService::instance().acquireClient();
+    auto db = MongoService::instance().getDb(client);
+
+    for (const auto& shape : queryShapes()) {
+        Json::Value entry;
+        entry["query"] = shape.name;
+        entry["collection"] = shape.collection;
+        try {
+            bsoncxx::builder::basic::document find;
+            find.append(kvp("find", shape.collection));
+            find.append(kvp("filter", shape.filter.view()));
+            if (!shape.sort.view().empty()) find.append(kvp("sort", shape.sort.view()));
+
+            auto explained = db.run_command(make_document(
+                kvp("explain", find.extract()), kvp("verbosity", "queryPlanner")));
+
+            PlanSummary plan;
+            auto planner = explained.view()["queryPlanner"];
+            if (planner && planner.type() == bsoncxx::type::k_document) {
+                auto winning = planner.get_document().value["winningPlan"];
+                if (winning) walkValue(winning.get_value(), plan);
+            }
+
+            Json::Value used(Json::arrayValue);
+            for (const auto& name : plan.indexNames) used.append(name);
+            entry["indexes"] = used;
+            entry["collscan"] = plan.collscan;
+            entry["in_memory_sort"] = plan.blockingSort;
+            entry["ok"] = !plan.collscan && !plan.blockingSort;
+            if (!entry["ok"].asBool()) problems++;
+        } catch (const std::exception& e) {
+            entry["ok"] = false;
+            entry["error"] = e.what();
+            problems++;
+        }
+        shapes.append(entry);
+    }
+
+    // Indexes that exist but are not declared still cost every write
+    std::set<std::pair<std::string, std::string>> declared;
+    std::set<std::string> collections;
+    for (const auto& spec : indexes()) {
+        declared.emplace(spec.collection, indexName(spec.keys.view()));
+        collections.insert(spec.collection);
+    }
+    for (const auto& name : collections) {
+        try {
+            auto coll = db[name];
+            for (auto& index : coll.list_indexes()) {
+                std::string indexName(index["name"].get_string().value);
+                if (indexName == "_id_" || declared.count({name, indexName})) continue;
+                Json::Value extra;
+                extra["collection"] = name;
+                extra["index"] = indexName;
+                undeclared.append(extra);
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "Warning: Listing indexes on " << name << ": " << e.what() << std::endl;
+        }
+    }
+
+    report["success"] = true;
+    report["problems"] = problems;
+    report["shapes"] = shapes;
+    report["undeclared_indexes"] = undeclared;
+    return report;
+}
+
+bool IndexRegistry::runStartupCheck() {
+    std::string mode = checkMode();
+    if (mode == "off") return true;
+
+    Json::Value report;
+    try {
+        report = check();
+    } catch (const std::exception& e) {
+        std::cerr << "Warning: Index check failed: " << e.what() << std::endl;
+        return mode != "strict";
+    }
+
+    for (const auto& entry : report["shapes"]) {
+        if (entry["ok"].asBool()) continue;
+        std::cerr << "Warning: Index check: " << entry["query"].asString()
+                  << " on " << entry["collection"].asString() << ": ";
+        if (entry.isMember("error")) {
+            std::cerr << entry["error"].asString();
+        } else {
+            if (entry["collscan"].asBool()) std::cerr << "COLLSCAN ";
+            if (entry["in_memory_sort"].asBool()) std::cerr << "in-memory SORT";
+        }
+        std::cerr << std::endl;
+    }
+    for (const auto& extra : report["undeclared_indexes"]) {
+        std::cerr << "Warning: Index check: " << extra["collection"].asString() << "."
+                  << extra["index"].asString() << " is not in the index spec" << std::endl;
+    }
+
+    int problems = report["problems"].asInt();
+    std::cout << "Index check: " << report["shapes"].size() << " query shapes, "
+              << problems << " problems, " << report["undeclared_indexes"].size()
+              << " undeclared indexes" << std::endl;
+    return mode != "strict" || problems == 0;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <bsoncxx/document/value.hpp>
+#include <bsoncxx/document/view.hpp>
+#include <json/json.h>
+#include <string>
+#include <vector>
+
+// Declarative index list plus the query shapes the services actually run.
+// MongoService::createIndexes builds the former; check() explains the latter
+// so a COLLSCAN or in-memory SORT shows up at startup instead of in latency.
+class IndexRegistry {
+public:
+    struct IndexSpec {
+        std::string collection;
+        bsoncxx::document::value keys;
+        bool unique;
+    };
+
+    struct QueryShape {
+        std::string name;   // where the query runs, e.g. "StudentController::getApplications"
+        std::string collection;
+        bsoncxx::document::value filter;
+        bsoncxx::document::value sort;
+    };
+
+    static const std::vector<IndexSpec>& indexes();
+    // Built per call: reference filters depend on ID_FORMAT
+    static std::vector<QueryShape> queryShapes();
+
+    // Explain every shape and list indexes that exist but are not declared.
+    // Controlled by INDEX_CHECK: unset/off skips, "warn" logs, "strict" also
+    // returns false on any problem so startup can refuse to continue.
+    static bool runStartupCheck();
+    // INDEX_CHECK=strict: a failed check keeps the server out of rotation
+    static bool strict();
+    // The name the server gives an index created without an explicit name
+    static std::string indexName(const bsoncxx::document::view& keys);
+    static Json::Value check();
+};
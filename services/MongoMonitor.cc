@@ -0,0 +1,200 @@
+#include "MongoMonitor.h"
+#include "Metrics.h"
+#include "RequestTrace.h"
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/builder/basic/kvp.hpp>
+#include <bsoncxx/document/value.hpp>
+#include <bsoncxx/types.hpp>
+#include <mongocxx/events/command_failed_event.hpp>
+#include <mongocxx/events/command_started_event.hpp>
+#include <mongocxx/events/command_succeeded_event.hpp>
+#include <cstdlib>
+#include <iostream>
+#include <iterator>
+#include <optional>
+#include <unordered_map>
+
+namespace {
+
+struct InFlight {
+    std::string collection;
+    std::string command;
+    // Only the part that makes a query slow or fast: filter, q or pipeline
+    std::optional<bsoncxx::document::value> filter;
+    // Offset into the request's trace, when one is bound
+    int64_t traceStartUs = -1;
+};
+
+struct CommandSeries {
+    Metrics::Histogram* duration;
+    Metrics::Counter* failures;
+};
+
+thread_local std::unordered_map<int64_t, InFlight> inFlight;
+thread_local MongoMonitor::Counter currentRequest;
+
+int64_t slowMicros() {
+    static const int64_t value = [] {
+        const char* env = std::getenv("MONGO_SLOW_MS");
+        long ms = env ? std::strtol(env, nullptr, 10) : 100;
+        return static_cast<int64_t>(ms > 0 ? ms : 0) * 1000;
+    }();
+    return value;
+}
+
+CommandSeries& seriesFor(const std::string& collection, const std::string& command) {
+    thread_local std::unordered_map<std::string, CommandSeries> cache;
+    std::string key = collection + ' ' + command;
+    auto it = cache.find(key);
+    if (it != cache.end()) return it->second;
+
+    auto& metrics = Metrics::instance();
+    CommandSeries series{
+        &metrics.histogram("mongo_command_duration_seconds", "MongoDB command round trip",
+                           {{"collection", collection}, {"command", command}}),
+        &metrics.counter("mongo_command_failures_total", "MongoDB commands that returned an error",
+                         {{"collection", collection}, {"command", command}}),
+    };
+    return cache.emplace(std::move(key), series).first->second;
+}
+
+// The command document names its collection in the first field
+// ({find: "students", ...}); getMore carries it separately
+std::string collectionOf(const bsoncxx::document::view& command, const std::string& name) {
+    if (name == "getMore") {
+        auto coll = command["collection"];
+        return coll && coll.type() == bsoncxx::type::k_string ? std::string(coll.get_string().value) : "-";
+    }
+    auto first = command.begin();
+    if (first == command.end() || first->type() != bsoncxx::type::k_string) return "-";
+    return std::string(first->get_string().value);
+}
+
+std::optional<bsoncxx::document::value> filterOf(const bsoncxx::document::view& command) {
+    for (const char* field : {"filter", "query"}) {
+        auto el = command[field];
+        if (el && el.type() == bsoncxx::type::k_document) {
+            return bsoncxx::document::value(el.get_document().value);
+        }
+    }
+    // update / delete: the first statement's q
+    for (const char* field : {"updates", "deletes"}) {
+        auto el = command[field];
+        if (!el || el.type() != bsoncxx::type::k_array) continue;
+        auto statements = el.get_array().value;
+        auto first = statements.begin();
+        if (first == statements.end() || first->type() != bsoncxx::type::k_document) continue;
+        auto q = first->get_document().value["q"];
+        if (q && q.type() == bsoncxx::type::k_document) {
+            return bsoncxx::document::value(q.get_document().value);
+        }
+    }
+    // aggregate: wrap the pipeline so it fits the same shape printer
+    auto pipeline = command["pipeline"];
+    if (pipeline && pipeline.type() == bsoncxx::type::k_array) {
+        bsoncxx::builder::basic::document doc;
+        doc.append(bsoncxx::builder::basic::kvp("pipeline", pipeline.get_array().value));
+        return doc.extract();
+    }
+    return std::nullopt;
+}
+
+void shapeValue(const bsoncxx::types::bson_value::view& value, std::string& out);
+
+void shapeDocument(const bsoncxx::document::view& doc, std::string& out) {
+    out += '{';
+    bool first = true;
+    for (auto& el : doc) {
+        if (!first) out += ", ";
+        first = false;
+        out += '"';
+        out += std::string(el.key());
+        out += "\": ";
+        shapeValue(el.get_value(), out);
+    }
+    out += '}';
+}
+
+void shapeValue(const bsoncxx::types::bson_value::view& value, std::string& out) {
+    switch (value.type()) {
+        case bsoncxx::type::k_document:
+            shapeDocument(value.get_document().value, out);
+            break;
+        case bsoncxx::type::k_array: {
+            // One element stands for the rest; $in lists differ only in length
+            auto arr = value.get_array().value;
+            out += '[';
+            if (arr.begin() != arr.end()) {
+                shapeValue(arr.begin()->get_value(), out);
+                if (std::next(arr.begin()) != arr.end()) out += ", ...";
+            }
+            out += ']';
+            break;
+        }
+        default:
+            out += "\"?\"";
+    }
+}
+
+void finish(int64_t requestId, const std::string& command, int64_t micros, bool failed) {
+    auto it = inFlight.find(requestId);
+    if (it == inFlight.end()) return;
+    InFlight started = std::move(it->second);
+    inFlight.erase(it);
+
+    auto& series = seriesFor(started.collection, started.command);
+    series.duration->recordMicros(micros > 0 ? static_cast<uint64_t>(micros) : 0);
+    if (failed) series.failures->add();
+
+    if (auto* trace = RequestTrace::current(); trace && started.traceStartUs >= 0) {
+        trace->add(RequestTrace::Phase::Db, started.traceStartUs, micros,
+                   trace->sampled() ? started.command + ' ' + started.collection : std::string());
+    }
+
+    int64_t threshold = slowMicros();
+    if (threshold > 0 && micros >= threshold) {
+        std::cerr << "Warning: Slow Mongo " << command << " on " << started.collection << " ("
+                  << micros / 1000 << "ms)";
+        if (started.filter) std::cerr << ": " << MongoMonitor::shapeOf(started.filter->view());
+        std::cerr << std::endl;
+    }
+}
+
+} // anonymous namespace
+
+std::string MongoMonitor::shapeOf(const bsoncxx::document::view& filter) {
+    std::string out;
+    shapeDocument(filter, out);
+    return out;
+}
+
+void MongoMonitor::attribute(Counter counter) {
+    currentRequest = std::move(counter);
+}
+
+mongocxx::options::apm MongoMonitor::apmOptions() {
+    mongocxx::options::apm apm;
+
+    apm.on_command_started([](const mongocxx::events::command_started_event& event) {
+        std::string name(event.command_name());
+        auto command = event.command();
+        InFlight started;
+        started.collection = collectionOf(command, name);
+        started.command = name;
+        if (slowMicros() > 0) started.filter = filterOf(command);
+        if (auto* trace = RequestTrace::current()) started.traceStartUs = trace->elapsedUs();
+        inFlight[event.request_id()] = std::move(started);
+
+        if (currentRequest) currentRequest->fetch_add(1, std::memory_order_relaxed);
+    });
+
+    apm.on_command_succeeded([](const mongocxx::events::command_succeeded_event& event) {
+        finish(event.request_id(), std::string(event.command_name()), event.duration(), false);
+    });
+
+    apm.on_command_failed([](const mongocxx::events::command_failed_event& event) {
+        finish(event.request_id(), std::string(event.command_name()), event.duration(), true);
+    });
+
+    return apm;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <mongocxx/options/apm.hpp>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// Command monitoring through mongocxx APM callbacks, installed on the pool
+// by MongoService::init.
+//   - mongo_command_duration_seconds{collection, command} for every command
+//   - commands slower than MONGO_SLOW_MS (default 100, 0 = off) are logged
+//     with their filter shape: field names and operators, values elided
+//   - commands are counted against whatever request the thread is serving
+//     (see attribute()) so RequestMetrics can enforce MONGO_QUERY_BUDGET
+//   - and timed as db spans on the thread's RequestTrace, if any
+//
+// Pooled clients run commands and their callbacks on the calling thread,
+// so started/succeeded pairs are matched through thread-local state.
+class MongoMonitor {
+public:
+    using Counter = std::shared_ptr<std::atomic<uint32_t>>;
+
+    static mongocxx::options::apm apmOptions();
+
+    // Commands issued on this thread from now on are added to `counter`,
+    // until the next call. Request handlers here run synchronously on the
+    // IO thread, so this attributes each command to the request being served.
+    static void attribute(Counter counter);
+
+    // {"user_id": "?", "status": {"$in": ["?"]}} for the given filter
+    static std::string shapeOf(const bsoncxx::document::view& filter);
+};
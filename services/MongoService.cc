@@ -1,8 +1,18 @@
 #include "MongoService.h"
 #include "BcryptHelper.h"
+#include "IndexRegistry.h"
+#include "Metrics.h"
+#include "MongoMonitor.h"
+#include <mongocxx/options/client.hpp>
+#include <mongocxx/options/pool.hpp>
 #include <bsoncxx/builder/basic/array.hpp>
+#include <atomic>
 #include <iostream>
 #include <chrono>
+#include <map>
+#include <optional>
+#include <thread>
+#include <vector>
 
 mongocxx::instance MongoService::inst_{};
 
@@ -14,7 +24,10 @@ MongoService& MongoService::instance() {
 void MongoService::init(const std::string& uri, const std::string& dbName) {
     dbName_ = dbName;
     mongocxx::uri mongoUri{uri};
-    pool_ = std::make_unique<mongocxx::pool>(mongoUri);
+    // Command timings, slow-query log and per-request command counts
+    mongocxx::options::client clientOpts;
+    clientOpts.apm_opts(MongoMonitor::apmOptions());
+    pool_ = std::make_unique<mongocxx::pool>(mongoUri, mongocxx::options::pool{clientOpts});
 
     // Test connection immediately
     try {
@@ -32,6 +45,10 @@ void MongoService::init(const std::string& uri, const std::string& dbName) {
 }
 
 mongocxx::pool::entry MongoService::acquireClient() {
+    // Near zero while the pool has idle clients; grows when every client is checked out
+    static auto& wait = Metrics::instance().histogram(
+        "mongo_pool_acquire_seconds", "Time spent waiting for a pooled MongoDB client");
+    Metrics::Timer timer(wait);
     return pool_->acquire();
 }
 
@@ -47,61 +64,66 @@ void MongoService::createIndexes() {
     using bsoncxx::builder::basic::kvp;
     using bsoncxx::builder::basic::make_document;
 
-    try {
-        auto client = acquireClient();
-
-        // Users: unique email index + role/status compound
-        {
-            auto coll = getCollection(client, "users");
-            mongocxx::options::index opts{};
-            opts.unique(true);
-            coll.create_index(make_document(kvp("email", 1)), opts);
-            coll.create_index(make_document(kvp("role", 1), kvp("status", 1)));
-        }
-
-        // Students: unique user_id index + gpa/backlogs index
-        {
-            auto coll = getCollection(client, "students");
-            mongocxx::options::index opts{};
-            opts.unique(true);
-            coll.create_index(make_document(kvp("user_id", 1)), opts);
-            coll.create_index(make_document(kvp("gpa", 1), kvp("backlogs", 1)));
-        }
+    // Declared in IndexRegistry next to the query shapes they serve. Batched
+    // per collection: one round trip each instead of one per index.
+    std::map<std::string, bsoncxx::builder::basic::array> byCollection;
+    for (const auto& spec : IndexRegistry::indexes()) {
+        bsoncxx::builder::basic::document index;
+        index.append(kvp("key", spec.keys.view()));
+        index.append(kvp("name", IndexRegistry::indexName(spec.keys.view())));
+        if (spec.unique) index.append(kvp("unique", true));
+        byCollection[spec.collection].append(index.extract());
+    }
 
-        // Companies: recruiter_id + created_by indexes
-        {
-            auto coll = getCollection(client, "companies");
-            coll.create_index(make_document(kvp("recruiter_id", 1)));
-            coll.create_index(make_document(kvp("created_by", 1)));
+    auto client = acquireClient();
+    auto db = getDb(client);
+    size_t failed = 0;
+    for (auto& [collection, indexes] : byCollection) {
+        try {
+            db.run_command(make_document(
+                kvp("createIndexes", collection), kvp("indexes", indexes.extract())));
+        } catch (const std::exception& e) {
+            ++failed;
+            std::cerr << "Warning: Index creation on " << collection << ": " << e.what() << std::endl;
         }
+    }
+    if (failed == 0) std::cout << "Database indexes created successfully" << std::endl;
+}
 
-        // Applications: unique student_id + company_id, company_id index
-        {
-            auto coll = getCollection(client, "applications");
-            mongocxx::options::index opts{};
-            opts.unique(true);
-            coll.create_index(make_document(kvp("student_id", 1), kvp("company_id", 1)), opts);
-            coll.create_index(make_document(kvp("company_id", 1)));
-        }
+size_t MongoService::prewarm(size_t connections) {
+    using bsoncxx::builder::basic::kvp;
+    using bsoncxx::builder::basic::make_document;
 
-        // Interviews: student_id + company_id indexes
-        {
-            auto coll = getCollection(client, "interviews");
-            coll.create_index(make_document(kvp("student_id", 1)));
-            coll.create_index(make_document(kvp("company_id", 1)));
-        }
+    if (connections == 0) return 0;
 
-        // Notifications: user_id + read, created_at descending
-        {
-            auto coll = getCollection(client, "notifications");
-            coll.create_index(make_document(kvp("user_id", 1), kvp("read", 1)));
-            coll.create_index(make_document(kvp("created_at", -1)));
-        }
+    // Hold every entry at once so the pool has to hand out distinct clients,
+    // each with its own connection; try_acquire stops at maxPoolSize
+    std::vector<mongocxx::pool::entry> entries;
+    while (entries.size() < connections) {
+        auto entry = pool_->try_acquire();
+        if (!entry) break;
+        entries.push_back(std::move(*entry));
+    }
 
-        std::cout << "Database indexes created successfully" << std::endl;
-    } catch (const std::exception& e) {
-        std::cerr << "Warning: Index creation: " << e.what() << std::endl;
+    // Pinging in parallel pays for the TLS handshakes concurrently
+    std::atomic<size_t> warmed{0};
+    std::vector<std::thread> threads;
+    threads.reserve(entries.size());
+    for (auto& entry : entries) {
+        threads.emplace_back([this, &entry, &warmed]() {
+            try {
+                (*entry)[dbName_].run_command(make_document(kvp("ping", 1)));
+                ++warmed;
+            } catch (const std::exception& e) {
+                std::cerr << "Warning: Pool pre-warm: " << e.what() << std::endl;
+            }
+        });
     }
+    for (auto& t : threads) t.join();
+
+    std::cout << "MongoDB pool pre-warmed: " << warmed.load() << "/" << connections
+              << " connections" << std::endl;
+    return warmed.load();
 }
 
 void MongoService::seedTpo() {
@@ -139,5 +161,6 @@ void MongoService::seedTpo() {
 
     } catch (const std::exception& e) {
         std::cerr << "Warning: TPO seed: " << e.what() << std::endl;
+        throw;
     }
 }
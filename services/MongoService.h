@@ -16,7 +16,12 @@ public:
     static MongoService& instance();
 
     void init(const std::string& uri, const std::string& dbName);
+    // One createIndexes command per collection; existing indexes are no-ops
     void createIndexes();
+    // Opens up to `connections` pooled connections ahead of the first
+    // requests; returns how many answered a ping. 0 does nothing.
+    size_t prewarm(size_t connections);
+    // Logs and rethrows on failure
     void seedTpo();
 
     // Acquire a client from the pool. Caller MUST keep the entry alive
@@ -0,0 +1,425 @@
+#include "PivotService.h"
+#include "IdHelper.h"
+#include "MongoService.h"
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/builder/basic/kvp.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <set>
+
+using bsoncxx::builder::basic::kvp;
+using bsoncxx::builder::basic::make_document;
+
+namespace {
+
+// Rows evaluated per column pass; sized to keep the block in L1
+constexpr size_t kBlock = 1024;
+constexpr size_t kMinRowsPerThread = 16384;
+constexpr uint64_t kMaxGroups = 1u << 20;
+// Upper bound on per-thread accumulator slots across all threads
+constexpr uint64_t kMaxAccumulatorSlots = 1u << 22;
+constexpr size_t kMaxGroupBy = 4;
+
+std::string stringOf(const bsoncxx::document::element& el) {
+    if (!el || el.type() != bsoncxx::type::k_string) return "";
+    return std::string(el.get_string().value);
+}
+
+float numberOf(const bsoncxx::document::element& el) {
+    if (!el) return 0.0f;
+    switch (el.type()) {
+        case bsoncxx::type::k_double: return static_cast<float>(el.get_double().value);
+        case bsoncxx::type::k_int32: return static_cast<float>(el.get_int32().value);
+        case bsoncxx::type::k_int64: return static_cast<float>(el.get_int64().value);
+        default: return 0.0f;
+    }
+}
+
+std::string isoTimestamp(std::chrono::system_clock::time_point tp) {
+    std::time_t t = std::chrono::system_clock::to_time_t(tp);
+    std::tm tm{};
+    gmtime_r(&t, &tm);
+    char buf[32];
+    std::strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%SZ", &tm);
+    return buf;
+}
+
+std::string bandLabel(uint32_t band, double width) {
+    char buf[48];
+    std::snprintf(buf, sizeof(buf), "%g-%g", band * width, (band + 1) * width);
+    return buf;
+}
+
+} // anonymous namespace
+
+PivotService& PivotService::instance() {
+    static PivotService svc;
+    return svc;
+}
+
+PivotService::~PivotService() {
+    {
+        std::lock_guard<std::mutex> lock(stopMutex_);
+        stopping_ = true;
+    }
+    stopCv_.notify_all();
+    if (refresher_.joinable()) refresher_.join();
+}
+
+uint16_t PivotService::Dictionary::encode(const std::string& key, const std::string& label) {
+    auto it = codes.find(key);
+    if (it != codes.end()) return it->second;
+    if (overflow >= 0) return static_cast<uint16_t>(overflow);
+    if (keys.size() + 1 >= std::numeric_limits<uint16_t>::max()) {
+        // One code left: reserve it for the long tail rather than folding it
+        // into a real value, which pivots would then report under that label
+        overflow = static_cast<int32_t>(keys.size());
+        keys.push_back("(other)");
+        labels.push_back("Other");
+        return static_cast<uint16_t>(overflow);
+    }
+    auto code = static_cast<uint16_t>(keys.size());
+    keys.push_back(key);
+    labels.push_back(label);
+    codes.emplace(key, code);
+    return code;
+}
+
+void PivotService::start() {
+    if (refresher_.joinable()) return;
+
+    const char* env = std::getenv("PIVOT_REFRESH_SECONDS");
+    long seconds = env ? std::strtol(env, nullptr, 10) : 60;
+    auto interval = std::chrono::seconds(std::max(5L, seconds));
+
+    refresher_ = std::thread([this, interval]() {
+        std::unique_lock<std::mutex> lock(stopMutex_);
+        while (!stopping_) {
+            lock.unlock();
+            refresh();
+            lock.lock();
+            stopCv_.wait_for(lock, interval, [this]() { return stopping_; });
+        }
+    });
+}
+
+void PivotService::refresh() {
+    try {
+        auto started = std::chrono::steady_clock::now();
+        auto snap = std::make_shared<Snapshot>();
+
+        auto client = MongoService::instance().acquireClient();
+        auto studentsColl = MongoService::instance().getCollection(client, "students");
+        auto applicationsColl = MongoService::instance().getCollection(client, "applications");
+        auto companiesColl = MongoService::instance().getCollection(client, "companies");
+
+        // Students: one row each
+        auto& students = snap->students;
+        auto& department = students.columns["department"];
+        auto& placement = students.columns["placement"];
+        std::unordered_map<std::string, uint32_t> rowOf;
+
+        mongocxx::options::find studentOpts;
+        studentOpts.projection(make_document(
+            kvp("user_id", 1), kvp("department", 1), kvp("gpa", 1), kvp("placement_status", 1)));
+        for (auto& doc : studentsColl.find({}, studentOpts)) {
+            std::string userId = IdHelper::str(doc["user_id"]);
+            if (userId.empty()) continue;
+            std::string dept = stringOf(doc["department"]);
+            if (dept.empty()) dept = "Unknown";
+            std::string status = stringOf(doc["placement_status"]);
+            if (status.empty()) status = "NOT_APPLIED";
+
+            rowOf[userId] = static_cast<uint32_t>(students.rows++);
+            department.codes.push_back(department.dict.encode(dept, dept));
+            placement.codes.push_back(placement.dict.encode(status, status));
+            students.gpa.push_back(numberOf(doc["gpa"]));
+        }
+
+        // Applications: student attributes are copied onto each row so the
+        // group-by loop never follows a join
+        auto& apps = snap->applications;
+        auto& appDepartment = apps.columns["department"];
+        auto& appPlacement = apps.columns["placement"];
+        auto& appCompany = apps.columns["company"];
+        auto& appStatus = apps.columns["status"];
+        appDepartment.dict = department.dict;
+        appPlacement.dict = placement.dict;
+
+        mongocxx::options::find companyOpts;
+        companyOpts.projection(make_document(kvp("company_name", 1)));
+        for (auto& doc : companiesColl.find({}, companyOpts)) {
+            appCompany.dict.encode(doc["_id"].get_oid().value.to_string(), stringOf(doc["company_name"]));
+        }
+
+        mongocxx::options::find appOpts;
+        appOpts.projection(make_document(kvp("student_id", 1), kvp("company_id", 1), kvp("status", 1)));
+        for (auto& doc : applicationsColl.find({}, appOpts)) {
+            auto it = rowOf.find(IdHelper::str(doc["student_id"]));
+            if (it == rowOf.end()) continue;
+            uint32_t row = it->second;
+            std::string companyId = IdHelper::str(doc["company_id"]);
+            std::string status = stringOf(doc["status"]);
+
+            apps.rows++;
+            appDepartment.codes.push_back(department.codes[row]);
+            appPlacement.codes.push_back(placement.codes[row]);
+            apps.gpa.push_back(students.gpa[row]);
+            // Drives deleted since the application keep their id as the label
+            appCompany.codes.push_back(appCompany.dict.encode(companyId, companyId));
+            appStatus.codes.push_back(appStatus.dict.encode(status, status));
+        }
+
+        snap->asOf = std::chrono::system_clock::now();
+        snap->buildMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - started).count();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            snapshot_ = snap;
+        }
+        std::cout << "Pivot snapshot built: " << students.rows << " students, " << apps.rows
+                  << " applications in " << snap->buildMs << "ms" << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Warning: Pivot snapshot refresh: " << e.what() << std::endl;
+    }
+}
+
+std::shared_ptr<const PivotService::Snapshot> PivotService::current() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return snapshot_;
+}
+
+Json::Value PivotService::schema() const {
+    Json::Value result;
+    auto snap = current();
+    if (!snap) {
+        result["success"] = false;
+        result["building"] = true;
+        result["message"] = "Pivot snapshot is still being built";
+        return result;
+    }
+
+    auto describe = [](const Table& table) {
+        Json::Value out;
+        out["rows"] = static_cast<Json::UInt64>(table.rows);
+        for (const auto& [name, column] : table.columns) {
+            Json::Value values(Json::arrayValue);
+            for (const auto& label : column.dict.labels) values.append(label);
+            out["dimensions"][name] = values;
+        }
+        out["dimensions"]["gpa_band"] = Json::Value(Json::arrayValue);
+        return out;
+    };
+
+    result["success"] = true;
+    result["sources"]["students"] = describe(snap->students);
+    result["sources"]["applications"] = describe(snap->applications);
+    result["snapshot_as_of"] = isoTimestamp(snap->asOf);
+    result["snapshot_build_ms"] = static_cast<Json::Int64>(snap->buildMs);
+    return result;
+}
+
+Json::Value PivotService::pivot(const Json::Value& request) const {
+    auto started = std::chrono::steady_clock::now();
+    Json::Value result;
+    auto fail = [&result](const std::string& message) {
+        result["success"] = false;
+        result["message"] = message;
+        return result;
+    };
+
+    auto snap = current();
+    if (!snap) {
+        result["building"] = true;
+        return fail("Pivot snapshot is still being built");
+    }
+
+    std::string source = request.get("source", "applications").asString();
+    if (source != "applications" && source != "students") {
+        return fail("source must be applications or students");
+    }
+    const Table& table = source == "students" ? snap->students : snap->applications;
+
+    double bandWidth = request.get("gpa_band", 1.0).asDouble();
+    if (!(bandWidth > 0.0)) return fail("gpa_band must be positive");
+    float maxSeenGpa = 0.0f;
+    for (float g : table.gpa) maxSeenGpa = std::max(maxSeenGpa, g);
+    // Checked in double: a tiny band width would overflow the uint32_t cast
+    double bands = std::floor(maxSeenGpa / bandWidth) + 1.0;
+    if (!(bands <= static_cast<double>(kMaxGroups))) return fail("gpa_band is too small for this data");
+    auto bandCount = static_cast<uint32_t>(bands);
+
+    // Group-by dimensions, combined into one mixed-radix key per row
+    struct Dim {
+        std::string name;
+        const Column* column = nullptr;   // nullptr for gpa_band
+        uint32_t cardinality = 1;
+    };
+    std::vector<Dim> dims;
+    const Json::Value& groupBy = request["group_by"];
+    if (!groupBy.isNull() && !groupBy.isArray()) return fail("group_by must be an array");
+    if (groupBy.size() > kMaxGroupBy) return fail("At most 4 group_by dimensions are supported");
+    uint64_t groups = 1;
+    for (const auto& nameVal : groupBy) {
+        std::string name = nameVal.asString();
+        Dim dim;
+        dim.name = name;
+        if (name == "gpa_band") {
+            dim.cardinality = bandCount;
+        } else {
+            auto it = table.columns.find(name);
+            if (it == table.columns.end()) return fail("Unknown dimension for " + source + ": " + name);
+            dim.column = &it->second;
+            dim.cardinality = std::max<uint32_t>(1, static_cast<uint32_t>(it->second.dict.keys.size()));
+        }
+        groups *= dim.cardinality;
+        if (groups > kMaxGroups) return fail("Pivot has too many groups; filter or drop a dimension");
+        dims.push_back(dim);
+    }
+
+    // Filters become a per-code allow list for each column
+    struct Filter {
+        const std::vector<uint16_t>* codes;
+        std::vector<uint8_t> allow;
+    };
+    std::vector<Filter> filters;
+    const Json::Value& filterSpec = request["filters"];
+    if (!filterSpec.isNull() && !filterSpec.isObject()) return fail("filters must be an object");
+    for (const auto& name : filterSpec.getMemberNames()) {
+        auto it = table.columns.find(name);
+        if (it == table.columns.end()) return fail("Unknown filter for " + source + ": " + name);
+        const auto& values = filterSpec[name];
+        std::set<std::string> wanted;
+        if (values.isArray()) {
+            for (const auto& v : values) wanted.insert(v.asString());
+        } else {
+            wanted.insert(values.asString());
+        }
+        const auto& dict = it->second.dict;
+        Filter filter{&it->second.codes, std::vector<uint8_t>(dict.keys.size() + 1, 0)};
+        for (size_t code = 0; code < dict.keys.size(); ++code) {
+            if (wanted.count(dict.labels[code]) || wanted.count(dict.keys[code])) filter.allow[code] = 1;
+        }
+        filters.push_back(std::move(filter));
+    }
+
+    bool gpaFilter = request.isMember("min_gpa") || request.isMember("max_gpa");
+    float minGpa = static_cast<float>(request.get("min_gpa", -1.0).asDouble());
+    float maxGpa = static_cast<float>(request.get("max_gpa", 1e9).asDouble());
+
+    size_t rows = table.rows;
+    size_t hardware = std::max(1u, std::thread::hardware_concurrency());
+    size_t threads = std::min<size_t>(hardware, std::max<size_t>(1, rows / kMinRowsPerThread));
+    threads = std::min<size_t>(threads, std::max<uint64_t>(1, kMaxAccumulatorSlots / groups));
+
+    struct Partial {
+        std::vector<int64_t> counts;
+        std::vector<double> gpaSums;
+    };
+    std::vector<Partial> partials(threads);
+
+    auto scan = [&](size_t begin, size_t end, Partial& out) {
+        out.counts.assign(groups, 0);
+        out.gpaSums.assign(groups, 0.0);
+        uint8_t keep[kBlock];
+        uint32_t key[kBlock];
+        const float* gpa = table.gpa.data();
+
+        for (size_t base = begin; base < end; base += kBlock) {
+            size_t n = std::min(kBlock, end - base);
+            const float* g = gpa + base;
+
+            std::fill(keep, keep + n, 1);
+            for (const auto& f : filters) {
+                const uint16_t* c = f.codes->data() + base;
+                const uint8_t* allow = f.allow.data();
+                for (size_t j = 0; j < n; ++j) keep[j] &= allow[c[j]];
+            }
+            if (gpaFilter) {
+                for (size_t j = 0; j < n; ++j) keep[j] &= (g[j] >= minGpa) & (g[j] <= maxGpa);
+            }
+
+            std::fill(key, key + n, 0);
+            for (const auto& dim : dims) {
+                uint32_t card = dim.cardinality;
+                if (dim.column) {
+                    const uint16_t* c = dim.column->codes.data() + base;
+                    for (size_t j = 0; j < n; ++j) key[j] = key[j] * card + c[j];
+                } else {
+                    for (size_t j = 0; j < n; ++j) {
+                        auto band = static_cast<uint32_t>(std::max(0.0f, g[j]) / bandWidth);
+                        key[j] = key[j] * card + std::min(band, card - 1);
+                    }
+                }
+            }
+
+            for (size_t j = 0; j < n; ++j) {
+                if (!keep[j]) continue;
+                out.counts[key[j]] += 1;
+                out.gpaSums[key[j]] += g[j];
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    size_t perThread = (rows + threads - 1) / threads;
+    for (size_t t = 1; t < threads; ++t) {
+        size_t begin = std::min(rows, t * perThread);
+        size_t end = std::min(rows, begin + perThread);
+        workers.emplace_back(scan, begin, end, std::ref(partials[t]));
+    }
+    scan(0, std::min(rows, perThread), partials[0]);
+    for (auto& w : workers) w.join();
+
+    Partial& merged = partials[0];
+    for (size_t t = 1; t < threads; ++t) {
+        for (uint64_t k = 0; k < groups; ++k) {
+            merged.counts[k] += partials[t].counts[k];
+            merged.gpaSums[k] += partials[t].gpaSums[k];
+        }
+    }
+
+    std::vector<uint32_t> keys;
+    int64_t total = 0;
+    for (uint64_t k = 0; k < groups; ++k) {
+        if (merged.counts[k] == 0) continue;
+        keys.push_back(static_cast<uint32_t>(k));
+        total += merged.counts[k];
+    }
+    std::stable_sort(keys.begin(), keys.end(),
+                     [&merged](uint32_t a, uint32_t b) { return merged.counts[a] > merged.counts[b]; });
+
+    Json::Value outRows(Json::arrayValue);
+    for (uint32_t k : keys) {
+        Json::Value row;
+        uint32_t rest = k;
+        for (size_t d = dims.size(); d-- > 0;) {
+            uint32_t code = rest % dims[d].cardinality;
+            rest /= dims[d].cardinality;
+            row[dims[d].name] = dims[d].column ? dims[d].column->dict.labels[code] : bandLabel(code, bandWidth);
+        }
+        int64_t count = merged.counts[k];
+        row["count"] = static_cast<Json::Int64>(count);
+        row["avg_gpa"] = std::round(merged.gpaSums[k] / count * 100.0) / 100.0;
+        outRows.append(row);
+    }
+
+    result["success"] = true;
+    result["source"] = source;
+    result["group_by"] = groupBy.isNull() ? Json::Value(Json::arrayValue) : groupBy;
+    result["rows"] = outRows;
+    result["total"] = static_cast<Json::Int64>(total);
+    result["rows_scanned"] = static_cast<Json::UInt64>(rows);
+    result["threads"] = static_cast<Json::UInt64>(threads);
+    result["snapshot_as_of"] = isoTimestamp(snap->asOf);
+    result["took_us"] = static_cast<Json::Int64>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - started).count());
+    return result;
+}
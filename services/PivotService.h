@@ -0,0 +1,75 @@
+#pragma once
+
+#include <json/json.h>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Columnar snapshot of students and applications for ad-hoc TPO pivots.
+// Categorical columns are dictionary-encoded so a group-by is integer math
+// over flat arrays; the snapshot is rebuilt periodically in the background.
+class PivotService {
+public:
+    static PivotService& instance();
+
+    // Build the first snapshot and keep refreshing every PIVOT_REFRESH_SECONDS
+    void start();
+    void refresh();
+
+    // Dimensions and their values, for building pivot UIs
+    Json::Value schema() const;
+    // { source, group_by: [...], filters: {column: [values]}, min_gpa, max_gpa, gpa_band }
+    Json::Value pivot(const Json::Value& request) const;
+
+private:
+    struct Dictionary {
+        std::vector<std::string> keys;
+        std::vector<std::string> labels;
+        std::unordered_map<std::string, uint16_t> codes;
+        // Code shared by every value past the last one that fits, labelled
+        // "Other"; -1 until the dictionary overflows
+        int32_t overflow = -1;
+
+        uint16_t encode(const std::string& key, const std::string& label);
+    };
+
+    struct Column {
+        Dictionary dict;
+        std::vector<uint16_t> codes;
+    };
+
+    struct Table {
+        size_t rows = 0;
+        std::map<std::string, Column> columns;
+        std::vector<float> gpa;
+    };
+
+    struct Snapshot {
+        Table students;
+        Table applications;
+        std::chrono::system_clock::time_point asOf;
+        int64_t buildMs = 0;
+    };
+
+    PivotService() = default;
+    ~PivotService();
+    PivotService(const PivotService&) = delete;
+    PivotService& operator=(const PivotService&) = delete;
+
+    std::shared_ptr<const Snapshot> current() const;
+
+    mutable std::mutex mutex_;
+    std::shared_ptr<const Snapshot> snapshot_;
+
+    std::mutex stopMutex_;
+    std::condition_variable stopCv_;
+    bool stopping_ = false;
+    std::thread refresher_;
+};
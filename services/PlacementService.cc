@@ -1,93 +1,158 @@
 #include "PlacementService.h"
+#include "IdHelper.h"
 #include "MongoService.h"
 #include "JsonHelper.h"
+#include "StatsService.h"
+#include "RollupService.h"
+#include "DriveCatalog.h"
+#include "WorkQueue.h"
 #include <bsoncxx/builder/basic/document.hpp>
 #include <bsoncxx/builder/basic/kvp.hpp>
 #include <bsoncxx/builder/basic/array.hpp>
 #include <mongocxx/pipeline.hpp>
+#include <atomic>
 #include <chrono>
-#include <set>
-#include <map>
+#include <cstdlib>
+#include <ctime>
+#include <memory>
+#include <mutex>
 
 using bsoncxx::builder::basic::kvp;
 using bsoncxx::builder::basic::make_document;
 using bsoncxx::builder::basic::make_array;
 
+namespace {
+
+// Snapshot of the analytics payload shared by every dashboard poll.
+// Once older than the TTL it is still served while one background refresh runs.
+struct AnalyticsSnapshot {
+    Json::Value payload;
+    std::chrono::system_clock::time_point asOf;
+};
+
+std::mutex snapshotMutex;
+std::shared_ptr<const AnalyticsSnapshot> snapshot;
+std::atomic<bool> refreshing{false};
+
+std::chrono::seconds analyticsTtl() {
+    static const std::chrono::seconds ttl = []() {
+        const char* env = std::getenv("ANALYTICS_CACHE_TTL_SECONDS");
+        long seconds = env ? std::strtol(env, nullptr, 10) : 30;
+        return std::chrono::seconds(seconds > 0 ? seconds : 30);
+    }();
+    return ttl;
+}
+
+std::string isoTimestamp(std::chrono::system_clock::time_point tp) {
+    std::time_t t = std::chrono::system_clock::to_time_t(tp);
+    std::tm tm{};
+    gmtime_r(&t, &tm);
+    char buf[32];
+    std::strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%SZ", &tm);
+    return buf;
+}
+
+std::shared_ptr<const AnalyticsSnapshot> buildSnapshot() {
+    StatsService::instance().refresh();
+    auto built = std::make_shared<AnalyticsSnapshot>();
+    built->payload = StatsService::instance().analytics();
+    built->asOf = std::chrono::system_clock::now();
+
+    std::lock_guard<std::mutex> lock(snapshotMutex);
+    snapshot = built;
+    return built;
+}
+
+WorkQueue& refreshQueue() {
+    static WorkQueue queue("analytics-refresh", 1);
+    return queue;
+}
+
+WorkQueue& statusEffectsQueue() {
+    static WorkQueue queue("status-effects", 2);
+    return queue;
+}
+
+} // anonymous namespace
+
 bool PlacementService::isValidStatusTransition(const std::string& current, const std::string& next) {
-    static const std::map<std::string, std::set<std::string>> transitions = {
-        {"APPLIED", {"SHORTLISTED", "REJECTED"}},
-        {"SHORTLISTED", {"INTERVIEWED", "REJECTED"}},
-        {"INTERVIEWED", {"SELECTED", "REJECTED"}},
-        {"SELECTED", {}},
-        {"REJECTED", {}}
-    };
-
-    auto it = transitions.find(current);
-    if (it == transitions.end()) return false;
-    return it->second.count(next) > 0;
+    auto from = ApplicationStatus::parse(current);
+    auto to = ApplicationStatus::parse(next);
+    return from && to && ApplicationStatus::canTransition(*from, *to);
 }
 
-Json::Value PlacementService::getAnalytics() {
-    Json::Value result;
+std::vector<std::string> PlacementService::predecessorsOf(AppStatus next) {
+    std::vector<std::string> from;
+    uint8_t mask = ApplicationStatus::predecessors(next);
+    for (AppStatus s : ApplicationStatus::all()) {
+        if (mask & ApplicationStatus::bit(s)) from.emplace_back(ApplicationStatus::name(s));
+    }
+    return from;
+}
 
-    auto client = MongoService::instance().acquireClient();
-    auto students = MongoService::instance().getCollection(client, "students");
-    auto companies = MongoService::instance().getCollection(client, "companies");
-    auto applications = MongoService::instance().getCollection(client, "applications");
-
-    // Total counts
-    int64_t totalStudents = students.count_documents({});
-    int64_t totalCompanies = companies.count_documents({});
-    int64_t totalApplications = applications.count_documents({});
-
-    // Placed students count
-    int64_t placedStudents = applications.count_documents(
-        make_document(kvp("status", "SELECTED"))
-    );
+void PlacementService::onStatusChanged(const std::string& studentId, const std::string& companyId,
+                                       AppStatus from, AppStatus to, bool notify) {
+    std::string toName(ApplicationStatus::name(to));
+    StatsService::instance().onStatusChanged(companyId, from, to);
+    RollupService::record(studentId, toName);
 
-    double placementPercentage = totalStudents > 0
-        ? (static_cast<double>(placedStudents) / totalStudents) * 100.0
-        : 0.0;
+    if (notify) {
+        createNotification(studentId,
+            "Your application status for " + DriveCatalog::instance().companyName(companyId) +
+            " has been updated to " + toName, "status_update");
+    }
 
-    result["success"] = true;
-    result["analytics"]["total_students"] = static_cast<Json::Int64>(totalStudents);
-    result["analytics"]["total_companies"] = static_cast<Json::Int64>(totalCompanies);
-    result["analytics"]["total_applications"] = static_cast<Json::Int64>(totalApplications);
-    result["analytics"]["placed_students"] = static_cast<Json::Int64>(placedStudents);
-    result["analytics"]["placement_percentage"] = placementPercentage;
-
-    // Application status distribution
-    Json::Value statusDist;
-    for (const auto& status : {"APPLIED", "SHORTLISTED", "INTERVIEWED", "SELECTED", "REJECTED"}) {
-        int64_t count = applications.count_documents(
-            make_document(kvp("status", status))
+    // If selected, update student's placement_status
+    if (to == AppStatus::Selected) {
+        auto client = MongoService::instance().acquireClient();
+        auto students = MongoService::instance().getCollection(client, "students");
+        students.update_one(
+            make_document(kvp("user_id", IdHelper::match(studentId).view())),
+            make_document(kvp("$set", make_document(kvp("placement_status", "SELECTED"))))
         );
-        statusDist[status] = static_cast<Json::Int64>(count);
     }
-    result["analytics"]["status_distribution"] = statusDist;
+}
 
-    // Department-wise stats
-    mongocxx::pipeline pipe;
-    pipe.group(
-        make_document(kvp("_id", "$department"),
-                      kvp("count", make_document(kvp("$sum", 1))))
-    );
-    pipe.sort(make_document(kvp("count", -1)));
-
-    Json::Value deptStats(Json::arrayValue);
-    auto cursor = students.aggregate(pipe);
-    for (auto& doc : cursor) {
-        Json::Value dept;
-        if (doc["_id"].type() == bsoncxx::type::k_string) {
-            dept["department"] = std::string(doc["_id"].get_string().value);
-        } else {
-            dept["department"] = "Unknown";
+void PlacementService::dispatchStatusChange(const std::string& studentId, const std::string& companyId,
+                                            AppStatus from, AppStatus to, bool notify) {
+    statusEffectsQueue().post([studentId, companyId, from, to, notify]() {
+        onStatusChanged(studentId, companyId, from, to, notify);
+    });
+}
+
+Json::Value PlacementService::getAnalytics() {
+    std::shared_ptr<const AnalyticsSnapshot> current;
+    {
+        std::lock_guard<std::mutex> lock(snapshotMutex);
+        current = snapshot;
+    }
+
+    auto now = std::chrono::system_clock::now();
+    if (!current) {
+        // Cold start: the first caller builds it inline, the rest wait for it
+        static std::mutex coldStart;
+        std::lock_guard<std::mutex> building(coldStart);
+        {
+            std::lock_guard<std::mutex> lock(snapshotMutex);
+            current = snapshot;
         }
-        dept["count"] = doc["count"].get_int32().value;
-        deptStats.append(dept);
+        if (!current) current = buildSnapshot();
+    } else if (now - current->asOf >= analyticsTtl() && !refreshing.exchange(true)) {
+        refreshQueue().post([]() {
+            try {
+                buildSnapshot();
+            } catch (...) {
+                refreshing = false;
+                throw;
+            }
+            refreshing = false;
+        });
     }
-    result["analytics"]["department_stats"] = deptStats;
 
+    Json::Value result = current->payload;
+    result["as_of"] = isoTimestamp(current->asOf);
+    result["age_seconds"] = static_cast<Json::Int64>(
+        std::chrono::duration_cast<std::chrono::seconds>(now - current->asOf).count());
     return result;
 }
 
@@ -97,7 +162,7 @@ Json::Value PlacementService::createNotification(const std::string& userId, cons
     auto now = bsoncxx::types::b_date{std::chrono::system_clock::now()};
 
     auto doc = make_document(
-        kvp("user_id", userId),
+        kvp("user_id", IdHelper::ref(userId).view()),
         kvp("message", message),
         kvp("type", type),
         kvp("read", false),
@@ -1,11 +1,25 @@
 #pragma once
 
+#include "ApplicationStatus.h"
 #include <json/json.h>
 #include <string>
+#include <vector>
 
 class PlacementService {
 public:
+    // String form for callers at the API edge; unknown statuses are never valid
     static bool isValidStatusTransition(const std::string& current, const std::string& next);
+    // Stored names of the statuses from which `next` can be reached in one step
+    static std::vector<std::string> predecessorsOf(AppStatus next);
+
+    // Bookkeeping after an application moves from -> to: counters, rollups,
+    // the student's placement_status and (optionally) their notification
+    static void onStatusChanged(const std::string& studentId, const std::string& companyId,
+                                AppStatus from, AppStatus to, bool notify);
+    // Same, run on a background worker so the request returns first
+    static void dispatchStatusChange(const std::string& studentId, const std::string& companyId,
+                                     AppStatus from, AppStatus to, bool notify);
+
     static Json::Value getAnalytics();
     static Json::Value createNotification(const std::string& userId, const std::string& message, const std::string& type);
 };
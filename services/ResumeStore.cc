@@ -0,0 +1,493 @@
+#include "ResumeStore.h"
+#include "IdHelper.h"
+#include "JwtHelper.h"
+#include "MongoService.h"
+#include "WorkQueue.h"
+#include <bsoncxx/builder/basic/array.hpp>
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/builder/basic/kvp.hpp>
+#include <bsoncxx/types.hpp>
+#include <mongocxx/options/find_one_and_update.hpp>
+#include <mongocxx/pipeline.hpp>
+#include <openssl/crypto.h>
+#include <openssl/hmac.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <map>
+#include <random>
+#include <system_error>
+
+namespace fs = std::filesystem;
+
+using bsoncxx::builder::basic::kvp;
+using bsoncxx::builder::basic::make_array;
+using bsoncxx::builder::basic::make_document;
+
+namespace {
+
+constexpr char kPdfMagic[] = "%PDF-";
+constexpr size_t kPdfMagicLength = sizeof(kPdfMagic) - 1;
+
+// Temp files older than this belong to uploads that will never finish
+constexpr auto kStaleTempAge = std::chrono::hours(1);
+
+const char* kTombstoneSuffix = ".gc";
+
+std::string randomName() {
+    static thread_local std::mt19937_64 rng{std::random_device{}()};
+    static const char* hex = "0123456789abcdef";
+    std::string name;
+    uint64_t bits = rng();
+    for (int i = 0; i < 16; ++i) {
+        name += hex[bits & 0xf];
+        bits >>= 4;
+    }
+    return name;
+}
+
+std::string toHex(const unsigned char* bytes, unsigned int length) {
+    static const char* hex = "0123456789abcdef";
+    std::string out;
+    out.reserve(length * 2);
+    for (unsigned int i = 0; i < length; ++i) {
+        out += hex[bytes[i] >> 4];
+        out += hex[bytes[i] & 0xf];
+    }
+    return out;
+}
+
+// Served by ResumeController; the version pins the URL to one content
+std::string resumeUrl(const std::string& userId, const std::string& sha256) {
+    return "/api/resumes/" + userId + "?v=" + sha256;
+}
+
+long linkTtlSeconds() {
+    const char* env = std::getenv("RESUME_LINK_TTL");
+    long value = env ? std::strtol(env, nullptr, 10) : 0;
+    return value > 0 ? value : 600;
+}
+
+std::string linkSignature(const std::string& userId, const std::string& expires) {
+    std::string key = JwtHelper::getSecret();
+    std::string data = userId + ":" + expires;
+    unsigned char mac[EVP_MAX_MD_SIZE];
+    unsigned int length = 0;
+    HMAC(EVP_sha256(), key.data(), static_cast<int>(key.size()),
+         reinterpret_cast<const unsigned char*>(data.data()), data.size(), mac, &length);
+    return toHex(mac, length);
+}
+
+int64_t refsOf(const bsoncxx::document::element& el) {
+    if (!el) return 0;
+    if (el.type() == bsoncxx::type::k_int32) return el.get_int32().value;
+    if (el.type() == bsoncxx::type::k_int64) return el.get_int64().value;
+    return 0;
+}
+
+WorkQueue& gcQueue() {
+    static WorkQueue queue("resume-gc", 1);
+    return queue;
+}
+
+// Deletes one blob if nothing references it. The file is first renamed to a
+// tombstone so an upload that revives the hash meanwhile either re-creates
+// the file itself or gets the tombstone renamed back.
+bool collectBlob(mongocxx::collection& blobs, const std::string& sha256, uint64_t& bytesFreed) {
+    std::error_code ec;
+    fs::path path = ResumeStore::blobPath(sha256);
+    fs::path tombstone = path.string() + kTombstoneSuffix;
+    uint64_t size = fs::file_size(path, ec);
+    if (ec) size = 0;
+    fs::rename(path, tombstone, ec);
+
+    auto result = blobs.delete_one(make_document(
+        kvp("_id", sha256), kvp("refs", make_document(kvp("$lte", 0)))));
+    if (result && result->deleted_count() > 0) {
+        fs::remove(tombstone, ec);
+        bytesFreed += size;
+        return true;
+    }
+
+    // Referenced again: put the file back unless the new upload already did
+    if (fs::exists(path, ec)) {
+        fs::remove(tombstone, ec);
+    } else {
+        fs::rename(tombstone, path, ec);
+    }
+    return false;
+}
+
+// Drops one reference; a blob that reaches zero is collected in the background
+void release(mongocxx::collection& blobs, const std::string& sha256) {
+    mongocxx::options::find_one_and_update opts;
+    opts.return_document(mongocxx::options::return_document::k_after);
+    opts.projection(make_document(kvp("refs", 1)));
+    auto after = blobs.find_one_and_update(
+        make_document(kvp("_id", sha256)),
+        make_document(kvp("$inc", make_document(kvp("refs", -1)))),
+        opts);
+    if (!after || refsOf(after->view()["refs"]) > 0) return;
+
+    gcQueue().post([sha256]() {
+        try {
+            auto client = MongoService::instance().acquireClient();
+            auto blobs = MongoService::instance().getCollection(client, "resume_blobs");
+            uint64_t freed = 0;
+            collectBlob(blobs, sha256, freed);
+        } catch (const std::exception& e) {
+            std::cerr << "Warning: Resume blob cleanup for " << sha256 << ": " << e.what() << std::endl;
+        }
+    });
+}
+
+} // anonymous namespace
+
+std::string ResumeStore::uploadDir() {
+    return "./uploads";
+}
+
+std::string ResumeStore::blobPath(const std::string& sha256) {
+    return uploadDir() + "/blobs/" + sha256.substr(0, 2) + "/" + sha256 + ".pdf";
+}
+
+std::string ResumeStore::signedUrl(const std::string& userId, const std::string& sha256) {
+    // Rounded up to the minute so repeated fetches hand out the same URL
+    // and the browser cache still gets hits
+    auto now = std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    std::string expires = std::to_string((now + linkTtlSeconds() + 59) / 60 * 60);
+    std::string url = "/api/resumes/" + userId + "/signed?";
+    if (!sha256.empty()) url += "v=" + sha256 + "&";
+    return url + "expires=" + expires + "&sig=" + linkSignature(userId, expires);
+}
+
+void ResumeStore::signResumeUrl(Json::Value& student) {
+    if (!student.isObject() || student["resume_url"].asString().empty()) return;
+    std::string userId = student["user_id"].asString();
+    if (userId.empty()) return;
+    student["resume_url"] = signedUrl(userId, student["resume_hash"].asString());
+}
+
+long ResumeStore::verifySignedUrl(const std::string& userId, const std::string& expires,
+                                  const std::string& signature) {
+    if (expires.empty() || expires.size() > 12 ||
+        expires.find_first_not_of("0123456789") != std::string::npos) return -1;
+    std::string expected = linkSignature(userId, expires);
+    if (signature.size() != expected.size() ||
+        CRYPTO_memcmp(signature.data(), expected.data(), expected.size()) != 0) return -1;
+    auto now = std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    long left = std::stol(expires) - static_cast<long>(now);
+    return left > 0 ? left : -1;
+}
+
+std::string ResumeStore::etag(const std::string& sha256) {
+    return "\"" + sha256 + "\"";
+}
+
+std::string ResumeStore::errorMessage(Error error) {
+    switch (error) {
+        case Error::NotPdf: return "Only PDF files are allowed";
+        case Error::TooLarge: return "File size must be under 5MB";
+        case Error::Io: return "Failed to store file";
+        case Error::NoStudent: return "Student profile not found";
+        default: return "";
+    }
+}
+
+ResumeStore::Upload::Upload() : hash_(EVP_MD_CTX_new(), EVP_MD_CTX_free) {
+    std::error_code ec;
+    fs::path tmpDir = fs::path(uploadDir()) / ".tmp";
+    fs::create_directories(tmpDir, ec);
+    tmpPath_ = (tmpDir / (randomName() + ".part")).string();
+    out_.open(tmpPath_, std::ios::binary | std::ios::trunc);
+    if (!out_ || !hash_ || EVP_DigestInit_ex(hash_.get(), EVP_sha256(), nullptr) != 1) {
+        std::cerr << "Warning: Cannot start upload into " << tmpPath_ << std::endl;
+        error_ = Error::Io;
+    }
+}
+
+ResumeStore::Upload::~Upload() {
+    if (out_.is_open()) out_.close();
+    if (!stored_) {
+        std::error_code ec;
+        fs::remove(tmpPath_, ec);
+    }
+}
+
+void ResumeStore::Upload::fail(Error error) {
+    error_ = error;
+    // Nothing more will be written; give the disk space back straight away
+    out_.close();
+    std::error_code ec;
+    fs::remove(tmpPath_, ec);
+}
+
+bool ResumeStore::Upload::append(const char* data, size_t length) {
+    if (error_ != Error::None) return false;
+    if (length > kMaxBytes - size_) {
+        fail(Error::TooLarge);
+        return false;
+    }
+
+    if (head_.size() < kPdfMagicLength) {
+        head_.append(data, std::min(length, kPdfMagicLength - head_.size()));
+        if (head_.compare(0, head_.size(), kPdfMagic, head_.size()) != 0) {
+            fail(Error::NotPdf);
+            return false;
+        }
+    }
+
+    out_.write(data, static_cast<std::streamsize>(length));
+    if (!out_ || EVP_DigestUpdate(hash_.get(), data, length) != 1) {
+        fail(Error::Io);
+        return false;
+    }
+    size_ += length;
+    return true;
+}
+
+bool ResumeStore::Upload::finish() {
+    if (error_ != Error::None) return false;
+    if (head_.size() < kPdfMagicLength) {
+        fail(Error::NotPdf);
+        return false;
+    }
+
+    out_.close();
+    unsigned char digest[EVP_MAX_MD_SIZE];
+    unsigned int digestLength = 0;
+    if (out_.fail() || EVP_DigestFinal_ex(hash_.get(), digest, &digestLength) != 1) {
+        fail(Error::Io);
+        return false;
+    }
+    sha256_ = toHex(digest, digestLength);
+    return true;
+}
+
+bool ResumeStore::attach(const std::string& userId, Upload& upload, Stored& out) {
+    if (!upload.finish()) return false;
+
+    const std::string& sha256 = upload.sha256_;
+    auto now = bsoncxx::types::b_date{std::chrono::system_clock::now()};
+
+    auto client = MongoService::instance().acquireClient();
+    auto students = MongoService::instance().getCollection(client, "students");
+    auto blobs = MongoService::instance().getCollection(client, "resume_blobs");
+    auto studentFilter = make_document(kvp("user_id", IdHelper::match(userId).view()));
+
+    mongocxx::options::find findOpts;
+    findOpts.projection(make_document(kvp("resume_hash", 1)));
+    auto current = students.find_one(studentFilter.view(), findOpts);
+    if (!current) {
+        upload.fail(Error::NoStudent);
+        return false;
+    }
+
+    out.sha256 = sha256;
+    out.url = resumeUrl(userId, sha256);
+    out.size = upload.size_;
+
+    std::error_code ec;
+    fs::path path = blobPath(sha256);
+
+    auto currentHash = current->view()["resume_hash"];
+    if (currentHash && currentHash.type() == bsoncxx::type::k_string &&
+        currentHash.get_string().value == sha256) {
+        // Re-upload of the same file: keep the blob and its count as they are
+        if (!fs::exists(path, ec)) {
+            fs::create_directories(path.parent_path(), ec);
+            fs::rename(upload.tmpPath_, path, ec);
+            if (ec) {
+                upload.fail(Error::Io);
+                return false;
+            }
+            upload.stored_ = true;
+        }
+        students.update_one(studentFilter.view(),
+            make_document(kvp("$set", make_document(kvp("resume_updated_at", now)))));
+        out.unchanged = true;
+        return true;
+    }
+
+    // Count the new reference before the file or profile can point at it,
+    // so a concurrent collection of the same hash backs off
+    mongocxx::options::update upsert;
+    upsert.upsert(true);
+    blobs.update_one(
+        make_document(kvp("_id", sha256)),
+        make_document(
+            kvp("$inc", make_document(kvp("refs", 1))),
+            kvp("$setOnInsert", make_document(
+                kvp("size", static_cast<int64_t>(upload.size_)), kvp("created_at", now)))),
+        upsert);
+
+    if (!fs::exists(path, ec)) {
+        fs::create_directories(path.parent_path(), ec);
+        // Same filesystem, so readers see either no file or the whole file
+        fs::rename(upload.tmpPath_, path, ec);
+        if (ec) {
+            std::cerr << "Warning: Cannot move upload into place: " << ec.message() << std::endl;
+            release(blobs, sha256);
+            upload.fail(Error::Io);
+            return false;
+        }
+        upload.stored_ = true;
+    }
+
+    mongocxx::options::find_one_and_update swapOpts;
+    swapOpts.projection(make_document(kvp("resume_hash", 1)));
+    auto before = students.find_one_and_update(
+        studentFilter.view(),
+        make_document(kvp("$set", make_document(
+            kvp("resume_hash", sha256),
+            kvp("resume_url", out.url),
+            kvp("resume_size", static_cast<int64_t>(upload.size_)),
+            kvp("resume_updated_at", now)))),
+        swapOpts);
+    if (!before) {
+        release(blobs, sha256);
+        upload.fail(Error::NoStudent);
+        return false;
+    }
+
+    auto previousHash = before->view()["resume_hash"];
+    if (previousHash && previousHash.type() == bsoncxx::type::k_string) {
+        std::string previous(previousHash.get_string().value);
+        // Equal when a concurrent upload of the same file swapped first; the
+        // profile already holds a reference, so drop the one counted above
+        release(blobs, previous);
+        if (previous == sha256) out.unchanged = true;
+    } else {
+        // Pre-store upload saved as uploads/resume_<id>.pdf, owned by this
+        // profile alone. Its resume_url may already have been rewritten to
+        // /api/resumes/<id> (rewriteLegacyUrls), so go by the id, not the URL.
+        fs::remove(uploadDir() + "/resume_" + userId + ".pdf", ec);
+    }
+    return true;
+}
+
+Json::Value ResumeStore::collectGarbage() {
+    auto client = MongoService::instance().acquireClient();
+    auto blobs = MongoService::instance().getCollection(client, "resume_blobs");
+    auto students = MongoService::instance().getCollection(client, "students");
+
+    int64_t blobsDeleted = 0;
+    int64_t orphanFiles = 0;
+    int64_t tempFiles = 0;
+    uint64_t bytesFreed = 0;
+    std::error_code ec;
+
+    // Unreferenced blobs whose background cleanup never ran
+    std::map<std::string, int64_t> recorded;
+    for (auto& doc : blobs.find({})) {
+        if (doc["_id"].type() != bsoncxx::type::k_string) continue;
+        std::string sha256(doc["_id"].get_string().value);
+        int64_t refs = refsOf(doc["refs"]);
+        if (refs <= 0 && collectBlob(blobs, sha256, bytesFreed)) {
+            blobsDeleted++;
+            continue;
+        }
+        recorded[sha256] = refs;
+    }
+
+    // Files with no record (a crash between rename and count) and leftover
+    // tombstones. Recent files are skipped: their upload may have been counted
+    // after the listing above.
+    auto cutoff = fs::file_time_type::clock::now() - kStaleTempAge;
+    fs::path blobDir = fs::path(uploadDir()) / "blobs";
+    if (fs::exists(blobDir, ec)) {
+        for (auto it = fs::recursive_directory_iterator(blobDir, ec);
+             !ec && it != fs::recursive_directory_iterator(); it.increment(ec)) {
+            if (!it->is_regular_file(ec)) continue;
+            fs::path file = it->path();
+            std::string name = file.filename().string();
+            bool tombstone = file.extension() == kTombstoneSuffix;
+            std::string sha256 = name.substr(0, name.find('.'));
+            if (recorded.count(sha256)) {
+                if (tombstone) {
+                    fs::path live = blobPath(sha256);
+                    if (fs::exists(live, ec)) fs::remove(file, ec);
+                    else fs::rename(file, live, ec);
+                }
+                continue;
+            }
+            std::error_code statError;
+            if (it->last_write_time(statError) >= cutoff || statError) continue;
+            uint64_t size = it->file_size(statError);
+            if (fs::remove(file, ec)) {
+                orphanFiles++;
+                if (!statError) bytesFreed += size;
+            }
+        }
+    }
+
+    // Temp files from uploads that were cut off mid-stream
+    fs::path tmpDir = fs::path(uploadDir()) / ".tmp";
+    if (fs::exists(tmpDir, ec)) {
+        for (auto& entry : fs::directory_iterator(tmpDir, ec)) {
+            if (entry.last_write_time(ec) < cutoff && fs::remove(entry.path(), ec)) tempFiles++;
+        }
+    }
+
+    // Counts that disagree with the profiles are reported, not rewritten:
+    // an upload in flight is legitimately ahead of its profile update
+    mongocxx::pipeline pipe;
+    pipe.match(make_document(kvp("resume_hash", make_document(kvp("$type", "string")))));
+    pipe.group(make_document(kvp("_id", "$resume_hash"), kvp("count", make_document(kvp("$sum", 1)))));
+    Json::Value mismatched(Json::arrayValue);
+    for (auto& doc : students.aggregate(pipe)) {
+        std::string sha256(doc["_id"].get_string().value);
+        int64_t actual = refsOf(doc["count"]);
+        auto it = recorded.find(sha256);
+        int64_t refs = it == recorded.end() ? 0 : it->second;
+        if (refs != actual) {
+            Json::Value entry;
+            entry["sha256"] = sha256;
+            entry["refs"] = static_cast<Json::Int64>(refs);
+            entry["profiles"] = static_cast<Json::Int64>(actual);
+            mismatched.append(entry);
+        }
+    }
+
+    Json::Value result;
+    result["success"] = true;
+    result["blobs_deleted"] = static_cast<Json::Int64>(blobsDeleted);
+    result["orphan_files_deleted"] = static_cast<Json::Int64>(orphanFiles);
+    result["temp_files_deleted"] = static_cast<Json::Int64>(tempFiles);
+    result["bytes_freed"] = static_cast<Json::UInt64>(bytesFreed);
+    result["refs_mismatched"] = mismatched;
+    return result;
+}
+
+void ResumeStore::rewriteLegacyUrls() {
+    try {
+        auto client = MongoService::instance().acquireClient();
+        auto students = MongoService::instance().getCollection(client, "students");
+
+        // /uploads/... pointed at the static file handler, which no longer serves resumes
+        auto userId = make_document(kvp("$toString", "$user_id"));
+        auto versioned = make_document(kvp("$concat", make_array(
+            "/api/resumes/", userId.view(), "?v=", "$resume_hash")));
+        auto bare = make_document(kvp("$concat", make_array("/api/resumes/", userId.view())));
+
+        mongocxx::pipeline update;
+        update.append_stage(make_document(kvp("$set", make_document(
+            kvp("resume_url", make_document(kvp("$cond", make_array(
+                make_document(kvp("$eq", make_array(make_document(kvp("$type", "$resume_hash")), "string"))),
+                versioned.view(), bare.view()))))))));
+
+        auto result = students.update_many(
+            make_document(kvp("resume_url", make_document(kvp("$regex", "^/uploads/")))), update);
+        if (result && result->modified_count() > 0) {
+            std::cout << "Resume URLs rewritten: " << result->modified_count() << std::endl;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Warning: Resume URL rewrite: " << e.what() << std::endl;
+        throw;
+    }
+}
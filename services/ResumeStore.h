@@ -0,0 +1,91 @@
+#pragma once
+
+#include <json/json.h>
+#include <openssl/evp.h>
+#include <cstddef>
+#include <fstream>
+#include <memory>
+#include <string>
+
+// Resume files on disk, stored once per distinct content under
+// uploads/blobs/<h[0..2]>/<sha256>.pdf. Uploads are streamed chunk by chunk
+// into a temp file under uploads/.tmp while being hashed, so a request never
+// holds more than one network chunk of the PDF in memory.
+//
+// resume_blobs {_id: sha256, refs, size} counts the student profiles that
+// point at each blob; a blob whose count drops to zero is deleted.
+class ResumeStore {
+public:
+    static constexpr size_t kMaxBytes = 5 * 1024 * 1024;
+
+    enum class Error { None, NotPdf, TooLarge, Io, NoStudent };
+
+    class Upload {
+    public:
+        Upload();
+        // Removes the temp file unless it was moved into the store
+        ~Upload();
+        Upload(const Upload&) = delete;
+        Upload& operator=(const Upload&) = delete;
+
+        // Checks the %PDF- signature as soon as the first bytes arrive and the
+        // size on every chunk; once it fails, later chunks are dropped
+        bool append(const char* data, size_t length);
+
+        Error error() const { return error_; }
+        size_t size() const { return size_; }
+
+    private:
+        friend class ResumeStore;
+
+        void fail(Error error);
+        // Closes the file and finalizes the hash
+        bool finish();
+
+        std::string tmpPath_;
+        std::ofstream out_;
+        std::unique_ptr<EVP_MD_CTX, void (*)(EVP_MD_CTX*)> hash_;
+        std::string sha256_;
+        std::string head_;
+        size_t size_ = 0;
+        Error error_ = Error::None;
+        bool stored_ = false;
+    };
+
+    struct Stored {
+        std::string sha256;
+        std::string url;
+        size_t size = 0;
+        // Same content as the profile already had; only metadata changed
+        bool unchanged = false;
+    };
+
+    // Moves a finished upload into the store and points the student's
+    // profile at it. On failure `upload.error()` says why.
+    static bool attach(const std::string& userId, Upload& upload, Stored& out);
+
+    // Deletes blobs with no references, blobs on disk without a record and
+    // stale temp files left by interrupted uploads
+    static Json::Value collectGarbage();
+
+    // Points profiles saved with /uploads/... URLs at the download endpoint;
+    // logs and rethrows on failure
+    static void rewriteLegacyUrls();
+
+    // Short-lived link to the download endpoint that needs no Authorization
+    // header, so <a href> and window.open work. HMAC-signed with JWT_SECRET
+    // and valid for RESUME_LINK_TTL seconds (default 600).
+    static std::string signedUrl(const std::string& userId, const std::string& sha256);
+    // Replaces a student document's resume_url with a signed link. Only for
+    // responses whose caller may already download that resume.
+    static void signResumeUrl(Json::Value& student);
+    // Seconds the link has left, or -1 when the signature is wrong or expired
+    static long verifySignedUrl(const std::string& userId, const std::string& expires,
+                                const std::string& signature);
+
+    static std::string uploadDir();
+    static std::string blobPath(const std::string& sha256);
+    // Strong validator for downloads: identical bytes, identical hash
+    static std::string etag(const std::string& sha256);
+    static std::string errorMessage(Error error);
+};
@@ -0,0 +1,191 @@
+#include "ResumeTextService.h"
+#include "IdHelper.h"
+#include "MongoService.h"
+#include "PdfText.h"
+#include "ResumeStore.h"
+#include "StudentIndexService.h"
+#include <bsoncxx/builder/basic/array.hpp>
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/builder/basic/kvp.hpp>
+#include <bsoncxx/types.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+using bsoncxx::builder::basic::kvp;
+using bsoncxx::builder::basic::make_array;
+using bsoncxx::builder::basic::make_document;
+
+namespace {
+
+long envOr(const char* name, long fallback) {
+    const char* env = std::getenv(name);
+    long value = env ? std::strtol(env, nullptr, 10) : 0;
+    return value > 0 ? value : fallback;
+}
+
+// Parsing is CPU-bound; more workers than this would compete with the HTTP threads
+size_t workerCount() {
+    return static_cast<size_t>(std::min(envOr("RESUME_TEXT_WORKERS", 2), 8L));
+}
+
+bool readFile(const std::string& path, std::string& out) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    std::ostringstream ss;
+    ss << in.rdbuf();
+    out = ss.str();
+    return true;
+}
+
+} // anonymous namespace
+
+ResumeTextService& ResumeTextService::instance() {
+    static ResumeTextService svc;
+    return svc;
+}
+
+ResumeTextService::ResumeTextService()
+    : maxQueued_(static_cast<size_t>(envOr("RESUME_TEXT_QUEUE", 256))),
+      workers_("resume-text", workerCount()) {}
+
+bool ResumeTextService::enqueue(const std::string& userId, const std::string& sha256) {
+    if (workers_.depth() >= maxQueued_) {
+        ++dropped_;
+        backfillWanted_ = true;
+        return false;
+    }
+    workers_.post([this, userId, sha256]() {
+        process(userId, sha256);
+        // Jobs were dropped while the queue was full; sweep for them once it drains
+        if (workers_.depth() == 0 && backfillWanted_) backfill();
+    });
+    return true;
+}
+
+void ResumeTextService::backfill() {
+    if (backfillRunning_.exchange(true)) {
+        backfillWanted_ = true;  // rerun once the current pass is done
+        return;
+    }
+    backfillWanted_ = false;
+    workers_.post([this]() { runBackfill(); });
+}
+
+void ResumeTextService::process(const std::string& userId, const std::string& sha256) {
+    ++running_;
+    try {
+        std::vector<std::string> keywords;
+        if (reuse(sha256, keywords)) {
+            if (save(userId, sha256, keywords)) ++reused_;
+        } else {
+            std::string pdf;
+            if (!readFile(ResumeStore::blobPath(sha256), pdf)) {
+                // Replaced and collected before we got to it
+                ++failed_;
+            } else {
+                keywords = PdfText::keywords(PdfText::extract(pdf), kMaxKeywords);
+                if (save(userId, sha256, keywords)) ++processed_;
+            }
+        }
+    } catch (const std::exception& e) {
+        ++failed_;
+        std::cerr << "Warning: Resume keyword extraction for " << userId << ": " << e.what() << std::endl;
+    }
+    --running_;
+}
+
+bool ResumeTextService::reuse(const std::string& sha256, std::vector<std::string>& keywords) {
+    auto client = MongoService::instance().acquireClient();
+    auto students = MongoService::instance().getCollection(client, "students");
+    mongocxx::options::find opts;
+    opts.projection(make_document(kvp("resume_keywords", 1)));
+    auto doc = students.find_one(make_document(kvp("resume_keywords_hash", sha256)), opts);
+    if (!doc) return false;
+    auto arr = doc->view()["resume_keywords"];
+    if (!arr || arr.type() != bsoncxx::type::k_array) return false;
+    for (auto& kw : arr.get_array().value) {
+        if (kw.type() == bsoncxx::type::k_string) keywords.emplace_back(kw.get_string().value);
+    }
+    return true;
+}
+
+bool ResumeTextService::save(const std::string& userId, const std::string& sha256,
+                             const std::vector<std::string>& keywords) {
+    bsoncxx::builder::basic::array arr;
+    for (const auto& kw : keywords) arr.append(kw);
+
+    auto client = MongoService::instance().acquireClient();
+    auto students = MongoService::instance().getCollection(client, "students");
+    auto now = bsoncxx::types::b_date{std::chrono::system_clock::now()};
+    // Conditional on resume_hash: a newer upload that landed meanwhile wins
+    auto result = students.update_one(
+        make_document(kvp("user_id", IdHelper::match(userId).view()), kvp("resume_hash", sha256)),
+        make_document(kvp("$set", make_document(
+            kvp("resume_keywords", arr),
+            kvp("resume_keywords_hash", sha256),
+            kvp("resume_keywords_at", now)))));
+    if (!result || result->matched_count() == 0) return false;
+
+    StudentIndexService::instance().setResumeKeywords(userId, keywords);
+    return true;
+}
+
+void ResumeTextService::runBackfill() {
+    auto started = std::chrono::steady_clock::now();
+    size_t done = 0;
+    try {
+        std::vector<std::pair<std::string, std::string>> pending;
+        {
+            auto client = MongoService::instance().acquireClient();
+            auto students = MongoService::instance().getCollection(client, "students");
+            mongocxx::options::find opts;
+            opts.projection(make_document(kvp("user_id", 1), kvp("resume_hash", 1)));
+            auto cursor = students.find(make_document(
+                kvp("resume_hash", make_document(kvp("$type", "string"))),
+                kvp("$expr", make_document(kvp("$ne", make_array("$resume_hash", "$resume_keywords_hash"))))),
+                opts);
+            for (auto& doc : cursor) {
+                std::string userId = IdHelper::str(doc["user_id"]);
+                if (!userId.empty()) {
+                    pending.emplace_back(userId, std::string(doc["resume_hash"].get_string().value));
+                }
+            }
+        }
+
+        // Runs on this worker rather than through the queue, so a large
+        // backlog cannot crowd out fresh uploads or overflow the queue
+        for (const auto& [userId, sha256] : pending) {
+            process(userId, sha256);
+            ++done;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Warning: Resume keyword backfill: " << e.what() << std::endl;
+    }
+    backfillRunning_ = false;
+    if (backfillWanted_) backfill();
+
+    if (done > 0) {
+        auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - started).count();
+        std::cout << "Resume keyword backfill: " << done << " profiles in " << elapsedMs << "ms" << std::endl;
+    }
+}
+
+Json::Value ResumeTextService::status() const {
+    Json::Value result;
+    result["success"] = true;
+    result["workers"] = static_cast<Json::UInt64>(workers_.workers());
+    result["queued"] = static_cast<Json::UInt64>(workers_.depth());
+    result["max_queued"] = static_cast<Json::UInt64>(maxQueued_);
+    result["running"] = static_cast<Json::UInt64>(running_.load());
+    result["processed"] = static_cast<Json::UInt64>(processed_.load());
+    result["reused"] = static_cast<Json::UInt64>(reused_.load());
+    result["failed"] = static_cast<Json::UInt64>(failed_.load());
+    result["dropped"] = static_cast<Json::UInt64>(dropped_.load());
+    result["backfill_running"] = backfillRunning_.load();
+    return result;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "WorkQueue.h"
+#include <json/json.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Keyword extraction from uploaded resumes, off the request path. Uploads
+// queue a job and return; a fixed pool of workers (RESUME_TEXT_WORKERS)
+// pulls text out of the PDF, stores the keywords on the student profile as
+// resume_keywords and feeds them to StudentIndexService for search.
+//
+// The queue holds at most RESUME_TEXT_QUEUE jobs. Jobs that do not fit are
+// not lost: resume_keywords_hash records which resume the keywords came
+// from, and a backfill pass picks up every profile where it is behind.
+class ResumeTextService {
+public:
+    static constexpr size_t kMaxKeywords = 100;
+
+    static ResumeTextService& instance();
+
+    // false when the queue is full; a later backfill covers it
+    bool enqueue(const std::string& userId, const std::string& sha256);
+
+    // Queues a pass over profiles whose keywords are missing or stale
+    void backfill();
+
+    Json::Value status() const;
+
+private:
+    ResumeTextService();
+    ResumeTextService(const ResumeTextService&) = delete;
+    ResumeTextService& operator=(const ResumeTextService&) = delete;
+
+    void process(const std::string& userId, const std::string& sha256);
+    void runBackfill();
+    // Keywords already extracted for the same blob on another profile
+    static bool reuse(const std::string& sha256, std::vector<std::string>& keywords);
+    static bool save(const std::string& userId, const std::string& sha256,
+                     const std::vector<std::string>& keywords);
+
+    size_t maxQueued_;
+    std::atomic<size_t> running_{0};
+    std::atomic<uint64_t> processed_{0};
+    std::atomic<uint64_t> reused_{0};
+    std::atomic<uint64_t> failed_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<bool> backfillRunning_{false};
+    std::atomic<bool> backfillWanted_{false};
+
+    // Last member: workers stop before the counters they touch go away
+    WorkQueue workers_;
+};
@@ -0,0 +1,423 @@
+#include "RollupService.h"
+#include "IdHelper.h"
+#include "MongoService.h"
+#include "StudentIndexService.h"
+#include <bsoncxx/builder/basic/array.hpp>
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/builder/basic/kvp.hpp>
+#include <bsoncxx/types.hpp>
+#include <mongocxx/pipeline.hpp>
+#include <mongocxx/model/replace_one.hpp>
+#include <mongocxx/model/update_one.hpp>
+#include <mongocxx/model/write.hpp>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <exception>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <shared_mutex>
+#include <utility>
+#include <vector>
+
+using bsoncxx::builder::basic::kvp;
+using bsoncxx::builder::basic::make_array;
+using bsoncxx::builder::basic::make_document;
+
+namespace {
+
+// Longest range served in one request, in days
+constexpr int64_t kMaxRangeDays = 731;
+
+// Days since 1970-01-01 for a proleptic Gregorian date
+int64_t daysFromCivil(int64_t y, unsigned m, unsigned d) {
+    y -= m <= 2;
+    const int64_t era = (y >= 0 ? y : y - 399) / 400;
+    const unsigned yoe = static_cast<unsigned>(y - era * 400);
+    const unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<int64_t>(doe) - 719468;
+}
+
+std::string civilFromDays(int64_t z) {
+    z += 719468;
+    const int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    const unsigned doe = static_cast<unsigned>(z - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp = (5 * doy + 2) / 153;
+    const unsigned d = doy - (153 * mp + 2) / 5 + 1;
+    const unsigned m = mp < 10 ? mp + 3 : mp - 9;
+    const int64_t y = static_cast<int64_t>(yoe) + era * 400 + (m <= 2);
+
+    char buf[16];
+    std::snprintf(buf, sizeof(buf), "%04lld-%02u-%02u", static_cast<long long>(y), m, d);
+    return buf;
+}
+
+int64_t parseDay(const std::string& day) {
+    return daysFromCivil(std::stoll(day.substr(0, 4)),
+                         static_cast<unsigned>(std::stoul(day.substr(5, 2))),
+                         static_cast<unsigned>(std::stoul(day.substr(8, 2))));
+}
+
+std::string today() {
+    std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+    std::tm tm{};
+    gmtime_r(&now, &tm);
+    char buf[16];
+    std::strftime(buf, sizeof(buf), "%Y-%m-%d", &tm);
+    return buf;
+}
+
+// First day of the bucket containing `day` (weeks start on Monday)
+int64_t bucketStart(int64_t day, const std::string& granularity) {
+    if (granularity == "week") {
+        // 1970-01-01 was a Thursday
+        int64_t weekday = ((day + 3) % 7 + 7) % 7;
+        return day - weekday;
+    }
+    if (granularity == "month") {
+        std::string date = civilFromDays(day);
+        return daysFromCivil(std::stoll(date.substr(0, 4)),
+                             static_cast<unsigned>(std::stoul(date.substr(5, 2))), 1);
+    }
+    return day;
+}
+
+int64_t nextBucket(int64_t start, const std::string& granularity) {
+    if (granularity == "week") return start + 7;
+    if (granularity == "month") {
+        std::string date = civilFromDays(start);
+        int64_t y = std::stoll(date.substr(0, 4));
+        unsigned m = static_cast<unsigned>(std::stoul(date.substr(5, 2)));
+        return m == 12 ? daysFromCivil(y + 1, 1, 1) : daysFromCivil(y, m + 1, 1);
+    }
+    return start + 1;
+}
+
+std::string departmentFor(const std::string& studentId) {
+    std::string department = StudentIndexService::instance().departmentOf(studentId);
+    if (!department.empty()) return department;
+
+    auto client = MongoService::instance().acquireClient();
+    auto students = MongoService::instance().getCollection(client, "students");
+    mongocxx::options::find opts;
+    opts.projection(make_document(kvp("department", 1)));
+    auto doc = students.find_one(make_document(kvp("user_id", IdHelper::match(studentId).view())), opts);
+    if (doc && doc->view()["department"] && doc->view()["department"].type() == bsoncxx::type::k_string) {
+        return std::string(doc->view()["department"].get_string().value);
+    }
+    return "Unknown";
+}
+
+// One $inc of a rollup document
+struct Increment {
+    std::string day;
+    std::string department;
+    std::string status;
+    int64_t count = 0;
+};
+
+// While rebuild() replaces the stored documents, increments go to the
+// journal and are applied on top of the rebuilt rollups afterwards
+struct RebuildState {
+    std::shared_mutex writeMutex;
+    bool journaling = false;
+    std::mutex journalMutex;
+    std::vector<Increment> journal;
+    // One rebuild at a time; they share the journal
+    std::mutex rebuildMutex;
+};
+
+RebuildState& rebuildState() {
+    static RebuildState state;
+    return state;
+}
+
+// Upserts the increments in one unordered bulk write
+void applyIncrements(const std::vector<Increment>& incs) {
+    if (incs.empty()) return;
+    auto client = MongoService::instance().acquireClient();
+    auto rollups = MongoService::instance().getCollection(client, "rollups");
+
+    std::vector<mongocxx::model::write> writes;
+    for (const auto& inc : incs) {
+        mongocxx::model::update_one op{
+            make_document(kvp("_id", inc.day + "|" + inc.department + "|" + inc.status)),
+            make_document(
+                kvp("$setOnInsert", make_document(
+                    kvp("day", inc.day), kvp("department", inc.department), kvp("status", inc.status))),
+                kvp("$inc", make_document(kvp("count", inc.count))))
+        };
+        op.upsert(true);
+        writes.emplace_back(std::move(op));
+    }
+    mongocxx::options::bulk_write opts;
+    opts.ordered(false);
+    rollups.bulk_write(writes, opts);
+}
+
+} // anonymous namespace
+
+bool RollupService::isValidDay(const std::string& day) {
+    if (day.size() != 10 || day[4] != '-' || day[7] != '-') return false;
+    for (size_t i = 0; i < day.size(); ++i) {
+        if (i == 4 || i == 7) continue;
+        if (day[i] < '0' || day[i] > '9') return false;
+    }
+    int month = std::stoi(day.substr(5, 2));
+    int dayOfMonth = std::stoi(day.substr(8, 2));
+    if (month < 1 || month > 12 || dayOfMonth < 1) return false;
+    // Round-trip rejects dates such as 2026-02-30
+    return civilFromDays(parseDay(day)) == day;
+}
+
+void RollupService::record(const std::string& studentId, const std::string& status) {
+    recordMany({studentId}, status);
+}
+
+void RollupService::recordMany(const std::vector<std::string>& studentIds, const std::string& status) {
+    if (studentIds.empty()) return;
+    try {
+        std::string day = today();
+        std::map<std::string, int64_t> perDepartment;
+        for (const auto& studentId : studentIds) perDepartment[departmentFor(studentId)] += 1;
+
+        std::vector<Increment> incs;
+        for (const auto& [department, n] : perDepartment) incs.push_back({day, department, status, n});
+
+        auto& state = rebuildState();
+        std::shared_lock<std::shared_mutex> writing(state.writeMutex);
+        if (state.journaling) {
+            std::lock_guard<std::mutex> lock(state.journalMutex);
+            state.journal.insert(state.journal.end(), incs.begin(), incs.end());
+            return;
+        }
+        applyIncrements(incs);
+    } catch (const std::exception& e) {
+        std::cerr << "Warning: Rollup update failed: " << e.what() << std::endl;
+    }
+}
+
+Json::Value RollupService::rebuild() {
+    auto& state = rebuildState();
+    std::lock_guard<std::mutex> rebuilding(state.rebuildMutex);
+
+    auto client = MongoService::instance().acquireClient();
+    auto applications = MongoService::instance().getCollection(client, "applications");
+    auto rollups = MongoService::instance().getCollection(client, "rollups");
+
+    auto department = make_document(kvp("$ifNull", make_array(
+        make_document(kvp("$arrayElemAt", make_array("$student.department", 0))), "Unknown")));
+    auto dayOf = [](const std::string& field) {
+        return make_document(kvp("$dateToString", make_document(
+            kvp("format", "%Y-%m-%d"), kvp("date", "$" + field))));
+    };
+
+    // Application dates come from applied_at; later statuses can only be
+    // dated by updated_at, so history before the last transition is lost.
+    // student_id and students.user_id may each be a hex string or an
+    // ObjectId (see IdHelper), and localField/foreignField compare raw BSON,
+    // so match user_id against both forms (as DrivePublishService does)
+    mongocxx::pipeline pipeline;
+    pipeline.lookup(make_document(
+        kvp("from", "students"),
+        kvp("let", make_document(
+            kvp("sid", make_document(kvp("$toString", "$student_id"))),
+            kvp("oid", make_document(kvp("$convert", make_document(
+                kvp("input", "$student_id"),
+                kvp("to", "objectId"),
+                kvp("onError", bsoncxx::types::b_null{}),
+                kvp("onNull", bsoncxx::types::b_null{})
+            ))))
+        )),
+        kvp("pipeline", make_array(
+            make_document(kvp("$match", make_document(
+                kvp("$expr", make_document(kvp("$or", make_array(
+                    make_document(kvp("$eq", make_array("$user_id", "$$sid"))),
+                    make_document(kvp("$eq", make_array("$user_id", "$$oid")))
+                ))))
+            ))),
+            make_document(kvp("$project", make_document(kvp("department", 1))))
+        )),
+        kvp("as", "student")));
+    pipeline.facet(make_document(
+        kvp("applied", make_array(
+            make_document(kvp("$match", make_document(kvp("applied_at", make_document(kvp("$type", "date")))))),
+            make_document(kvp("$group", make_document(
+                kvp("_id", make_document(kvp("day", dayOf("applied_at")), kvp("department", department.view()))),
+                kvp("count", make_document(kvp("$sum", 1))))))
+        )),
+        kvp("moved", make_array(
+            make_document(kvp("$match", make_document(
+                kvp("status", make_document(kvp("$ne", "APPLIED"))),
+                kvp("updated_at", make_document(kvp("$type", "date")))))),
+            make_document(kvp("$group", make_document(
+                kvp("_id", make_document(
+                    kvp("day", dayOf("updated_at")), kvp("department", department.view()),
+                    kvp("status", "$status"))),
+                kvp("count", make_document(kvp("$sum", 1))))))
+        ))
+    ));
+
+    // Rebuilt documents, keyed by _id
+    std::vector<std::pair<std::string, bsoncxx::document::value>> docs;
+    size_t skipped = 0;
+    auto addDoc = [&docs, &skipped](const bsoncxx::document::view& group, const std::string& status) {
+        auto key = group["_id"].get_document().value;
+        // A non-string department would otherwise abort the whole rebuild
+        if (key["day"].type() != bsoncxx::type::k_string || key["department"].type() != bsoncxx::type::k_string) {
+            ++skipped;
+            return;
+        }
+        std::string day(key["day"].get_string().value);
+        std::string dept(key["department"].get_string().value);
+        auto count = group["count"];
+        int64_t n = count.type() == bsoncxx::type::k_int64 ? count.get_int64().value : count.get_int32().value;
+        docs.emplace_back(day + "|" + dept + "|" + status, make_document(
+            kvp("day", day), kvp("department", dept), kvp("status", status), kvp("count", n)));
+    };
+
+    for (auto& doc : applications.aggregate(pipeline)) {
+        for (auto& group : doc["applied"].get_array().value) {
+            addDoc(group.get_document().value, "APPLIED");
+        }
+        for (auto& group : doc["moved"].get_array().value) {
+            auto view = group.get_document().value;
+            auto status = view["_id"]["status"];
+            if (!status || status.type() != bsoncxx::type::k_string) {
+                ++skipped;
+                continue;
+            }
+            addDoc(view, std::string(status.get_string().value));
+        }
+    }
+    if (skipped) {
+        std::cerr << "Warning: Rollup rebuild skipped " << skipped << " groups without a string key" << std::endl;
+    }
+
+    // Events from here on are missing from the aggregate. Hold their
+    // increments so an upsert cannot race the replacement, then apply them
+    // on top of the rebuilt documents (as StatsService::reconcile does).
+    {
+        std::unique_lock<std::shared_mutex> writing(state.writeMutex);
+        state.journaling = true;
+    }
+
+    std::exception_ptr failed;
+    try {
+        // Each document is replaced on its own, so a failure leaves a mix of
+        // old and rebuilt rollups rather than a half-empty collection
+        std::vector<mongocxx::model::write> writes;
+        bsoncxx::builder::basic::array ids;
+        for (const auto& [id, doc] : docs) {
+            mongocxx::model::replace_one op{make_document(kvp("_id", id)), doc.view()};
+            op.upsert(true);
+            writes.emplace_back(std::move(op));
+            ids.append(id);
+        }
+        if (!writes.empty()) {
+            mongocxx::options::bulk_write opts;
+            opts.ordered(false);
+            rollups.bulk_write(writes, opts);
+        }
+
+        // Buckets that no longer have a source
+        rollups.delete_many(make_document(kvp("_id", make_document(kvp("$nin", ids.extract())))));
+    } catch (const std::exception& e) {
+        std::cerr << "Warning: Rollup rebuild write: " << e.what() << std::endl;
+        failed = std::current_exception();
+    }
+
+    {
+        std::unique_lock<std::shared_mutex> writing(state.writeMutex);
+        state.journaling = false;
+        std::vector<Increment> held;
+        {
+            std::lock_guard<std::mutex> lock(state.journalMutex);
+            held.swap(state.journal);
+        }
+        try {
+            applyIncrements(held);
+        } catch (const std::exception& e) {
+            std::cerr << "Warning: Rollup update failed: " << e.what() << std::endl;
+        }
+    }
+    if (failed) std::rethrow_exception(failed);
+
+    Json::Value result;
+    result["success"] = true;
+    result["rollups"] = static_cast<Json::UInt64>(docs.size());
+    result["skipped"] = static_cast<Json::UInt64>(skipped);
+    return result;
+}
+
+Json::Value RollupService::getTrends(const std::string& from, const std::string& to,
+                                     const std::string& granularity, const std::string& groupBy,
+                                     const std::string& department, const std::string& status) {
+    Json::Value result;
+    std::string fromDay = from.empty() ? civilFromDays(parseDay(today()) - 29) : from;
+    std::string toDay = to.empty() ? today() : to;
+    if (!isValidDay(fromDay) || !isValidDay(toDay)) {
+        result["success"] = false;
+        result["message"] = "from and to must be YYYY-MM-DD dates";
+        return result;
+    }
+    int64_t first = parseDay(fromDay);
+    int64_t last = parseDay(toDay);
+    if (first > last || last - first >= kMaxRangeDays) {
+        result["success"] = false;
+        result["message"] = "Date range must be ascending and at most " + std::to_string(kMaxRangeDays) + " days";
+        return result;
+    }
+
+    bsoncxx::builder::basic::document filter;
+    filter.append(kvp("day", make_document(kvp("$gte", fromDay), kvp("$lte", toDay))));
+    if (!department.empty()) filter.append(kvp("department", department));
+    if (!status.empty()) filter.append(kvp("status", status));
+
+    // bucket start day -> series key -> count
+    std::map<int64_t, std::map<std::string, int64_t>> buckets;
+    for (int64_t b = bucketStart(first, granularity); b <= last; b = nextBucket(b, granularity)) {
+        buckets[b];
+    }
+
+    auto client = MongoService::instance().acquireClient();
+    auto rollups = MongoService::instance().getCollection(client, "rollups");
+    mongocxx::options::find opts;
+    opts.projection(make_document(kvp("day", 1), kvp("department", 1), kvp("status", 1), kvp("count", 1)));
+    std::map<std::string, int64_t> totals;
+    for (auto& doc : rollups.find(filter.view(), opts)) {
+        std::string day(doc["day"].get_string().value);
+        std::string key(doc[groupBy == "department" ? "department" : "status"].get_string().value);
+        auto count = doc["count"];
+        int64_t n = count.type() == bsoncxx::type::k_int64 ? count.get_int64().value : count.get_int32().value;
+        buckets[bucketStart(parseDay(day), granularity)][key] += n;
+        totals[key] += n;
+    }
+
+    Json::Value series(Json::arrayValue);
+    for (const auto& [start, counts] : buckets) {
+        Json::Value bucket;
+        bucket["start"] = civilFromDays(start);
+        bucket["counts"] = Json::Value(Json::objectValue);
+        for (const auto& [key, n] : counts) {
+            bucket["counts"][key] = static_cast<Json::Int64>(n);
+        }
+        series.append(bucket);
+    }
+
+    result["success"] = true;
+    result["from"] = fromDay;
+    result["to"] = toDay;
+    result["granularity"] = granularity;
+    result["group_by"] = groupBy == "department" ? "department" : "status";
+    result["buckets"] = series;
+    result["totals"] = Json::Value(Json::objectValue);
+    for (const auto& [key, n] : totals) {
+        result["totals"][key] = static_cast<Json::Int64>(n);
+    }
+    return result;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <json/json.h>
+#include <string>
+#include <vector>
+
+// Pre-aggregated application events bucketed by day, department and status.
+// Trend charts read these instead of scanning the applications collection.
+class RollupService {
+public:
+    // Count one application entering `status` today
+    static void record(const std::string& studentId, const std::string& status);
+    // Batched form: one upsert per department touched
+    static void recordMany(const std::vector<std::string>& studentIds, const std::string& status);
+
+    // Recreate the rollups from the applications collection. Concurrent
+    // record() calls are held during the swap and applied afterwards.
+    static Json::Value rebuild();
+
+    // from/to are inclusive YYYY-MM-DD days; granularity is day, week or month;
+    // groupBy is status or department
+    static Json::Value getTrends(const std::string& from, const std::string& to,
+                                 const std::string& granularity, const std::string& groupBy,
+                                 const std::string& department, const std::string& status);
+
+    static bool isValidDay(const std::string& day);
+};
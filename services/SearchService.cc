@@ -0,0 +1,204 @@
+#include "SearchService.h"
+#include "IdHelper.h"
+#include "MongoService.h"
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/builder/basic/kvp.hpp>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+
+using bsoncxx::builder::basic::kvp;
+using bsoncxx::builder::basic::make_document;
+
+namespace {
+
+std::string stringOf(const bsoncxx::document::element& el) {
+    if (!el || el.type() != bsoncxx::type::k_string) return "";
+    return std::string(el.get_string().value);
+}
+
+} // anonymous namespace
+
+SearchService& SearchService::instance() {
+    static SearchService svc;
+    return svc;
+}
+
+uint32_t SearchService::Directory::docFor(const std::string& id) {
+    auto it = docs.find(id);
+    if (it != docs.end()) return it->second;
+    Json::Value entry;
+    entry["id"] = id;
+    uint32_t doc;
+    if (!freeSlots.empty()) {
+        doc = freeSlots.back();
+        freeSlots.pop_back();
+        entries[doc] = entry;
+    } else {
+        doc = static_cast<uint32_t>(entries.size());
+        entries.push_back(entry);
+    }
+    docs.emplace(id, doc);
+    return doc;
+}
+
+void SearchService::Directory::release(const std::string& id) {
+    auto it = docs.find(id);
+    if (it == docs.end()) return;
+    uint32_t doc = it->second;
+    // Drops the doc's postings; empty posting lists are erased with it
+    index.remove(doc);
+    entries[doc] = Json::Value();
+    freeSlots.push_back(doc);
+    docs.erase(it);
+}
+
+void SearchService::reindexStudent(Directory& dir, uint32_t doc) {
+    const auto& e = dir.entries[doc];
+    dir.index.set(doc, {e["name"].asString(), e["email"].asString(), e["roll_number"].asString()});
+}
+
+void SearchService::reindexDrive(Directory& dir, uint32_t doc) {
+    dir.index.set(doc, {dir.entries[doc]["company_name"].asString()});
+}
+
+void SearchService::load() {
+    try {
+        auto started = std::chrono::steady_clock::now();
+
+        Directory students;
+        Directory drives;
+        {
+            auto client = MongoService::instance().acquireClient();
+            auto users = MongoService::instance().getCollection(client, "users");
+            auto studentsColl = MongoService::instance().getCollection(client, "students");
+            auto companies = MongoService::instance().getCollection(client, "companies");
+
+            std::unordered_map<std::string, std::string> emails;
+            mongocxx::options::find userOpts;
+            userOpts.projection(make_document(kvp("email", 1)));
+            for (auto& doc : users.find(make_document(kvp("role", "student")), userOpts)) {
+                emails[doc["_id"].get_oid().value.to_string()] = stringOf(doc["email"]);
+            }
+
+            mongocxx::options::find studentOpts;
+            studentOpts.projection(make_document(
+                kvp("user_id", 1), kvp("name", 1), kvp("roll_number", 1), kvp("department", 1)));
+            for (auto& doc : studentsColl.find({}, studentOpts)) {
+                std::string userId = IdHelper::str(doc["user_id"]);
+                if (userId.empty()) continue;
+                uint32_t id = students.docFor(userId);
+                auto& e = students.entries[id];
+                e["name"] = stringOf(doc["name"]);
+                e["email"] = emails[userId];
+                e["roll_number"] = stringOf(doc["roll_number"]);
+                e["department"] = stringOf(doc["department"]);
+                reindexStudent(students, id);
+            }
+
+            mongocxx::options::find driveOpts;
+            driveOpts.projection(make_document(kvp("company_name", 1), kvp("role", 1), kvp("drive_date", 1)));
+            for (auto& doc : companies.find({}, driveOpts)) {
+                uint32_t id = drives.docFor(doc["_id"].get_oid().value.to_string());
+                auto& e = drives.entries[id];
+                e["company_name"] = stringOf(doc["company_name"]);
+                e["role"] = stringOf(doc["role"]);
+                e["drive_date"] = stringOf(doc["drive_date"]);
+                reindexDrive(drives, id);
+            }
+        }
+
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        students_ = std::move(students);
+        drives_ = std::move(drives);
+
+        auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - started).count();
+        std::cout << "Search index loaded: " << students_.index.size() << " students, "
+                  << drives_.index.size() << " drives in " << elapsedMs << "ms" << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Warning: Search index load: " << e.what() << std::endl;
+        throw;
+    }
+}
+
+void SearchService::indexStudent(const std::string& userId, const std::string& name, const std::string& email,
+                                 const std::string& rollNumber, const std::string& department) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    uint32_t id = students_.docFor(userId);
+    auto& e = students_.entries[id];
+    e["name"] = name;
+    e["email"] = email;
+    e["roll_number"] = rollNumber;
+    e["department"] = department;
+    reindexStudent(students_, id);
+}
+
+void SearchService::updateStudent(const std::string& userId, const Json::Value& changes) {
+    if (!changes.isMember("name") && !changes.isMember("department")) return;
+
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto it = students_.docs.find(userId);
+    if (it == students_.docs.end()) return;
+    auto& e = students_.entries[it->second];
+    if (changes.isMember("name")) e["name"] = changes["name"].asString();
+    if (changes.isMember("department")) e["department"] = changes["department"].asString();
+    reindexStudent(students_, it->second);
+}
+
+void SearchService::indexDrive(const std::string& id, const std::string& companyName,
+                               const std::string& role, const std::string& driveDate) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    uint32_t doc = drives_.docFor(id);
+    auto& e = drives_.entries[doc];
+    e["company_name"] = companyName;
+    e["role"] = role;
+    e["drive_date"] = driveDate;
+    reindexDrive(drives_, doc);
+}
+
+void SearchService::updateDrive(const std::string& id, const Json::Value& changes) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto it = drives_.docs.find(id);
+    if (it == drives_.docs.end()) return;
+    auto& e = drives_.entries[it->second];
+    if (changes.isMember("company_name")) e["company_name"] = changes["company_name"].asString();
+    if (changes.isMember("role")) e["role"] = changes["role"].asString();
+    if (changes.isMember("drive_date")) e["drive_date"] = changes["drive_date"].asString();
+    reindexDrive(drives_, it->second);
+}
+
+void SearchService::removeDrive(const std::string& id) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    drives_.release(id);
+}
+
+Json::Value SearchService::collect(const Directory& dir, const std::string& query, size_t limit) {
+    Json::Value list(Json::arrayValue);
+    for (const auto& hit : dir.index.search(query, limit)) {
+        Json::Value entry = dir.entries[hit.doc];
+        entry["score"] = hit.score;
+        list.append(entry);
+    }
+    return list;
+}
+
+Json::Value SearchService::search(const std::string& query, const std::string& type, size_t limit) const {
+    auto started = std::chrono::steady_clock::now();
+
+    Json::Value result;
+    result["success"] = true;
+    result["query"] = query;
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        if (type == "all" || type == "students") {
+            result["students"] = collect(students_, query, limit);
+        }
+        if (type == "all" || type == "drives") {
+            result["drives"] = collect(drives_, query, limit);
+        }
+    }
+    result["took_us"] = static_cast<Json::Int64>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - started).count());
+    return result;
+}
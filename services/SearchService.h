@@ -0,0 +1,57 @@
+#pragma once
+
+#include "TrigramIndex.h"
+#include <json/json.h>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Directory search for the TPO search box: students by name, email or roll
+// number and drives by company name, backed by in-process trigram indexes.
+class SearchService {
+public:
+    static SearchService& instance();
+
+    // Logs and rethrows on failure
+    void load();
+
+    void indexStudent(const std::string& userId, const std::string& name, const std::string& email,
+                      const std::string& rollNumber, const std::string& department);
+    // Apply the fields accepted by StudentController::updateProfile
+    void updateStudent(const std::string& userId, const Json::Value& changes);
+
+    void indexDrive(const std::string& id, const std::string& companyName,
+                    const std::string& role, const std::string& driveDate);
+    // Apply the fields accepted by CompanyController::updateCompany
+    void updateDrive(const std::string& id, const Json::Value& changes);
+    void removeDrive(const std::string& id);
+
+    // type is "students", "drives" or "all"
+    Json::Value search(const std::string& query, const std::string& type, size_t limit) const;
+
+private:
+    // One searchable collection: dense doc ids, display entries and the index
+    struct Directory {
+        TrigramIndex index;
+        std::unordered_map<std::string, uint32_t> docs;
+        std::vector<Json::Value> entries;
+        // Slots of removed docs, reused by docFor before entries grows
+        std::vector<uint32_t> freeSlots;
+
+        uint32_t docFor(const std::string& id);
+        void release(const std::string& id);
+    };
+
+    SearchService() = default;
+    SearchService(const SearchService&) = delete;
+    SearchService& operator=(const SearchService&) = delete;
+
+    static void reindexStudent(Directory& dir, uint32_t doc);
+    static void reindexDrive(Directory& dir, uint32_t doc);
+    static Json::Value collect(const Directory& dir, const std::string& query, size_t limit);
+
+    mutable std::shared_mutex mutex_;
+    Directory students_;
+    Directory drives_;
+};
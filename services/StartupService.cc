@@ -0,0 +1,143 @@
+#include "StartupService.h"
+#include <iostream>
+#include <sstream>
+
+StartupService& StartupService::instance() {
+    static StartupService svc;
+    return svc;
+}
+
+StartupService::StartupService() : started_(std::chrono::steady_clock::now()) {}
+
+int64_t StartupService::sinceStart() const {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - started_).count();
+}
+
+StartupService::Step& StartupService::stepFor(const std::string& name) {
+    for (auto& step : steps_) {
+        if (step.name == name) return step;
+    }
+    Step step;
+    step.name = name;
+    steps_.push_back(std::move(step));
+    return steps_.back();
+}
+
+void StartupService::measure(const std::string& step, const std::function<void()>& fn) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stepFor(step);
+    }
+    auto t0 = std::chrono::steady_clock::now();
+    fn();
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - t0).count();
+    finish(step, ms, "");
+}
+
+void StartupService::background(const std::string& step, bool gatesReadiness, std::function<void()> fn) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Step& s = stepFor(step);
+        s.background = true;
+        s.gatesReadiness = gatesReadiness;
+    }
+    workers_.post([this, step, fn = std::move(fn)]() {
+        auto t0 = std::chrono::steady_clock::now();
+        std::string error;
+        try {
+            fn();
+        } catch (const std::exception& e) {
+            error = e.what();
+            std::cerr << "Warning: Startup step " << step << " failed: " << error << std::endl;
+        }
+        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - t0).count();
+        finish(step, ms, error);
+    });
+}
+
+void StartupService::expect(const std::string& gate) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stepFor(gate).gatesReadiness = true;
+}
+
+void StartupService::open(const std::string& gate) {
+    // Gates measure from process start: "listening" is time to first accept
+    finish(gate, sinceStart(), "");
+}
+
+void StartupService::finish(const std::string& name, int64_t ms, const std::string& error) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Step& s = stepFor(name);
+        s.ms = ms;
+        s.error = error;
+    }
+    logIfReady();
+}
+
+bool StartupService::ready() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return readyAtMs_ >= 0;
+}
+
+void StartupService::logIfReady() {
+    std::ostringstream summary;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (readyAtMs_ >= 0) return;
+        bool gated = false;
+        for (const auto& s : steps_) {
+            if (!s.gatesReadiness) continue;
+            if (s.ms < 0 || !s.error.empty()) return;
+            gated = true;
+        }
+        if (!gated) return;
+        readyAtMs_ = sinceStart();
+
+        summary << "Startup: ready in " << readyAtMs_ << "ms (";
+        for (size_t i = 0; i < steps_.size(); ++i) {
+            const auto& s = steps_[i];
+            if (i > 0) summary << ", ";
+            summary << s.name << " ";
+            if (s.ms < 0) {
+                summary << "running";
+            } else {
+                summary << s.ms << "ms";
+            }
+            if (s.background) summary << " bg";
+        }
+        summary << ")";
+    }
+    std::cout << summary.str() << std::endl;
+}
+
+Json::Value StartupService::status() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Json::Value result;
+    result["ready"] = readyAtMs_ >= 0;
+    if (readyAtMs_ >= 0) result["ready_after_ms"] = static_cast<Json::Int64>(readyAtMs_);
+    result["uptime_ms"] = static_cast<Json::Int64>(sinceStart());
+
+    Json::Value steps(Json::arrayValue);
+    Json::Value waiting(Json::arrayValue);
+    for (const auto& s : steps_) {
+        Json::Value step;
+        step["name"] = s.name;
+        step["background"] = s.background;
+        step["gates_readiness"] = s.gatesReadiness;
+        if (s.ms >= 0) {
+            step["ms"] = static_cast<Json::Int64>(s.ms);
+        } else {
+            step["running"] = true;
+        }
+        if (!s.error.empty()) step["error"] = s.error;
+        steps.append(step);
+        if (s.gatesReadiness && (s.ms < 0 || !s.error.empty())) waiting.append(s.name);
+    }
+    result["steps"] = steps;
+    result["waiting_for"] = waiting;
+    return result;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "WorkQueue.h"
+#include <json/json.h>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Startup timing and readiness. main() runs each startup step through
+// measure() or background() so the breakdown is recorded; /readyz reports
+// ready once every step that gates readiness has finished.
+class StartupService {
+public:
+    static StartupService& instance();
+
+    // Runs `fn` inline and records how long it took
+    void measure(const std::string& step, const std::function<void()>& fn);
+
+    // Runs `fn` on a startup worker. With `gatesReadiness` the server is not
+    // ready until it returns; if it throws, readiness stays down with the error.
+    void background(const std::string& step, bool gatesReadiness, std::function<void()> fn);
+
+    // A gate opened by something other than a background step (the listener).
+    // Declare it before any other step can finish, or readiness may be
+    // reported while it is still closed.
+    void expect(const std::string& gate);
+    void open(const std::string& gate);
+
+    bool ready() const;
+    // Steps with their durations, gates still closed, time to ready
+    Json::Value status() const;
+
+private:
+    struct Step {
+        std::string name;
+        int64_t ms = -1;          // -1 while running
+        bool background = false;
+        bool gatesReadiness = false;
+        std::string error;
+    };
+
+    StartupService();
+    StartupService(const StartupService&) = delete;
+    StartupService& operator=(const StartupService&) = delete;
+
+    int64_t sinceStart() const;
+    // Callers hold mutex_
+    Step& stepFor(const std::string& name);
+    void finish(const std::string& name, int64_t ms, const std::string& error);
+    void logIfReady();
+
+    std::chrono::steady_clock::time_point started_;
+    mutable std::mutex mutex_;
+    std::vector<Step> steps_;
+    int64_t readyAtMs_ = -1;
+
+    // Last member: workers stop before the state they touch goes away
+    WorkQueue workers_{"startup", 4};
+};
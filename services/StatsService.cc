@@ -0,0 +1,489 @@
+#include "StatsService.h"
+#include "IdHelper.h"
+#include "MongoService.h"
+#include "JsonHelper.h"
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/builder/basic/kvp.hpp>
+#include <bsoncxx/builder/basic/array.hpp>
+#include <mongocxx/pipeline.hpp>
+#include <mongocxx/model/replace_one.hpp>
+#include <mongocxx/model/update_one.hpp>
+#include <mongocxx/model/write.hpp>
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <future>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+using bsoncxx::builder::basic::kvp;
+using bsoncxx::builder::basic::make_document;
+using bsoncxx::builder::basic::make_array;
+
+namespace {
+
+constexpr size_t kApplied = ApplicationStatus::index(AppStatus::Applied);
+constexpr size_t kSelected = ApplicationStatus::index(AppStatus::Selected);
+
+const std::string kGlobalId = "global";
+const std::string kDeptPrefix = "dept:";
+const std::string kDrivePrefix = "drive:";
+
+int64_t countOf(const bsoncxx::document::element& el) {
+    if (!el) return 0;
+    switch (el.type()) {
+        case bsoncxx::type::k_int32: return el.get_int32().value;
+        case bsoncxx::type::k_int64: return el.get_int64().value;
+        case bsoncxx::type::k_double: return static_cast<int64_t>(el.get_double().value);
+        default: return 0;
+    }
+}
+
+void readStatus(const bsoncxx::document::element& el, StatsService::StatusCounts& out) {
+    if (!el || el.type() != bsoncxx::type::k_document) return;
+    for (auto& field : el.get_document().value) {
+        auto key = field.key();
+        auto status = ApplicationStatus::parse(std::string_view(key.data(), key.size()));
+        if (status) out[ApplicationStatus::index(*status)] = countOf(field);
+    }
+}
+
+std::string statusField(AppStatus s) {
+    return "status." + std::string(ApplicationStatus::name(s));
+}
+
+// $inc one or more counter documents in a single unordered bulk write
+bool applyIncrements(const std::vector<std::pair<std::string, bsoncxx::document::value>>& incs) {
+    try {
+        auto client = MongoService::instance().acquireClient();
+        auto stats = MongoService::instance().getCollection(client, "stats");
+
+        std::vector<mongocxx::model::write> writes;
+        for (const auto& [id, inc] : incs) {
+            mongocxx::model::update_one op{
+                make_document(kvp("_id", id)),
+                make_document(kvp("$inc", bsoncxx::types::b_document{inc.view()}))
+            };
+            op.upsert(true);
+            writes.emplace_back(std::move(op));
+        }
+
+        mongocxx::options::bulk_write opts;
+        opts.ordered(false);
+        stats.bulk_write(writes, opts);
+        return true;
+    } catch (const std::exception& e) {
+        // Counters drift until the next reconcile; the source write already succeeded
+        std::cerr << "Warning: Stats increment: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+} // anonymous namespace
+
+StatsService& StatsService::instance() {
+    static StatsService svc;
+    return svc;
+}
+
+bool StatsService::increment(Increments incs) {
+    std::shared_lock<std::shared_mutex> writing(writeMutex_);
+    if (journaling_) {
+        std::lock_guard<std::mutex> lock(journalMutex_);
+        for (auto& inc : incs) journal_.push_back(std::move(inc));
+        return false;
+    }
+    return applyIncrements(incs);
+}
+
+bool StatsService::readCounters(Counters& out) {
+    auto client = MongoService::instance().acquireClient();
+    auto stats = MongoService::instance().getCollection(client, "stats");
+
+    bool hasGlobal = false;
+    for (auto& doc : stats.find({})) {
+        if (doc["_id"].type() != bsoncxx::type::k_string) continue;
+        std::string id(doc["_id"].get_string().value);
+
+        if (id == kGlobalId) {
+            hasGlobal = true;
+            out.students = countOf(doc["students"]);
+            out.companies = countOf(doc["companies"]);
+            out.applications = countOf(doc["applications"]);
+            readStatus(doc["status"], out.status);
+        } else if (id.compare(0, kDeptPrefix.size(), kDeptPrefix) == 0) {
+            out.departments[id.substr(kDeptPrefix.size())] = countOf(doc["students"]);
+        } else if (id.compare(0, kDrivePrefix.size(), kDrivePrefix) == 0) {
+            auto& drive = out.drives[id.substr(kDrivePrefix.size())];
+            drive.applications = countOf(doc["applications"]);
+            readStatus(doc["status"], drive.status);
+        }
+    }
+    return hasGlobal;
+}
+
+void StatsService::load() {
+    try {
+        Counters loaded;
+        if (!readCounters(loaded)) {
+            std::cout << "Stats counters missing, rebuilding from source" << std::endl;
+            reconcile();
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        counters_ = std::move(loaded);
+    } catch (const std::exception& e) {
+        std::cerr << "Warning: Stats load: " << e.what() << std::endl;
+        throw;
+    }
+}
+
+bool StatsService::refresh() {
+    try {
+        Counters loaded;
+        if (!readCounters(loaded)) return false;
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        counters_ = std::move(loaded);
+        return true;
+    } catch (const std::exception& e) {
+        std::cerr << "Warning: Stats refresh: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+Json::Value StatsService::reconcile() {
+    // One rebuild at a time; they share the increment journal
+    std::lock_guard<std::mutex> rebuilding(reconcileMutex_);
+    auto started = std::chrono::steady_clock::now();
+
+    // Same three concurrent aggregations the dashboard used to run per request,
+    // plus the per-drive status split for the funnels
+    auto studentsTask = std::async(std::launch::async, []() {
+        auto client = MongoService::instance().acquireClient();
+        auto students = MongoService::instance().getCollection(client, "students");
+        mongocxx::pipeline pipe;
+        pipe.group(make_document(kvp("_id", "$department"), kvp("count", make_document(kvp("$sum", 1)))));
+
+        std::map<std::string, int64_t> departments;
+        for (auto& doc : students.aggregate(pipe)) {
+            std::string dept = doc["_id"].type() == bsoncxx::type::k_string
+                ? std::string(doc["_id"].get_string().value) : "Unknown";
+            departments[dept] += countOf(doc["count"]);
+        }
+        return departments;
+    });
+
+    auto companiesTask = std::async(std::launch::async, []() {
+        auto client = MongoService::instance().acquireClient();
+        auto companies = MongoService::instance().getCollection(client, "companies");
+        mongocxx::options::find opts;
+        opts.projection(make_document(kvp("_id", 1)));
+
+        std::vector<std::string> ids;
+        for (auto& doc : companies.find({}, opts)) {
+            ids.push_back(doc["_id"].get_oid().value.to_string());
+        }
+        return ids;
+    });
+
+    auto applicationsTask = std::async(std::launch::async, []() {
+        auto client = MongoService::instance().acquireClient();
+        auto applications = MongoService::instance().getCollection(client, "applications");
+        mongocxx::pipeline pipe;
+        pipe.group(make_document(
+            kvp("_id", make_document(kvp("company_id", "$company_id"), kvp("status", "$status"))),
+            kvp("count", make_document(kvp("$sum", 1)))
+        ));
+
+        std::map<std::string, DriveCounters> drives;
+        for (auto& doc : applications.aggregate(pipe)) {
+            auto key = doc["_id"].get_document().value;
+            // Mid-migration one drive can group under both id types; they sum here
+            std::string companyId = IdHelper::str(key["company_id"]);
+            if (companyId.empty() || key["status"].type() != bsoncxx::type::k_string) continue;
+            auto name = key["status"].get_string().value;
+            auto status = ApplicationStatus::parse(std::string_view(name.data(), name.size()));
+            if (!status) continue;
+            auto& drive = drives[companyId];
+            int64_t count = countOf(doc["count"]);
+            drive.applications += count;
+            drive.status[ApplicationStatus::index(*status)] += count;
+        }
+        return drives;
+    });
+
+    Counters fresh;
+    fresh.departments = studentsTask.get();
+    std::vector<std::string> companyIds = companiesTask.get();
+    fresh.drives = applicationsTask.get();
+
+    for (const auto& [dept, count] : fresh.departments) fresh.students += count;
+    fresh.companies = static_cast<int64_t>(companyIds.size());
+    for (const auto& id : companyIds) fresh.drives[id];  // drives with no applicants yet
+    for (const auto& [id, drive] : fresh.drives) {
+        fresh.applications += drive.applications;
+        for (size_t i = 0; i < ApplicationStatus::kCount; ++i) fresh.status[i] += drive.status[i];
+    }
+
+    // Rebuilt counter documents, keyed by _id
+    auto statusDoc = [](const StatusCounts& status) {
+        bsoncxx::builder::basic::document doc;
+        for (AppStatus s : ApplicationStatus::all()) {
+            doc.append(kvp(std::string(ApplicationStatus::name(s)), status[ApplicationStatus::index(s)]));
+        }
+        return doc.extract();
+    };
+
+    Increments docs;
+    docs.emplace_back(kGlobalId, make_document(
+        kvp("students", fresh.students),
+        kvp("companies", fresh.companies),
+        kvp("applications", fresh.applications),
+        kvp("status", statusDoc(fresh.status))
+    ));
+    for (const auto& [dept, count] : fresh.departments) {
+        docs.emplace_back(kDeptPrefix + dept, make_document(kvp("students", count)));
+    }
+    for (const auto& [id, drive] : fresh.drives) {
+        docs.emplace_back(kDrivePrefix + id, make_document(
+            kvp("applications", drive.applications),
+            kvp("status", statusDoc(drive.status))
+        ));
+    }
+
+    // Events from here on are missing from the aggregates. Hold their
+    // increments so an upsert cannot race the replacement, then apply them
+    // on top of the rebuilt documents. (An event whose source write lands
+    // while the aggregates run can still be counted twice or not at all;
+    // that window is the length of the aggregations.)
+    {
+        std::unique_lock<std::shared_mutex> writing(writeMutex_);
+        journaling_ = true;
+    }
+
+    std::exception_ptr failed;
+    try {
+        auto client = MongoService::instance().acquireClient();
+        auto stats = MongoService::instance().getCollection(client, "stats");
+
+        // Each document is replaced on its own, so a failure leaves a mix of
+        // old and rebuilt counters rather than a half-empty collection
+        std::vector<mongocxx::model::write> writes;
+        bsoncxx::builder::basic::array ids;
+        for (const auto& [id, doc] : docs) {
+            mongocxx::model::replace_one op{make_document(kvp("_id", id)), doc.view()};
+            op.upsert(true);
+            writes.emplace_back(std::move(op));
+            ids.append(id);
+        }
+        mongocxx::options::bulk_write opts;
+        opts.ordered(false);
+        stats.bulk_write(writes, opts);
+
+        // Departments and drives that no longer have a source
+        stats.delete_many(make_document(kvp("_id", make_document(kvp("$nin", ids.extract())))));
+    } catch (const std::exception& e) {
+        std::cerr << "Warning: Stats reconcile write: " << e.what() << std::endl;
+        failed = std::current_exception();
+    }
+
+    {
+        std::unique_lock<std::shared_mutex> writing(writeMutex_);
+        journaling_ = false;
+        Increments held;
+        {
+            std::lock_guard<std::mutex> lock(journalMutex_);
+            held.swap(journal_);
+        }
+        if (!held.empty()) applyIncrements(held);
+
+        // Their hooks skipped the in-memory update, so read the result back
+        Counters current;
+        bool known = true;
+        if (failed || !held.empty()) {
+            try {
+                known = readCounters(current);
+            } catch (const std::exception& e) {
+                std::cerr << "Warning: Stats reconcile reread: " << e.what() << std::endl;
+                known = false;
+            }
+        } else {
+            current = fresh;
+        }
+        if (known) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            counters_ = std::move(current);
+        }
+    }
+    if (failed) std::rethrow_exception(failed);
+
+    auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - started).count();
+    std::cout << "Stats counters reconciled in " << elapsedMs << "ms" << std::endl;
+
+    Json::Value result;
+    result["success"] = true;
+    result["message"] = "Counters rebuilt from source";
+    result["drives"] = static_cast<Json::Int64>(fresh.drives.size());
+    result["took_ms"] = static_cast<Json::Int64>(elapsedMs);
+    return result;
+}
+
+void StatsService::onStudentRegistered(const std::string& department) {
+    std::string dept = department.empty() ? "Unknown" : department;
+    std::vector<std::pair<std::string, bsoncxx::document::value>> incs;
+    incs.emplace_back(kGlobalId, make_document(kvp("students", 1)));
+    incs.emplace_back(kDeptPrefix + dept, make_document(kvp("students", 1)));
+    if (!increment(std::move(incs))) return;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    counters_.students += 1;
+    counters_.departments[dept] += 1;
+}
+
+void StatsService::onDepartmentChanged(const std::string& from, const std::string& to) {
+    std::string oldDept = from.empty() ? "Unknown" : from;
+    std::string newDept = to.empty() ? "Unknown" : to;
+    if (oldDept == newDept) return;
+
+    Increments incs;
+    incs.emplace_back(kDeptPrefix + oldDept, make_document(kvp("students", -1)));
+    incs.emplace_back(kDeptPrefix + newDept, make_document(kvp("students", 1)));
+    if (!increment(std::move(incs))) return;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    counters_.departments[oldDept] -= 1;
+    counters_.departments[newDept] += 1;
+}
+
+void StatsService::onDriveCreated(const std::string& companyId) {
+    std::vector<std::pair<std::string, bsoncxx::document::value>> incs;
+    incs.emplace_back(kGlobalId, make_document(kvp("companies", 1)));
+    incs.emplace_back(kDrivePrefix + companyId, make_document(kvp("applications", 0)));
+    if (!increment(std::move(incs))) return;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    counters_.companies += 1;
+    counters_.drives[companyId];
+}
+
+void StatsService::onDriveDeleted(const std::string& companyId) {
+    // Applications of a deleted drive stay in the collection, so only the
+    // drive count changes; the funnel stays readable for history.
+    std::vector<std::pair<std::string, bsoncxx::document::value>> incs;
+    incs.emplace_back(kGlobalId, make_document(kvp("companies", -1)));
+    if (!increment(std::move(incs))) return;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    counters_.companies -= 1;
+}
+
+void StatsService::onApplicationCreated(const std::string& companyId) {
+    onApplicationsCreated({{companyId, 1}});
+}
+
+void StatsService::onApplicationsCreated(const std::map<std::string, int64_t>& perDrive) {
+    int64_t total = 0;
+    std::vector<std::pair<std::string, bsoncxx::document::value>> incs;
+    for (const auto& [companyId, n] : perDrive) {
+        total += n;
+        incs.emplace_back(kDrivePrefix + companyId,
+                          make_document(kvp("applications", n), kvp(statusField(AppStatus::Applied), n)));
+    }
+    if (total == 0) return;
+    incs.emplace_back(kGlobalId,
+                      make_document(kvp("applications", total), kvp(statusField(AppStatus::Applied), total)));
+    if (!increment(std::move(incs))) return;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    counters_.applications += total;
+    counters_.status[kApplied] += total;
+    for (const auto& [companyId, n] : perDrive) {
+        auto& drive = counters_.drives[companyId];
+        drive.applications += n;
+        drive.status[kApplied] += n;
+    }
+}
+
+void StatsService::onStatusChanged(const std::string& companyId, AppStatus from, AppStatus to) {
+    if (from == to) return;
+    auto delta = [&]() {
+        return make_document(kvp(statusField(from), -1), kvp(statusField(to), 1));
+    };
+    std::vector<std::pair<std::string, bsoncxx::document::value>> incs;
+    incs.emplace_back(kGlobalId, delta());
+    incs.emplace_back(kDrivePrefix + companyId, delta());
+    if (!increment(std::move(incs))) return;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t fromIdx = ApplicationStatus::index(from);
+    size_t toIdx = ApplicationStatus::index(to);
+    counters_.status[fromIdx] -= 1;
+    counters_.status[toIdx] += 1;
+    auto& drive = counters_.drives[companyId];
+    drive.status[fromIdx] -= 1;
+    drive.status[toIdx] += 1;
+}
+
+Json::Value StatsService::analytics() {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    int64_t placedStudents = counters_.status[kSelected];
+    double placementPercentage = counters_.students > 0
+        ? (static_cast<double>(placedStudents) / counters_.students) * 100.0
+        : 0.0;
+
+    Json::Value result;
+    result["success"] = true;
+    result["analytics"]["total_students"] = static_cast<Json::Int64>(counters_.students);
+    result["analytics"]["total_companies"] = static_cast<Json::Int64>(counters_.companies);
+    result["analytics"]["total_applications"] = static_cast<Json::Int64>(counters_.applications);
+    result["analytics"]["placed_students"] = static_cast<Json::Int64>(placedStudents);
+    result["analytics"]["placement_percentage"] = placementPercentage;
+
+    Json::Value statusDist;
+    for (AppStatus s : ApplicationStatus::all()) {
+        statusDist[std::string(ApplicationStatus::name(s))] =
+            static_cast<Json::Int64>(counters_.status[ApplicationStatus::index(s)]);
+    }
+    result["analytics"]["status_distribution"] = statusDist;
+
+    std::vector<std::pair<std::string, int64_t>> depts(counters_.departments.begin(), counters_.departments.end());
+    std::stable_sort(depts.begin(), depts.end(),
+                     [](const auto& a, const auto& b) { return a.second > b.second; });
+    Json::Value deptStats(Json::arrayValue);
+    for (const auto& [name, count] : depts) {
+        if (count <= 0) continue;
+        Json::Value dept;
+        dept["department"] = name;
+        dept["count"] = static_cast<Json::Int64>(count);
+        deptStats.append(dept);
+    }
+    result["analytics"]["department_stats"] = deptStats;
+
+    return result;
+}
+
+Json::Value StatsService::driveFunnel(const std::string& companyId) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    Json::Value result;
+    auto it = counters_.drives.find(companyId);
+    if (it == counters_.drives.end()) {
+        return JsonHelper::errorResponse("Company drive not found");
+    }
+
+    result["success"] = true;
+    result["drive_id"] = companyId;
+    result["applications"] = static_cast<Json::Int64>(it->second.applications);
+    Json::Value funnel;
+    for (AppStatus s : ApplicationStatus::all()) {
+        funnel[std::string(ApplicationStatus::name(s))] =
+            static_cast<Json::Int64>(it->second.status[ApplicationStatus::index(s)]);
+    }
+    result["funnel"] = funnel;
+    return result;
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "ApplicationStatus.h"
+#include <json/json.h>
+#include <bsoncxx/document/value.hpp>
+#include <array>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Placement counters maintained incrementally with $inc in the "stats"
+// collection and mirrored in memory, so dashboards never recount.
+//   _id "global"        totals + status distribution
+//   _id "dept:<name>"   students per department
+//   _id "drive:<id>"    per-drive applicant funnel
+class StatsService {
+public:
+    // Indexed by ApplicationStatus::index
+    using StatusCounts = std::array<int64_t, ApplicationStatus::kCount>;
+
+    struct DriveCounters {
+        int64_t applications = 0;
+        StatusCounts status{};
+    };
+
+    static StatsService& instance();
+
+    // Read the counters into memory; rebuilds them if they were never created.
+    // Logs and rethrows on failure.
+    void load();
+    // Re-read the counters from Mongo, picking up writes made by other instances
+    bool refresh();
+    // Rebuild every counter from the source collections
+    Json::Value reconcile();
+
+    void onStudentRegistered(const std::string& department);
+    // No-op when the department did not actually change
+    void onDepartmentChanged(const std::string& from, const std::string& to);
+    void onDriveCreated(const std::string& companyId);
+    void onDriveDeleted(const std::string& companyId);
+    void onApplicationCreated(const std::string& companyId);
+    // Batched form: drive id -> applications created
+    void onApplicationsCreated(const std::map<std::string, int64_t>& perDrive);
+    void onStatusChanged(const std::string& companyId, AppStatus from, AppStatus to);
+
+    // Same shape as the old recount-based /api/analytics payload
+    Json::Value analytics();
+    Json::Value driveFunnel(const std::string& companyId);
+
+private:
+    struct Counters {
+        int64_t students = 0;
+        int64_t companies = 0;
+        int64_t applications = 0;
+        StatusCounts status{};
+        std::map<std::string, int64_t> departments;
+        std::map<std::string, DriveCounters> drives;
+    };
+
+    StatsService() = default;
+    StatsService(const StatsService&) = delete;
+    StatsService& operator=(const StatsService&) = delete;
+
+    // Counter document id -> $inc document
+    using Increments = std::vector<std::pair<std::string, bsoncxx::document::value>>;
+
+    // Returns false when the global document does not exist yet
+    bool readCounters(Counters& out);
+    // $inc the counter documents. Returns false when the write failed or was
+    // held back for reconcile(); callers then leave the in-memory copy alone.
+    bool increment(Increments incs);
+
+    std::mutex mutex_;
+    Counters counters_;
+
+    // While reconcile() replaces the stored documents, increments go to
+    // journal_ and are applied on top of the rebuilt counters afterwards
+    std::shared_mutex writeMutex_;
+    bool journaling_ = false;
+    std::mutex journalMutex_;
+    Increments journal_;
+    std::mutex reconcileMutex_;
+};
@@ -0,0 +1,331 @@
+#include "StudentIndexService.h"
+#include "IdHelper.h"
+#include "MongoService.h"
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/builder/basic/kvp.hpp>
+#include <bsoncxx/builder/basic/array.hpp>
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <unordered_set>
+
+using bsoncxx::builder::basic::kvp;
+using bsoncxx::builder::basic::make_document;
+using bsoncxx::builder::basic::make_array;
+
+namespace {
+
+std::string stringOf(const bsoncxx::document::element& el) {
+    if (!el || el.type() != bsoncxx::type::k_string) return "";
+    return std::string(el.get_string().value);
+}
+
+double numberOf(const bsoncxx::document::element& el) {
+    if (!el) return 0.0;
+    switch (el.type()) {
+        case bsoncxx::type::k_double: return el.get_double().value;
+        case bsoncxx::type::k_int32: return el.get_int32().value;
+        case bsoncxx::type::k_int64: return static_cast<double>(el.get_int64().value);
+        default: return 0.0;
+    }
+}
+
+} // anonymous namespace
+
+StudentIndexService& StudentIndexService::instance() {
+    static StudentIndexService svc;
+    return svc;
+}
+
+std::string StudentIndexService::normalizeSkill(const std::string& skill) {
+    size_t begin = 0, end = skill.size();
+    while (begin < end && std::isspace(static_cast<unsigned char>(skill[begin]))) ++begin;
+    while (end > begin && std::isspace(static_cast<unsigned char>(skill[end - 1]))) --end;
+    std::string out = skill.substr(begin, end - begin);
+    std::transform(out.begin(), out.end(), out.begin(), ::tolower);
+    return out;
+}
+
+StudentIndexService::Student StudentIndexService::fromDoc(bsoncxx::document::view doc) {
+    Student s;
+    s.userId = IdHelper::str(doc["user_id"]);
+    s.name = stringOf(doc["name"]);
+    s.department = stringOf(doc["department"]);
+    s.rollNumber = stringOf(doc["roll_number"]);
+    s.gpa = numberOf(doc["gpa"]);
+    s.backlogs = static_cast<int32_t>(numberOf(doc["backlogs"]));
+    auto skills = doc["skills"];
+    if (skills && skills.type() == bsoncxx::type::k_array) {
+        for (auto& skill : skills.get_array().value) {
+            if (skill.type() == bsoncxx::type::k_string) {
+                s.skills.emplace_back(skill.get_string().value);
+            }
+        }
+    }
+    auto keywords = doc["resume_keywords"];
+    if (keywords && keywords.type() == bsoncxx::type::k_array) {
+        for (auto& kw : keywords.get_array().value) {
+            if (kw.type() == bsoncxx::type::k_string) {
+                s.keywords.emplace_back(kw.get_string().value);
+            }
+        }
+    }
+    return s;
+}
+
+void StudentIndexService::load() {
+    try {
+        auto started = std::chrono::steady_clock::now();
+
+        std::unordered_set<std::string> inactive;
+        std::vector<Student> loaded;
+        {
+            auto client = MongoService::instance().acquireClient();
+            auto users = MongoService::instance().getCollection(client, "users");
+            auto students = MongoService::instance().getCollection(client, "students");
+
+            mongocxx::options::find userOpts;
+            userOpts.projection(make_document(kvp("_id", 1)));
+            auto userCursor = users.find(
+                make_document(kvp("role", "student"),
+                              kvp("status", make_document(kvp("$in", make_array("pending_approval", "rejected"))))),
+                userOpts);
+            for (auto& doc : userCursor) {
+                inactive.insert(doc["_id"].get_oid().value.to_string());
+            }
+
+            mongocxx::options::find opts;
+            opts.projection(make_document(
+                kvp("user_id", 1), kvp("name", 1), kvp("department", 1), kvp("roll_number", 1),
+                kvp("gpa", 1), kvp("backlogs", 1), kvp("skills", 1),
+                kvp("resume_keywords", 1)));
+            auto cursor = students.find({}, opts);
+            for (auto& doc : cursor) {
+                Student s = fromDoc(doc);
+                if (!s.userId.empty()) loaded.push_back(std::move(s));
+            }
+        }
+
+        // Swap in a fresh index; the Mongo reads above run without the lock
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        slots_.clear();
+        students_.clear();
+        gpa_.clear();
+        backlogs_.clear();
+        active_.clear();
+        skills_.clear();
+        keywords_.clear();
+        students_.reserve(loaded.size());
+        gpa_.reserve(loaded.size());
+        backlogs_.reserve(loaded.size());
+        for (auto& s : loaded) {
+            bool active = inactive.count(s.userId) == 0;
+            store(std::move(s), active);
+        }
+
+        auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - started).count();
+        std::cout << "Student index loaded: " << students_.size() << " students, "
+                  << skills_.size() << " skills, " << keywords_.size() << " resume keywords in "
+                  << elapsedMs << "ms" << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Warning: Student index load: " << e.what() << std::endl;
+        throw;
+    }
+}
+
+uint32_t StudentIndexService::slotFor(const std::string& userId) {
+    auto it = slots_.find(userId);
+    if (it != slots_.end()) return it->second;
+
+    uint32_t slot = static_cast<uint32_t>(students_.size());
+    slots_.emplace(userId, slot);
+    Student s;
+    s.userId = userId;
+    students_.push_back(std::move(s));
+    gpa_.push_back(0.0f);
+    backlogs_.push_back(0);
+    return slot;
+}
+
+void StudentIndexService::store(Student student, bool active) {
+    uint32_t slot = slotFor(student.userId);
+    // setSkills needs the previous skills to unlink them, so assign field-wise
+    setSkills(slot, std::move(student.skills));
+    setKeywords(slot, std::move(student.keywords));
+    setGrades(slot, student.gpa, student.backlogs);
+    Student& s = students_[slot];
+    s.name = std::move(student.name);
+    s.department = std::move(student.department);
+    s.rollNumber = std::move(student.rollNumber);
+    if (active) {
+        active_.add(slot);
+    } else {
+        active_.remove(slot);
+    }
+}
+
+void StudentIndexService::setGrades(uint32_t slot, double gpa, int32_t backlogs) {
+    students_[slot].gpa = gpa;
+    students_[slot].backlogs = backlogs;
+    gpa_[slot] = static_cast<float>(gpa);
+    backlogs_[slot] = backlogs;
+}
+
+void StudentIndexService::setSkills(uint32_t slot, std::vector<std::string> skills) {
+    for (const auto& old : students_[slot].skills) {
+        auto it = skills_.find(normalizeSkill(old));
+        if (it == skills_.end()) continue;
+        it->second.remove(slot);
+        if (it->second.empty()) skills_.erase(it);
+    }
+    for (const auto& skill : skills) {
+        std::string key = normalizeSkill(skill);
+        if (!key.empty()) skills_[key].add(slot);
+    }
+    students_[slot].skills = std::move(skills);
+}
+
+void StudentIndexService::setKeywords(uint32_t slot, std::vector<std::string> keywords) {
+    for (const auto& old : students_[slot].keywords) {
+        auto it = keywords_.find(old);
+        if (it == keywords_.end()) continue;
+        it->second.remove(slot);
+        if (it->second.empty()) keywords_.erase(it);
+    }
+    // Stored already normalized by PdfText::keywords
+    for (const auto& kw : keywords) {
+        if (!kw.empty()) keywords_[kw].add(slot);
+    }
+    students_[slot].keywords = std::move(keywords);
+}
+
+void StudentIndexService::upsert(bsoncxx::document::view studentDoc, bool active) {
+    Student s = fromDoc(studentDoc);
+    if (s.userId.empty()) return;
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    store(std::move(s), active);
+}
+
+void StudentIndexService::applyProfileUpdate(const std::string& userId, const Json::Value& changes) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    bool known = slots_.count(userId) > 0;
+    uint32_t slot = slotFor(userId);
+    if (!known) active_.add(slot);  // only active students can update a profile
+
+    Student& s = students_[slot];
+    if (changes.isMember("name")) s.name = changes["name"].asString();
+    if (changes.isMember("department")) s.department = changes["department"].asString();
+    if (changes.isMember("gpa") || changes.isMember("backlogs")) {
+        setGrades(slot,
+                  changes.isMember("gpa") ? changes["gpa"].asDouble() : s.gpa,
+                  changes.isMember("backlogs") ? changes["backlogs"].asInt() : s.backlogs);
+    }
+    if (changes.isMember("skills") && changes["skills"].isArray()) {
+        std::vector<std::string> skills;
+        for (const auto& skill : changes["skills"]) {
+            skills.push_back(skill.asString());
+        }
+        setSkills(slot, std::move(skills));
+    }
+}
+
+void StudentIndexService::setActive(const std::string& userId, bool active) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto it = slots_.find(userId);
+    if (it == slots_.end()) return;
+    if (active) {
+        active_.add(it->second);
+    } else {
+        active_.remove(it->second);
+    }
+}
+
+void StudentIndexService::setResumeKeywords(const std::string& userId, std::vector<std::string> keywords) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto it = slots_.find(userId);
+    if (it == slots_.end()) return;  // picked up from the profile on the next load
+    setKeywords(it->second, std::move(keywords));
+}
+
+std::string StudentIndexService::departmentOf(const std::string& userId) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto it = slots_.find(userId);
+    if (it == slots_.end()) return "";
+    return students_[it->second].department;
+}
+
+Json::Value StudentIndexService::search(const Query& query) const {
+    auto started = std::chrono::steady_clock::now();
+
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+
+    // Intersect smallest bitmaps first so intermediate results stay small
+    std::vector<const RoaringBitmap*> sets;
+    bool missingSkill = false;
+    for (const auto& skill : query.skills) {
+        auto it = skills_.find(normalizeSkill(skill));
+        if (it == skills_.end()) {
+            missingSkill = true;
+            break;
+        }
+        sets.push_back(&it->second);
+    }
+    for (const auto& keyword : query.keywords) {
+        if (missingSkill) break;
+        auto it = keywords_.find(normalizeSkill(keyword));
+        if (it == keywords_.end()) {
+            missingSkill = true;
+            break;
+        }
+        sets.push_back(&it->second);
+    }
+    std::sort(sets.begin(), sets.end(), [](const RoaringBitmap* a, const RoaringBitmap* b) {
+        return a->cardinality() < b->cardinality();
+    });
+
+    RoaringBitmap candidates;
+    if (!missingSkill) {
+        candidates = sets.empty() ? active_ : RoaringBitmap::intersect(*sets[0], active_);
+        for (size_t i = 1; i < sets.size() && !candidates.empty(); ++i) {
+            candidates.intersectWith(*sets[i]);
+        }
+    }
+
+    float minGpa = static_cast<float>(query.minGpa);
+    int32_t maxBacklogs = query.maxBacklogs < 0 ? INT32_MAX : query.maxBacklogs;
+
+    Json::Value list(Json::arrayValue);
+    int64_t total = 0;
+    candidates.forEach([&](uint32_t slot) {
+        if (gpa_[slot] < minGpa || backlogs_[slot] > maxBacklogs) return true;
+        ++total;
+        if (list.size() < query.limit) {
+            const Student& s = students_[slot];
+            Json::Value student;
+            student["id"] = s.userId;
+            student["name"] = s.name;
+            student["department"] = s.department;
+            student["roll_number"] = s.rollNumber;
+            student["gpa"] = s.gpa;
+            student["backlogs"] = s.backlogs;
+            Json::Value skills(Json::arrayValue);
+            for (const auto& skill : s.skills) skills.append(skill);
+            student["skills"] = skills;
+            list.append(student);
+        }
+        return true;
+    });
+
+    lock.unlock();
+
+    Json::Value result;
+    result["success"] = true;
+    result["total"] = static_cast<Json::Int64>(total);
+    result["students"] = list;
+    result["took_us"] = static_cast<Json::Int64>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - started).count());
+    return result;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "RoaringBitmap.h"
+#include <bsoncxx/document/view.hpp>
+#include <json/json.h>
+#include <cstdint>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// In-memory index over student profiles for recruiter search.
+// Each student gets a dense slot number; skills map to bitmaps of slots and
+// gpa/backlogs are kept as flat columns so predicates scan contiguous memory.
+class StudentIndexService {
+public:
+    struct Query {
+        std::vector<std::string> skills;   // all must match
+        std::vector<std::string> keywords; // all must appear in the resume
+        double minGpa = 0.0;
+        int maxBacklogs = -1;              // -1 = no limit
+        size_t limit = 50;
+    };
+
+    static StudentIndexService& instance();
+
+    // Rebuild the whole index from the students collection; logs and
+    // rethrows on failure
+    void load();
+
+    // Index a freshly written student document
+    void upsert(bsoncxx::document::view studentDoc, bool active);
+    // Apply the fields accepted by StudentController::updateProfile
+    void applyProfileUpdate(const std::string& userId, const Json::Value& changes);
+    void setActive(const std::string& userId, bool active);
+    // Keywords extracted from the student's current resume
+    void setResumeKeywords(const std::string& userId, std::vector<std::string> keywords);
+
+    // "" when the student is not indexed
+    std::string departmentOf(const std::string& userId) const;
+
+    Json::Value search(const Query& query) const;
+
+    static std::string normalizeSkill(const std::string& skill);
+
+private:
+    struct Student {
+        std::string userId;
+        std::string name;
+        std::string department;
+        std::string rollNumber;
+        double gpa = 0.0;
+        int32_t backlogs = 0;
+        std::vector<std::string> skills;
+        std::vector<std::string> keywords;
+    };
+
+    static Student fromDoc(bsoncxx::document::view doc);
+
+    StudentIndexService() = default;
+    StudentIndexService(const StudentIndexService&) = delete;
+    StudentIndexService& operator=(const StudentIndexService&) = delete;
+
+    // Callers hold the write lock
+    uint32_t slotFor(const std::string& userId);
+    void store(Student student, bool active);
+    void setSkills(uint32_t slot, std::vector<std::string> skills);
+    void setKeywords(uint32_t slot, std::vector<std::string> keywords);
+    void setGrades(uint32_t slot, double gpa, int32_t backlogs);
+
+    mutable std::shared_mutex mutex_;
+    std::unordered_map<std::string, uint32_t> slots_;
+    std::vector<Student> students_;
+    std::vector<float> gpa_;
+    std::vector<int32_t> backlogs_;
+    RoaringBitmap active_;
+    std::unordered_map<std::string, RoaringBitmap> skills_;
+    std::unordered_map<std::string, RoaringBitmap> keywords_;
+};
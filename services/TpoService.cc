@@ -1,7 +1,9 @@
 #include "TpoService.h"
+#include "IdHelper.h"
 #include "MongoService.h"
 #include "BcryptHelper.h"
 #include "PlacementService.h"
+#include "StudentIndexService.h"
 #include "JsonHelper.h"
 #include <bsoncxx/builder/basic/document.hpp>
 #include <bsoncxx/builder/basic/kvp.hpp>
@@ -37,7 +39,7 @@ Json::Value TpoService::getPendingStudents() {
         }
 
         // Get student profile for department and roll_number
-        auto profileOpt = students.find_one(make_document(kvp("user_id", id)));
+        auto profileOpt = students.find_one(make_document(kvp("user_id", IdHelper::match(id).view())));
         if (profileOpt) {
             auto profile = profileOpt->view();
             if (profile.find("department") != profile.end()) {
@@ -89,6 +91,7 @@ Json::Value TpoService::approveStudent(const std::string& userId) {
             make_document(kvp("_id", bsoncxx::oid{userId})),
             make_document(kvp("$set", make_document(kvp("status", "active"))))
         );
+        StudentIndexService::instance().setActive(userId, true);
 
         // Notify the student
         std::string name = std::string(userDoc["name"].get_string().value);
@@ -129,6 +132,7 @@ Json::Value TpoService::rejectStudent(const std::string& userId) {
             make_document(kvp("_id", bsoncxx::oid{userId})),
             make_document(kvp("$set", make_document(kvp("status", "rejected"))))
         );
+        StudentIndexService::instance().setActive(userId, false);
 
         // Notify the student
         PlacementService::createNotification(userId,
@@ -167,18 +171,13 @@ Json::Value TpoService::createRecruiterAccount(const Json::Value& body, const st
     std::string hashedPassword = BcryptHelper::hashPassword(password);
     auto now = bsoncxx::types::b_date{std::chrono::system_clock::now()};
 
-    bsoncxx::builder::basic::array drivesArr;
-    if (!driveId.empty()) {
-        drivesArr.append(driveId);
-    }
-
     auto recruiterDoc = make_document(
         kvp("name", name),
         kvp("email", email),
         kvp("password", hashedPassword),
         kvp("role", "recruiter"),
         kvp("status", "active"),
-        kvp("assigned_drives", drivesArr),
+        kvp("assigned_drives", driveId.empty() ? make_array() : IdHelper::refArray({driveId})),
         kvp("created_at", now)
     );
 
@@ -225,8 +224,8 @@ Json::Value TpoService::getAllRecruiters() {
         if (doc.find("assigned_drives") != doc.end()) {
             auto arr = doc["assigned_drives"].get_array().value;
             for (auto& driveId : arr) {
-                if (driveId.type() == bsoncxx::type::k_string) {
-                    std::string did = std::string(driveId.get_string().value);
+                std::string did = IdHelper::str(driveId);
+                if (!did.empty()) {
                     drives.append(did);
 
                     // Try to get company name for this drive
@@ -0,0 +1,543 @@
+// Load generator for the placement backend.
+//
+//   cmake -B build -DBUILD_LOADGEN=ON && cmake --build build --target loadgen
+//   ./build/loadgen --url http://127.0.0.1:8080 --scenario login,apply
+//       --connections 64 --duration 30 --drive <company id> --hgrm results/
+//
+// Scenarios follow the placement season's peaks:
+//   login          POST /api/auth/login, cycling through the student accounts
+//   apply          POST /api/students/apply against the --drive ids; once
+//                  every student has applied to every drive, the rest are
+//                  the "already applied" path
+//   notifications  GET /api/notifications as the students
+//   dashboard      the TPO dashboard's reads, round robin
+//
+// Each connection keeps one request in flight (closed loop). With --rate the
+// requests are instead scheduled at a fixed overall rate and latency is
+// measured from the scheduled time, so a stalled server is not hidden by
+// the client waiting for it (coordinated omission).
+//
+// Student accounts are --student-email with {n} = 0 .. --students-1, all
+// sharing --student-password. --seed registers them and approves them with
+// the TPO account first; rerunning it is harmless.
+//
+// Latency is kept in Metrics::Histogram (values within 12.5% of their bucket
+// edge). --hgrm writes each scenario's percentile distribution in
+// HdrHistogram's .hgrm format, in milliseconds, so runs from different
+// builds can be overlaid with its plotter.
+
+#include "Metrics.h"
+#include <drogon/HttpClient.h>
+#include <trantor/net/EventLoopThreadPool.h>
+#include <json/json.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    std::string url = "http://127.0.0.1:8080";
+    std::vector<std::string> scenarios{"login", "apply", "notifications", "dashboard"};
+    size_t connections = 64;
+    size_t threads = 4;
+    double duration = 30;
+    double warmup = 5;
+    double rate = 0;      // requests per second over all connections, 0 = closed loop
+    double timeout = 10;
+    size_t students = 200;
+    std::string studentEmail = "loadgen{n}@example.com";
+    std::string studentPassword = "loadgen-pass";
+    std::string tpoEmail;
+    std::string tpoPassword;
+    std::vector<std::string> drives;
+    std::string hgrmDir;
+    bool seed = false;
+};
+
+const char* const kUsage =
+    "usage: loadgen [options]\n"
+    "  --url URL               server to load (http://127.0.0.1:8080)\n"
+    "  --scenario LIST         login,apply,notifications,dashboard (all of them)\n"
+    "  --connections N         concurrent connections (64)\n"
+    "  --threads N             client event loops (4)\n"
+    "  --duration SECONDS      measured time per scenario (30)\n"
+    "  --warmup SECONDS        unmeasured time before it (5)\n"
+    "  --rate N                requests/s overall instead of a closed loop\n"
+    "  --timeout SECONDS       per request (10)\n"
+    "  --students N            student accounts to use (200)\n"
+    "  --student-email PATTERN {n} is the account number (loadgen{n}@example.com)\n"
+    "  --student-password PW   (loadgen-pass)\n"
+    "  --tpo-email EMAIL       TPO account, for dashboard and --seed\n"
+    "  --tpo-password PW\n"
+    "  --drive ID[,ID...]      company drives for the apply scenario\n"
+    "  --seed                  register and approve the student accounts first\n"
+    "  --hgrm DIR              write DIR/<scenario>.hgrm\n";
+
+std::vector<std::string> splitList(const std::string& s) {
+    std::vector<std::string> out;
+    std::stringstream stream(s);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) out.push_back(item);
+    }
+    return out;
+}
+
+bool parseArgs(int argc, char* argv[], Options& opts) {
+    for (int i = 1; i < argc; ++i) {
+        std::string flag = argv[i];
+        if (flag == "--seed") {
+            opts.seed = true;
+            continue;
+        }
+        if (i + 1 >= argc) return false;
+        std::string value = argv[++i];
+
+        if (flag == "--url") opts.url = value;
+        else if (flag == "--scenario") opts.scenarios = splitList(value);
+        else if (flag == "--connections") opts.connections = std::strtoul(value.c_str(), nullptr, 10);
+        else if (flag == "--threads") opts.threads = std::strtoul(value.c_str(), nullptr, 10);
+        else if (flag == "--duration") opts.duration = std::strtod(value.c_str(), nullptr);
+        else if (flag == "--warmup") opts.warmup = std::strtod(value.c_str(), nullptr);
+        else if (flag == "--rate") opts.rate = std::strtod(value.c_str(), nullptr);
+        else if (flag == "--timeout") opts.timeout = std::strtod(value.c_str(), nullptr);
+        else if (flag == "--students") opts.students = std::strtoul(value.c_str(), nullptr, 10);
+        else if (flag == "--student-email") opts.studentEmail = value;
+        else if (flag == "--student-password") opts.studentPassword = value;
+        else if (flag == "--tpo-email") opts.tpoEmail = value;
+        else if (flag == "--tpo-password") opts.tpoPassword = value;
+        else if (flag == "--drive") opts.drives = splitList(value);
+        else if (flag == "--hgrm") opts.hgrmDir = value;
+        else return false;
+    }
+    return opts.connections > 0 && opts.threads > 0 && opts.duration > 0 && opts.warmup >= 0 &&
+           opts.rate >= 0 && opts.students > 0 && !opts.scenarios.empty();
+}
+
+std::string studentEmail(const Options& opts, size_t n) {
+    std::string email = opts.studentEmail;
+    auto pos = email.find("{n}");
+    if (pos != std::string::npos) email.replace(pos, 3, std::to_string(n));
+    return email;
+}
+
+// One HttpClient per connection, spread over a few event loops
+class Pool {
+public:
+    explicit Pool(const Options& opts) : loops_(opts.threads, "loadgen") {
+        loops_.start();
+        for (size_t i = 0; i < opts.connections; ++i) {
+            clients_.push_back(drogon::HttpClient::newHttpClient(opts.url, loops_.getNextLoop()));
+        }
+    }
+
+    size_t size() const { return clients_.size(); }
+    const drogon::HttpClientPtr& operator[](size_t i) const { return clients_[i]; }
+
+private:
+    trantor::EventLoopThreadPool loops_;
+    std::vector<drogon::HttpClientPtr> clients_;
+};
+
+drogon::HttpRequestPtr jsonPost(const std::string& path, const Json::Value& body) {
+    auto req = drogon::HttpRequest::newHttpJsonRequest(body);
+    req->setMethod(drogon::Post);
+    req->setPath(path);
+    return req;
+}
+
+drogon::HttpRequestPtr authorized(drogon::HttpRequestPtr req, const std::string& token) {
+    req->addHeader("Authorization", "Bearer " + token);
+    return req;
+}
+
+drogon::HttpRequestPtr authorizedGet(const std::string& path, const std::string& token) {
+    auto req = drogon::HttpRequest::newHttpRequest();
+    req->setPath(path);
+    return authorized(req, token);
+}
+
+drogon::HttpRequestPtr loginRequest(const std::string& email, const std::string& password) {
+    Json::Value body;
+    body["email"] = email;
+    body["password"] = password;
+    return jsonPost("/api/auth/login", body);
+}
+
+// Sends `total` requests, one per connection at a time, and waits for all of
+// them. `done` gets a null response for timeouts and connection errors and
+// runs on the event loops, so it must be safe to call concurrently.
+void runEach(const Pool& pool, size_t total, double timeout,
+             const std::function<drogon::HttpRequestPtr(size_t)>& make,
+             const std::function<void(size_t, const drogon::HttpResponsePtr&)>& done) {
+    size_t lanes = std::min(pool.size(), total);
+    if (lanes == 0) return;
+
+    std::atomic<size_t> remaining{lanes};
+    std::promise<void> finished;
+    auto waiter = finished.get_future();
+
+    std::function<void(size_t, size_t)> send = [&](size_t conn, size_t i) {
+        pool[conn]->sendRequest(make(i), [&, conn, i](drogon::ReqResult result,
+                                                      const drogon::HttpResponsePtr& resp) {
+            done(i, result == drogon::ReqResult::Ok ? resp : nullptr);
+            if (i + lanes < total) {
+                send(conn, i + lanes);
+                return;
+            }
+            if (remaining.fetch_sub(1) == 1) finished.set_value();
+        }, timeout);
+    };
+    for (size_t conn = 0; conn < lanes; ++conn) send(conn, conn);
+    waiter.wait();
+}
+
+std::string tokenOf(const drogon::HttpResponsePtr& resp) {
+    if (!resp || resp->statusCode() != drogon::k200OK) return {};
+    auto json = resp->getJsonObject();
+    return json ? (*json)["token"].asString() : std::string();
+}
+
+// Logs every student in; accounts that fail are left out
+std::vector<std::string> studentTokens(const Pool& pool, const Options& opts) {
+    std::vector<std::string> tokens(opts.students);
+    runEach(pool, opts.students, opts.timeout,
+            [&](size_t i) { return loginRequest(studentEmail(opts, i), opts.studentPassword); },
+            [&](size_t i, const drogon::HttpResponsePtr& resp) { tokens[i] = tokenOf(resp); });
+
+    tokens.erase(std::remove(tokens.begin(), tokens.end(), std::string()), tokens.end());
+    if (tokens.size() < opts.students) {
+        std::cerr << "Warning: " << opts.students - tokens.size() << " of " << opts.students
+                  << " student logins failed (run with --seed to create the accounts)" << std::endl;
+    }
+    return tokens;
+}
+
+std::string tpoToken(const Pool& pool, const Options& opts) {
+    if (opts.tpoEmail.empty()) return {};
+    std::string token;
+    runEach(pool, 1, opts.timeout,
+            [&](size_t) { return loginRequest(opts.tpoEmail, opts.tpoPassword); },
+            [&](size_t, const drogon::HttpResponsePtr& resp) { token = tokenOf(resp); });
+    return token;
+}
+
+// Registers the student accounts and approves the ones still pending
+bool seedStudents(const Pool& pool, const Options& opts) {
+    std::string tpo = tpoToken(pool, opts);
+    if (tpo.empty()) {
+        std::cerr << "Error: --seed needs a working --tpo-email and --tpo-password" << std::endl;
+        return false;
+    }
+
+    std::atomic<size_t> registered{0};
+    runEach(pool, opts.students, opts.timeout,
+            [&](size_t i) {
+                Json::Value body;
+                body["name"] = "Load Test " + std::to_string(i);
+                body["email"] = studentEmail(opts, i);
+                body["password"] = opts.studentPassword;
+                body["department"] = "CSE";
+                body["roll_number"] = "LOADGEN" + std::to_string(i);
+                return jsonPost("/api/auth/register", body);
+            },
+            [&](size_t, const drogon::HttpResponsePtr& resp) {
+                if (resp && resp->statusCode() == drogon::k201Created) ++registered;
+            });
+
+    std::set<std::string> ours;
+    for (size_t i = 0; i < opts.students; ++i) ours.insert(studentEmail(opts, i));
+    std::vector<std::string> pending;
+    runEach(pool, 1, opts.timeout,
+            [&](size_t) { return authorizedGet("/api/tpo/pending-students", tpo); },
+            [&](size_t, const drogon::HttpResponsePtr& resp) {
+                auto json = resp ? resp->getJsonObject() : nullptr;
+                if (!json) return;
+                for (const auto& student : (*json)["students"]) {
+                    if (ours.count(student["email"].asString())) pending.push_back(student["id"].asString());
+                }
+            });
+
+    std::atomic<size_t> approved{0};
+    runEach(pool, pending.size(), opts.timeout,
+            [&](size_t i) {
+                auto req = authorizedGet("/api/tpo/students/" + pending[i] + "/approve", tpo);
+                req->setMethod(drogon::Put);
+                return req;
+            },
+            [&](size_t, const drogon::HttpResponsePtr& resp) {
+                if (resp && resp->statusCode() == drogon::k200OK) ++approved;
+            });
+
+    std::cout << "seed: registered " << registered.load() << ", approved " << approved.load() << " of "
+              << pending.size() << " pending" << std::endl;
+    return true;
+}
+
+struct Result {
+    Metrics::Histogram latency;
+    std::atomic<uint64_t> completed{0};   // finished inside the measured window
+    std::atomic<uint64_t> failed{0};      // timeouts and connection errors
+    std::atomic<uint64_t> byClass[6] = {};  // by status / 100
+};
+
+// Builds a connection's n-th request
+using RequestMaker = std::function<drogon::HttpRequestPtr(size_t conn, uint64_t n)>;
+
+// Drives every connection until the window closes. Requests scheduled during
+// the warmup are sent but not recorded.
+class Run {
+public:
+    Run(const Pool& pool, const Options& opts, RequestMaker make, Result& result)
+        : pool_(pool), opts_(opts), make_(std::move(make)), result_(result) {}
+
+    void execute() {
+        auto start = Clock::now();
+        measureFrom_ = start + toDuration(opts_.warmup);
+        end_ = measureFrom_ + toDuration(opts_.duration);
+        if (opts_.rate > 0) interval_ = toDuration(static_cast<double>(pool_.size()) / opts_.rate);
+
+        active_ = pool_.size();
+        auto waiter = done_.get_future();
+        for (size_t conn = 0; conn < pool_.size(); ++conn) {
+            // Stagger the schedules so a rate run does not start with a burst
+            auto first = start + interval_ * conn / pool_.size();
+            scheduleAt(conn, 0, first);
+        }
+        waiter.wait();
+    }
+
+private:
+    static Clock::duration toDuration(double seconds) {
+        return std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds));
+    }
+
+    void scheduleAt(size_t conn, uint64_t n, Clock::time_point intended) {
+        auto now = Clock::now();
+        if (intended <= now) {
+            issue(conn, n, intended);
+            return;
+        }
+        double delay = std::chrono::duration<double>(intended - now).count();
+        pool_[conn]->getLoop()->runAfter(delay, [this, conn, n, intended]() { issue(conn, n, intended); });
+    }
+
+    void issue(size_t conn, uint64_t n, Clock::time_point intended) {
+        pool_[conn]->sendRequest(make_(conn, n), [this, conn, n, intended](drogon::ReqResult outcome,
+                                                                           const drogon::HttpResponsePtr& resp) {
+            auto now = Clock::now();
+            if (intended >= measureFrom_) {
+                if (now <= end_) result_.completed.fetch_add(1, std::memory_order_relaxed);
+                if (outcome != drogon::ReqResult::Ok || !resp) {
+                    result_.failed.fetch_add(1, std::memory_order_relaxed);
+                } else {
+                    result_.latency.record(now - intended);
+                    size_t cls = std::min<size_t>(static_cast<size_t>(resp->statusCode()) / 100, 5);
+                    result_.byClass[cls].fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+
+            // Closed loop: straight on. Rate: the next slot, even if it has passed
+            auto next = interval_.count() > 0 ? intended + interval_ : now;
+            if (next >= end_) {
+                if (active_.fetch_sub(1) == 1) done_.set_value();
+                return;
+            }
+            scheduleAt(conn, n + 1, next);
+        }, opts_.timeout);
+    }
+
+    const Pool& pool_;
+    const Options& opts_;
+    RequestMaker make_;
+    Result& result_;
+    Clock::time_point measureFrom_;
+    Clock::time_point end_;
+    Clock::duration interval_{0};
+    std::atomic<size_t> active_{0};
+    std::promise<void> done_;
+};
+
+double ms(uint64_t micros) {
+    return static_cast<double>(micros) / 1000.0;
+}
+
+// HdrHistogram's outputPercentileDistribution layout: 5 ticks per halving of
+// the distance to 100%, then a footer the plotter ignores but people read
+std::string percentileDistribution(const Metrics::Histogram::Snapshot& s) {
+    using Histogram = Metrics::Histogram;
+    std::string out = "       Value     Percentile TotalCount 1/(1-Percentile)\n\n";
+    if (s.count == 0) return out;
+
+    auto at = [&](double q) -> std::pair<uint64_t, uint64_t> {
+        uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(q * s.count)));
+        uint64_t seen = 0;
+        for (size_t b = 0; b < s.buckets.size(); ++b) {
+            seen += s.buckets[b];
+            if (seen >= rank) return {Histogram::upperEdge(b), seen};
+        }
+        return {Histogram::upperEdge(s.buckets.size() - 1), seen};
+    };
+
+    char line[128];
+    double percentile = 0;
+    for (;;) {
+        auto [value, seen] = at(percentile / 100.0);
+        if (seen >= s.count) {
+            std::snprintf(line, sizeof(line), "%12.3f %14.12f %10llu\n", ms(value), 1.0,
+                          static_cast<unsigned long long>(seen));
+            out += line;
+            break;
+        }
+        std::snprintf(line, sizeof(line), "%12.3f %14.12f %10llu %14.2f\n", ms(value), percentile / 100.0,
+                      static_cast<unsigned long long>(seen), 1.0 / (1.0 - percentile / 100.0));
+        out += line;
+        double halfDistance = std::pow(2.0, std::floor(std::log2(100.0 / (100.0 - percentile))) + 1);
+        percentile += 100.0 / (5 * halfDistance);
+    }
+
+    // Bucket midpoints stand in for the values
+    double mean = static_cast<double>(s.sumMicros) / static_cast<double>(s.count);
+    double variance = 0;
+    uint64_t max = 0;
+    for (size_t b = 0; b < s.buckets.size(); ++b) {
+        if (s.buckets[b] == 0) continue;
+        uint64_t lower = b == 0 ? 0 : Histogram::upperEdge(b - 1);
+        double mid = (static_cast<double>(lower) + static_cast<double>(Histogram::upperEdge(b))) / 2.0;
+        variance += static_cast<double>(s.buckets[b]) * (mid - mean) * (mid - mean);
+        max = Histogram::upperEdge(b);
+    }
+    double stddev = std::sqrt(variance / static_cast<double>(s.count));
+
+    std::snprintf(line, sizeof(line), "#[Mean    = %12.3f, StdDeviation   = %12.3f]\n", mean / 1000.0, stddev / 1000.0);
+    out += line;
+    std::snprintf(line, sizeof(line), "#[Max     = %12.3f, Total count    = %12llu]\n", ms(max),
+                  static_cast<unsigned long long>(s.count));
+    out += line;
+    std::snprintf(line, sizeof(line), "#[Buckets = %12zu, SubBuckets     = %12zu]\n", Histogram::kBuckets,
+                  Histogram::kSub);
+    out += line;
+    return out;
+}
+
+void report(const std::string& name, const Options& opts, const Result& result) {
+    auto s = result.latency.snapshot();
+    double throughput = static_cast<double>(result.completed.load()) / opts.duration;
+
+    char line[256];
+    std::snprintf(line, sizeof(line), "%s: %llu requests in %.1fs, %.1f req/s over %zu connections (%s)\n",
+                  name.c_str(), static_cast<unsigned long long>(result.completed.load()), opts.duration,
+                  throughput, opts.connections, opts.rate > 0 ? "fixed rate" : "closed loop");
+    std::cout << line;
+    std::snprintf(line, sizeof(line), "  latency ms  p50 %.3f  p90 %.3f  p99 %.3f  p999 %.3f  max %.3f\n",
+                  ms(s.quantile(0.5)), ms(s.quantile(0.9)), ms(s.quantile(0.99)), ms(s.quantile(0.999)),
+                  ms(s.quantile(1.0)));
+    std::cout << line;
+    std::cout << "  responses  ";
+    for (size_t cls = 1; cls < 6; ++cls) {
+        uint64_t n = result.byClass[cls].load();
+        if (n > 0) std::cout << cls << "xx " << n << "  ";
+    }
+    std::cout << "errors " << result.failed.load() << std::endl;
+
+    if (opts.hgrmDir.empty()) return;
+    std::string path = opts.hgrmDir + "/" + name + ".hgrm";
+    std::ofstream file(path);
+    if (!file) {
+        std::cerr << "Warning: Could not write " << path << std::endl;
+        return;
+    }
+    file << percentileDistribution(s);
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    Options opts;
+    if (!parseArgs(argc, argv, opts)) {
+        std::cerr << kUsage;
+        return 2;
+    }
+
+    Pool pool(opts);
+    if (opts.seed && !seedStudents(pool, opts)) return 1;
+
+    // Tokens are fetched once, before anything is measured
+    std::vector<std::string> students;
+    std::string tpo;
+    bool failed = false;
+
+    for (const auto& name : opts.scenarios) {
+        RequestMaker make;
+        size_t conns = pool.size();
+
+        if (name == "login") {
+            make = [&opts, conns](size_t conn, uint64_t n) {
+                return loginRequest(studentEmail(opts, (conn + n * conns) % opts.students), opts.studentPassword);
+            };
+        } else if (name == "apply" || name == "notifications") {
+            if (name == "apply" && opts.drives.empty()) {
+                std::cerr << "Error: apply needs --drive" << std::endl;
+                failed = true;
+                continue;
+            }
+            if (students.empty()) students = studentTokens(pool, opts);
+            if (students.empty()) {
+                std::cerr << "Error: " << name << " needs student accounts that can log in" << std::endl;
+                failed = true;
+                continue;
+            }
+            if (name == "apply") {
+                // Student-major, so the first students x drives requests are all new applications
+                make = [&opts, &students, conns](size_t conn, uint64_t n) {
+                    uint64_t k = conn + n * conns;
+                    Json::Value body;
+                    body["company_id"] = opts.drives[(k / students.size()) % opts.drives.size()];
+                    return authorized(jsonPost("/api/students/apply", body), students[k % students.size()]);
+                };
+            } else {
+                make = [&students, conns](size_t conn, uint64_t n) {
+                    return authorizedGet("/api/notifications", students[(conn + n * conns) % students.size()]);
+                };
+            }
+        } else if (name == "dashboard") {
+            if (tpo.empty()) tpo = tpoToken(pool, opts);
+            if (tpo.empty()) {
+                std::cerr << "Error: dashboard needs a working --tpo-email and --tpo-password" << std::endl;
+                failed = true;
+                continue;
+            }
+            static const char* const kDashboard[] = {
+                "/api/analytics", "/api/analytics/trends", "/api/tpo/pending-students", "/api/notifications"
+            };
+            make = [&tpo](size_t conn, uint64_t n) {
+                return authorizedGet(kDashboard[(conn + n) % std::size(kDashboard)], tpo);
+            };
+        } else {
+            std::cerr << "Error: unknown scenario " << name << std::endl;
+            failed = true;
+            continue;
+        }
+
+        Result result;
+        Run(pool, opts, std::move(make), result).execute();
+        report(name, opts, result);
+    }
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+// Application lifecycle. Strings only appear at the edges (request bodies,
+// stored documents); inside the server a status is this enum.
+enum class AppStatus : uint8_t {
+    Applied,
+    Shortlisted,
+    Interviewed,
+    Selected,
+    Rejected
+};
+
+namespace app_status_detail {
+
+constexpr uint8_t bit(AppStatus s) { return static_cast<uint8_t>(1u << static_cast<unsigned>(s)); }
+
+constexpr std::array<std::string_view, 5> kNames = {
+    "APPLIED", "SHORTLISTED", "INTERVIEWED", "SELECTED", "REJECTED"
+};
+
+// kNext[from] has bit `to` set when from -> to is allowed
+constexpr std::array<uint8_t, 5> kNext = {
+    bit(AppStatus::Shortlisted) | bit(AppStatus::Rejected),
+    bit(AppStatus::Interviewed) | bit(AppStatus::Rejected),
+    bit(AppStatus::Selected) | bit(AppStatus::Rejected),
+    0,
+    0
+};
+
+} // namespace app_status_detail
+
+class ApplicationStatus {
+public:
+    static constexpr size_t kCount = 5;
+
+    static constexpr std::array<AppStatus, kCount> all() {
+        return {AppStatus::Applied, AppStatus::Shortlisted, AppStatus::Interviewed,
+                AppStatus::Selected, AppStatus::Rejected};
+    }
+
+    static constexpr size_t index(AppStatus s) { return static_cast<size_t>(s); }
+    static constexpr uint8_t bit(AppStatus s) { return app_status_detail::bit(s); }
+
+    static constexpr std::string_view name(AppStatus s) { return app_status_detail::kNames[index(s)]; }
+
+    static constexpr std::optional<AppStatus> parse(std::string_view text) {
+        for (AppStatus s : all()) {
+            if (app_status_detail::kNames[index(s)] == text) return s;
+        }
+        return std::nullopt;
+    }
+
+    static constexpr bool canTransition(AppStatus from, AppStatus to) {
+        return (app_status_detail::kNext[index(from)] >> index(to)) & 1u;
+    }
+
+    // Bitmask of the statuses that can move to `to` in one step
+    static constexpr uint8_t predecessors(AppStatus to) {
+        uint8_t mask = 0;
+        for (AppStatus s : all()) {
+            if (canTransition(s, to)) mask |= bit(s);
+        }
+        return mask;
+    }
+
+    static constexpr bool isTerminal(AppStatus s) { return app_status_detail::kNext[index(s)] == 0; }
+};
+
+static_assert(ApplicationStatus::canTransition(AppStatus::Applied, AppStatus::Shortlisted));
+static_assert(!ApplicationStatus::canTransition(AppStatus::Applied, AppStatus::Selected));
+static_assert(!ApplicationStatus::canTransition(AppStatus::Selected, AppStatus::Rejected));
+static_assert(ApplicationStatus::predecessors(AppStatus::Rejected) == 0b00111);
+static_assert(ApplicationStatus::parse("INTERVIEWED") == AppStatus::Interviewed);
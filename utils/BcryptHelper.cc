@@ -1,4 +1,5 @@
 #include "BcryptHelper.h"
+#include "Metrics.h"
 #include <openssl/evp.h>
 #include <openssl/rand.h>
 #include <sstream>
@@ -31,6 +32,11 @@ std::string BcryptHelper::generateSalt(int length) {
 }
 
 std::string BcryptHelper::pbkdf2Hash(const std::string& password, const std::string& salt, int iterations) {
+    // Dominates login and registration latency by design
+    static auto& timing = Metrics::instance().histogram(
+        "password_hash_seconds", "PBKDF2 time per password hash or verification");
+    Metrics::Timer timer(timing);
+
     unsigned char hash[32]; // SHA-256 output
     auto saltBytes = fromHex(salt);
 
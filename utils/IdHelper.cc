@@ -0,0 +1,90 @@
+#include "IdHelper.h"
+#include <bsoncxx/builder/basic/array.hpp>
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/builder/basic/kvp.hpp>
+#include <bsoncxx/oid.hpp>
+#include <bsoncxx/types.hpp>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+using bsoncxx::builder::basic::kvp;
+using bsoncxx::builder::basic::make_document;
+
+IdHelper::Format IdHelper::format() {
+    static const Format fmt = []() {
+        const char* env = std::getenv("ID_FORMAT");
+        if (!env || std::strcmp(env, "string") == 0) return Format::String;
+        if (std::strcmp(env, "dual") == 0) return Format::Dual;
+        if (std::strcmp(env, "oid") == 0) return Format::ObjectId;
+        std::cerr << "Warning: Unknown ID_FORMAT '" << env << "', using string" << std::endl;
+        return Format::String;
+    }();
+    return fmt;
+}
+
+const char* IdHelper::formatName() {
+    switch (format()) {
+        case Format::Dual: return "dual";
+        case Format::ObjectId: return "oid";
+        default: return "string";
+    }
+}
+
+bool IdHelper::isHexOid(const std::string& hex) {
+    if (hex.size() != 24) return false;
+    for (char c : hex) {
+        bool digit = c >= '0' && c <= '9';
+        bool lower = c >= 'a' && c <= 'f';
+        bool upper = c >= 'A' && c <= 'F';
+        if (!digit && !lower && !upper) return false;
+    }
+    return true;
+}
+
+bsoncxx::types::bson_value::value IdHelper::ref(const std::string& hex) {
+    if (format() != Format::String && isHexOid(hex)) {
+        return bsoncxx::types::bson_value::value{bsoncxx::types::b_oid{bsoncxx::oid{hex}}};
+    }
+    return bsoncxx::types::bson_value::value{hex};
+}
+
+bsoncxx::types::bson_value::value IdHelper::match(const std::string& hex) {
+    if (format() != Format::Dual || !isHexOid(hex)) return ref(hex);
+    auto either = make_document(kvp("$in", bsoncxx::builder::basic::make_array(bsoncxx::oid{hex}, hex)));
+    return bsoncxx::types::bson_value::value{bsoncxx::types::b_document{either.view()}};
+}
+
+bsoncxx::array::value IdHelper::matchAny(const std::vector<std::string>& hexes) {
+    bsoncxx::builder::basic::array arr;
+    for (const auto& hex : hexes) {
+        bool oid = format() != Format::String && isHexOid(hex);
+        if (oid) arr.append(bsoncxx::oid{hex});
+        if (!oid || format() == Format::Dual) arr.append(hex);
+    }
+    return arr.extract();
+}
+
+bsoncxx::array::value IdHelper::refArray(const std::vector<std::string>& hexes) {
+    bsoncxx::builder::basic::array arr;
+    for (const auto& hex : hexes) arr.append(ref(hex).view());
+    return arr.extract();
+}
+
+std::string IdHelper::str(const bsoncxx::types::bson_value::view& value) {
+    switch (value.type()) {
+        case bsoncxx::type::k_oid: return value.get_oid().value.to_string();
+        case bsoncxx::type::k_string: return std::string(value.get_string().value);
+        default: return "";
+    }
+}
+
+std::string IdHelper::str(const bsoncxx::document::element& el) {
+    if (!el) return "";
+    return str(el.get_value());
+}
+
+std::string IdHelper::str(const bsoncxx::array::element& el) {
+    if (!el) return "";
+    return str(el.get_value());
+}
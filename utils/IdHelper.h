@@ -0,0 +1,39 @@
+#pragma once
+
+#include <bsoncxx/array/element.hpp>
+#include <bsoncxx/array/value.hpp>
+#include <bsoncxx/document/element.hpp>
+#include <bsoncxx/types/bson_value/value.hpp>
+#include <bsoncxx/types/bson_value/view.hpp>
+#include <string>
+#include <vector>
+
+// Cross-collection references (student_id, company_id, user_id,
+// assigned_drives, recruiter_id, created_by) during the move from hex
+// strings to ObjectId. ID_FORMAT selects the phase:
+//   string  write strings, match strings (legacy, default)
+//   dual    write ObjectId, match either form while the migration runs
+//   oid     write ObjectId, match ObjectId only (final switch)
+class IdHelper {
+public:
+    enum class Format { String, Dual, ObjectId };
+
+    static Format format();
+    static const char* formatName();
+
+    // Value to store for a new reference
+    static bsoncxx::types::bson_value::value ref(const std::string& hex);
+    // Filter value that matches a stored reference in the current phase
+    static bsoncxx::types::bson_value::value match(const std::string& hex);
+    // Operand for $in over several references
+    static bsoncxx::array::value matchAny(const std::vector<std::string>& hexes);
+    // Array of references to store (assigned_drives)
+    static bsoncxx::array::value refArray(const std::vector<std::string>& hexes);
+
+    // Hex string for a stored reference of either type, "" otherwise
+    static std::string str(const bsoncxx::document::element& el);
+    static std::string str(const bsoncxx::array::element& el);
+    static std::string str(const bsoncxx::types::bson_value::view& value);
+
+    static bool isHexOid(const std::string& hex);
+};
@@ -1,11 +1,35 @@
 #include "JsonHelper.h"
+#include "RequestTrace.h"
 #include <bsoncxx/types.hpp>
 #include <sstream>
 
+namespace {
+
+// Reference fields keep their plain hex-string shape in API responses
+// whether they are stored as strings or ObjectIds (see IdHelper)
+const char* const kReferenceFields[] = {
+    "user_id", "student_id", "company_id", "recruiter_id", "created_by", "assigned_drives"
+};
+
+void flattenOid(Json::Value& value) {
+    if (value.isObject() && value.size() == 1 && value.isMember("$oid")) {
+        value = value["$oid"].asString();
+    } else if (value.isArray()) {
+        for (auto& el : value) flattenOid(el);
+    }
+}
+
+} // anonymous namespace
+
 Json::Value JsonHelper::bsonToJson(bsoncxx::document::view doc) {
+    RequestTrace::Scope scope(RequestTrace::Phase::Transform);
     // Use bsoncxx's built-in JSON conversion then parse
     std::string jsonStr = bsoncxx::to_json(doc);
-    return parse(jsonStr);
+    Json::Value json = parse(jsonStr);
+    for (const char* field : kReferenceFields) {
+        if (json.isMember(field)) flattenOid(json[field]);
+    }
+    return json;
 }
 
 bsoncxx::document::value JsonHelper::jsonToBson(const Json::Value& json) {
@@ -41,3 +65,9 @@ Json::Value JsonHelper::successResponse(const std::string& message) {
     res["message"] = message;
     return res;
 }
+
+drogon::HttpResponsePtr JsonHelper::jsonResponse(const Json::Value& json) {
+    // drogon writes the body here, not when the response is sent
+    RequestTrace::Scope scope(RequestTrace::Phase::Serialize);
+    return drogon::HttpResponse::newHttpJsonResponse(json);
+}
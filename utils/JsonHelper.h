@@ -1,6 +1,7 @@
 #pragma once
 
 #include <json/json.h>
+#include <drogon/HttpResponse.h>
 #include <bsoncxx/document/view.hpp>
 #include <bsoncxx/document/value.hpp>
 #include <bsoncxx/builder/basic/document.hpp>
@@ -19,4 +20,6 @@ public:
     static std::string stringify(const Json::Value& json);
     static Json::Value errorResponse(const std::string& message);
     static Json::Value successResponse(const std::string& message);
+    // newHttpJsonResponse, timed as the request's serialize phase (RequestTrace)
+    static drogon::HttpResponsePtr jsonResponse(const Json::Value& json);
 };
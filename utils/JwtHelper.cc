@@ -1,4 +1,5 @@
 #include "JwtHelper.h"
+#include "Metrics.h"
 #include <openssl/hmac.h>
 #include <openssl/bio.h>
 #include <openssl/evp.h>
@@ -105,6 +106,11 @@ std::string JwtHelper::generateToken(const std::string& userId, const std::strin
 }
 
 Json::Value JwtHelper::verifyToken(const std::string& token) {
+    // Runs in AuthFilter on every authenticated request
+    static auto& timing = Metrics::instance().histogram(
+        "jwt_verify_seconds", "JWT signature check and payload parse time");
+    Metrics::Timer timer(timing);
+
     Json::Value result;
 
     // Split token into parts
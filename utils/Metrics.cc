@@ -0,0 +1,215 @@
+#include "Metrics.h"
+#include <cmath>
+#include <cstdio>
+#include <mutex>
+#include <sstream>
+
+namespace {
+
+// Prometheus-side bucket edges, in seconds. Fine buckets are folded into the
+// first edge at or above their own upper edge.
+const double kExportEdges[] = {0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05,
+                               0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0};
+
+std::string escapeLabel(const std::string& value) {
+    std::string out;
+    out.reserve(value.size());
+    for (char c : value) {
+        if (c == '\\' || c == '"') {
+            out += '\\';
+            out += c;
+        } else if (c == '\n') {
+            out += "\\n";
+        } else {
+            out += c;
+        }
+    }
+    return out;
+}
+
+std::string formatDouble(double v) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.9g", v);
+    return buf;
+}
+
+// Adds `le` to an already rendered label set
+std::string withLe(const std::string& labels, const std::string& le) {
+    if (labels.empty()) return "{le=\"" + le + "\"}";
+    return labels.substr(0, labels.size() - 1) + ",le=\"" + le + "\"}";
+}
+
+} // anonymous namespace
+
+size_t Metrics::shard() {
+    static std::atomic<size_t> next{0};
+    thread_local size_t mine = next.fetch_add(1, std::memory_order_relaxed) % kShards;
+    return mine;
+}
+
+void Metrics::Counter::add(uint64_t n) {
+    cells_[shard()].value.fetch_add(n, std::memory_order_relaxed);
+}
+
+uint64_t Metrics::Counter::value() const {
+    uint64_t total = 0;
+    for (const auto& cell : cells_) total += cell.value.load(std::memory_order_relaxed);
+    return total;
+}
+
+size_t Metrics::Histogram::bucketFor(uint64_t micros) {
+    if (micros < kSub) return static_cast<size_t>(micros);
+    int power = 63 - __builtin_clzll(micros);
+    if (power > kMaxPower) return kBuckets - 1;
+    size_t sub = static_cast<size_t>(micros >> (power - kSubBits)) & (kSub - 1);
+    return kSub + static_cast<size_t>(power - kSubBits) * kSub + sub;
+}
+
+uint64_t Metrics::Histogram::upperEdge(size_t bucket) {
+    if (bucket < kSub) return bucket + 1;
+    size_t power = (bucket - kSub) / kSub + kSubBits;
+    uint64_t sub = (bucket - kSub) % kSub;
+    return (kSub + sub + 1) << (power - kSubBits);
+}
+
+void Metrics::Histogram::recordMicros(uint64_t micros) {
+    Shard& s = shards_[shard()];
+    s.buckets[bucketFor(micros)].fetch_add(1, std::memory_order_relaxed);
+    s.count.fetch_add(1, std::memory_order_relaxed);
+    s.sumMicros.fetch_add(micros, std::memory_order_relaxed);
+}
+
+void Metrics::Histogram::record(std::chrono::nanoseconds elapsed) {
+    auto micros = std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+    recordMicros(micros > 0 ? static_cast<uint64_t>(micros) : 0);
+}
+
+Metrics::Histogram::Snapshot Metrics::Histogram::snapshot() const {
+    Snapshot snap;
+    snap.buckets.assign(kBuckets, 0);
+    for (const auto& s : shards_) {
+        for (size_t i = 0; i < kBuckets; ++i) {
+            snap.buckets[i] += s.buckets[i].load(std::memory_order_relaxed);
+        }
+        snap.count += s.count.load(std::memory_order_relaxed);
+        snap.sumMicros += s.sumMicros.load(std::memory_order_relaxed);
+    }
+    return snap;
+}
+
+uint64_t Metrics::Histogram::Snapshot::quantile(double q) const {
+    uint64_t total = 0;
+    for (uint64_t n : buckets) total += n;
+    if (total == 0) return 0;
+    uint64_t rank = static_cast<uint64_t>(std::ceil(q * static_cast<double>(total)));
+    if (rank == 0) rank = 1;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < buckets.size(); ++i) {
+        seen += buckets[i];
+        if (seen >= rank) return upperEdge(i);
+    }
+    return upperEdge(buckets.size() - 1);
+}
+
+Metrics& Metrics::instance() {
+    static Metrics metrics;
+    return metrics;
+}
+
+std::string Metrics::renderLabels(const Labels& labels) {
+    if (labels.empty()) return "";
+    std::string out = "{";
+    for (size_t i = 0; i < labels.size(); ++i) {
+        if (i > 0) out += ",";
+        out += labels[i].first + "=\"" + escapeLabel(labels[i].second) + "\"";
+    }
+    return out + "}";
+}
+
+Metrics::Counter& Metrics::counter(const std::string& name, const std::string& help, const Labels& labels) {
+    std::string key = renderLabels(labels);
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        auto family = families_.find(name);
+        if (family != families_.end()) {
+            auto it = family->second.counters.find(key);
+            if (it != family->second.counters.end()) return *it->second;
+        }
+    }
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    Family& family = families_[name];
+    family.help = help;
+    family.type = Type::Counter;
+    auto& slot = family.counters[key];
+    if (!slot) slot = std::make_unique<Counter>();
+    return *slot;
+}
+
+Metrics::Histogram& Metrics::histogram(const std::string& name, const std::string& help, const Labels& labels) {
+    std::string key = renderLabels(labels);
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        auto family = families_.find(name);
+        if (family != families_.end()) {
+            auto it = family->second.histograms.find(key);
+            if (it != family->second.histograms.end()) return *it->second;
+        }
+    }
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    Family& family = families_[name];
+    family.help = help;
+    family.type = Type::Histogram;
+    auto& slot = family.histograms[key];
+    if (!slot) slot = std::make_unique<Histogram>();
+    return *slot;
+}
+
+void Metrics::gauge(const std::string& name, const std::string& help, std::function<double()> read) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    Family& family = families_[name];
+    family.help = help;
+    family.type = Type::Gauge;
+    family.gauge = std::move(read);
+}
+
+std::string Metrics::render() const {
+    std::ostringstream out;
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    for (const auto& [name, family] : families_) {
+        out << "# HELP " << name << " " << family.help << "\n";
+        switch (family.type) {
+            case Type::Counter:
+                out << "# TYPE " << name << " counter\n";
+                for (const auto& [labels, counter] : family.counters) {
+                    out << name << labels << " " << counter->value() << "\n";
+                }
+                break;
+            case Type::Gauge:
+                out << "# TYPE " << name << " gauge\n";
+                out << name << " " << formatDouble(family.gauge ? family.gauge() : 0.0) << "\n";
+                break;
+            case Type::Histogram:
+                out << "# TYPE " << name << " histogram\n";
+                for (const auto& [labels, histogram] : family.histograms) {
+                    auto snap = histogram->snapshot();
+                    size_t bucket = 0;
+                    uint64_t cumulative = 0;
+                    for (double edge : kExportEdges) {
+                        uint64_t edgeMicros = static_cast<uint64_t>(edge * 1e6);
+                        while (bucket < Histogram::kBuckets && Histogram::upperEdge(bucket) <= edgeMicros) {
+                            cumulative += snap.buckets[bucket++];
+                        }
+                        out << name << "_bucket" << withLe(labels, formatDouble(edge)) << " " << cumulative << "\n";
+                    }
+                    // Shards are read while other threads write; derive the
+                    // total from the buckets so the series stays monotonic
+                    while (bucket < Histogram::kBuckets) cumulative += snap.buckets[bucket++];
+                    out << name << "_bucket" << withLe(labels, "+Inf") << " " << cumulative << "\n";
+                    out << name << "_sum" << labels << " " << formatDouble(snap.sumMicros / 1e6) << "\n";
+                    out << name << "_count" << labels << " " << cumulative << "\n";
+                }
+                break;
+        }
+    }
+    return out.str();
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Process-wide metrics in Prometheus text format.
+//
+// Counters and histograms are sharded: each thread adds to its own
+// cache-line-aligned slot with a relaxed atomic, so recording never takes a
+// lock or bounces a cache line between the IO threads. Shards are summed
+// only when /metrics is scraped. Handles returned by the registry live for
+// the whole process; keep them in a static where the labels are fixed.
+class Metrics {
+public:
+    using Labels = std::vector<std::pair<std::string, std::string>>;
+
+    static constexpr size_t kShards = 8;
+
+    class Counter {
+    public:
+        void add(uint64_t n = 1);
+        uint64_t value() const;
+
+    private:
+        struct alignas(64) Cell {
+            std::atomic<uint64_t> value{0};
+        };
+        Cell cells_[kShards];
+    };
+
+    // Log-linear buckets over microseconds, HDR-style: 8 linear sub-buckets
+    // per power of two, so any recorded value is within 12.5% of its bucket
+    // edge from 1us up to ~19 hours.
+    class Histogram {
+    public:
+        static constexpr int kSubBits = 3;
+        static constexpr size_t kSub = 1 << kSubBits;
+        static constexpr int kMaxPower = 36;
+        static constexpr size_t kBuckets = kSub + (kMaxPower - kSubBits + 1) * kSub;
+
+        void record(std::chrono::nanoseconds elapsed);
+        void recordMicros(uint64_t micros);
+
+        struct Snapshot {
+            std::vector<uint64_t> buckets;
+            uint64_t count = 0;
+            uint64_t sumMicros = 0;
+
+            // Upper edge of the bucket holding quantile q, in microseconds
+            uint64_t quantile(double q) const;
+        };
+        Snapshot snapshot() const;
+
+        static size_t bucketFor(uint64_t micros);
+        // Exclusive upper edge of a bucket, in microseconds
+        static uint64_t upperEdge(size_t bucket);
+
+    private:
+        struct alignas(64) Shard {
+            std::atomic<uint64_t> buckets[kBuckets] = {};
+            std::atomic<uint64_t> count{0};
+            std::atomic<uint64_t> sumMicros{0};
+        };
+        Shard shards_[kShards];
+    };
+
+    // Records the time from construction to destruction
+    class Timer {
+    public:
+        explicit Timer(Histogram& histogram)
+            : histogram_(histogram), started_(std::chrono::steady_clock::now()) {}
+        ~Timer() { histogram_.record(std::chrono::steady_clock::now() - started_); }
+        Timer(const Timer&) = delete;
+        Timer& operator=(const Timer&) = delete;
+
+    private:
+        Histogram& histogram_;
+        std::chrono::steady_clock::time_point started_;
+    };
+
+    static Metrics& instance();
+
+    Counter& counter(const std::string& name, const std::string& help, const Labels& labels = {});
+    // Latency in seconds on the exposition side, microseconds internally
+    Histogram& histogram(const std::string& name, const std::string& help, const Labels& labels = {});
+    // Sampled at scrape time (queue depths, readiness)
+    void gauge(const std::string& name, const std::string& help, std::function<double()> read);
+
+    std::string render() const;
+
+    // Shard of the calling thread
+    static size_t shard();
+
+private:
+    enum class Type { Counter, Histogram, Gauge };
+
+    struct Family {
+        std::string help;
+        Type type;
+        std::map<std::string, std::unique_ptr<Counter>> counters;
+        std::map<std::string, std::unique_ptr<Histogram>> histograms;
+        std::function<double()> gauge;
+    };
+
+    Metrics() = default;
+    Metrics(const Metrics&) = delete;
+    Metrics& operator=(const Metrics&) = delete;
+
+    static std::string renderLabels(const Labels& labels);
+
+    mutable std::shared_mutex mutex_;
+    std::map<std::string, Family> families_;
+};
@@ -0,0 +1,316 @@
+#include "PdfText.h"
+#include <zlib.h>
+#include <algorithm>
+#include <cctype>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace {
+
+// A 5MB PDF has no business inflating past this; guards against zip bombs
+constexpr size_t kMaxInflated = 8 * 1024 * 1024;
+constexpr size_t kMaxInflatedTotal = 32 * 1024 * 1024;
+
+bool inflateStream(const char* data, size_t length, std::string& out) {
+    z_stream zs{};
+    if (inflateInit(&zs) != Z_OK) return false;
+    zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+    zs.avail_in = static_cast<uInt>(length);
+
+    char buf[16384];
+    int ret = Z_OK;
+    while (ret == Z_OK && out.size() < kMaxInflated) {
+        zs.next_out = reinterpret_cast<Bytef*>(buf);
+        zs.avail_out = sizeof(buf);
+        ret = inflate(&zs, Z_NO_FLUSH);
+        out.append(buf, sizeof(buf) - zs.avail_out);
+        if (ret == Z_BUF_ERROR && zs.avail_in == 0) break;  // truncated but usable
+    }
+    inflateEnd(&zs);
+    return ret == Z_STREAM_END || ret == Z_OK || ret == Z_BUF_ERROR;
+}
+
+bool isDelimiter(char c) {
+    return std::isspace(static_cast<unsigned char>(c)) || c == '(' || c == ')' || c == '<' ||
+           c == '>' || c == '[' || c == ']' || c == '{' || c == '}' || c == '/' || c == '%';
+}
+
+// Appends shown string bytes, mapping anything unprintable to a space
+void appendShown(std::string& text, const std::string& raw) {
+    // UTF-16BE with a byte order mark: keep the ASCII code units
+    if (raw.size() >= 2 && static_cast<unsigned char>(raw[0]) == 0xFE &&
+        static_cast<unsigned char>(raw[1]) == 0xFF) {
+        for (size_t i = 2; i + 1 < raw.size(); i += 2) {
+            char c = raw[i] == 0 ? raw[i + 1] : ' ';
+            text += std::isprint(static_cast<unsigned char>(c)) ? c : ' ';
+        }
+        return;
+    }
+    for (char c : raw) {
+        text += std::isprint(static_cast<unsigned char>(c)) ? c : ' ';
+    }
+}
+
+class ContentParser {
+public:
+    ContentParser(const std::string& src, std::string& text, size_t maxText)
+        : src_(src), text_(text), maxText_(maxText) {}
+
+    void run() {
+        while (pos_ < src_.size() && text_.size() < maxText_) {
+            char c = src_[pos_];
+            if (std::isspace(static_cast<unsigned char>(c))) {
+                ++pos_;
+            } else if (c == '%') {
+                while (pos_ < src_.size() && src_[pos_] != '\n' && src_[pos_] != '\r') ++pos_;
+            } else if (c == '(') {
+                operands_.push_back(literal());
+            } else if (c == '<' && pos_ + 1 < src_.size() && src_[pos_ + 1] == '<') {
+                pos_ += 2;
+            } else if (c == '>' && pos_ + 1 < src_.size() && src_[pos_ + 1] == '>') {
+                pos_ += 2;
+            } else if (c == '<') {
+                operands_.push_back(hex());
+            } else if (c == '[') {
+                ++pos_;
+                inArray_ = true;
+            } else if (c == ']') {
+                ++pos_;
+                inArray_ = false;
+            } else if (c == '/') {
+                ++pos_;
+                word();  // names are operands we do not need
+            } else {
+                std::string token = word();
+                if (token.empty()) {
+                    ++pos_;
+                    continue;
+                }
+                char first = token[0];
+                bool number = std::isdigit(static_cast<unsigned char>(first)) || first == '-' ||
+                              first == '+' || first == '.';
+                if (number) {
+                    // Large negative kerning inside TJ is how many generators space words
+                    if (inArray_ && std::atof(token.c_str()) < -200.0) operands_.push_back(" ");
+                    continue;
+                }
+                op(token);
+            }
+        }
+    }
+
+private:
+    void op(const std::string& name) {
+        if (name == "Tj" || name == "TJ" || name == "'" || name == "\"") {
+            if (name != "Tj" && name != "TJ") text_ += '\n';
+            for (const auto& s : operands_) appendShown(text_, s);
+        } else if (name == "T*" || name == "Td" || name == "TD" || name == "ET") {
+            text_ += '\n';
+        } else if (name == "Tm") {
+            text_ += ' ';
+        } else if (name == "ID") {
+            skipInlineImage();
+        }
+        operands_.clear();
+    }
+
+    std::string word() {
+        size_t start = pos_;
+        while (pos_ < src_.size() && !isDelimiter(src_[pos_])) ++pos_;
+        return src_.substr(start, pos_ - start);
+    }
+
+    std::string literal() {
+        std::string out;
+        int depth = 0;
+        ++pos_;  // (
+        while (pos_ < src_.size()) {
+            char c = src_[pos_++];
+            if (c == '\\' && pos_ < src_.size()) {
+                char e = src_[pos_++];
+                switch (e) {
+                    case 'n': out += '\n'; break;
+                    case 'r': out += '\r'; break;
+                    case 't': out += '\t'; break;
+                    case 'b': out += '\b'; break;
+                    case 'f': out += '\f'; break;
+                    case '\r':
+                        if (pos_ < src_.size() && src_[pos_] == '\n') ++pos_;
+                        break;
+                    case '\n': break;
+                    default:
+                        if (e >= '0' && e <= '7') {
+                            int value = e - '0';
+                            for (int i = 0; i < 2 && pos_ < src_.size() && src_[pos_] >= '0' && src_[pos_] <= '7'; ++i) {
+                                value = value * 8 + (src_[pos_++] - '0');
+                            }
+                            out += static_cast<char>(value & 0xff);
+                        } else {
+                            out += e;
+                        }
+                }
+            } else if (c == '(') {
+                ++depth;
+                out += c;
+            } else if (c == ')') {
+                if (depth == 0) break;
+                --depth;
+                out += c;
+            } else {
+                out += c;
+            }
+        }
+        return out;
+    }
+
+    std::string hex() {
+        std::string out;
+        int high = -1;
+        ++pos_;  // <
+        while (pos_ < src_.size() && src_[pos_] != '>') {
+            char c = src_[pos_++];
+            if (!std::isxdigit(static_cast<unsigned char>(c))) continue;
+            int v = std::isdigit(static_cast<unsigned char>(c)) ? c - '0' : (std::tolower(c) - 'a' + 10);
+            if (high < 0) {
+                high = v;
+            } else {
+                out += static_cast<char>((high << 4) | v);
+                high = -1;
+            }
+        }
+        if (high >= 0) out += static_cast<char>(high << 4);
+        ++pos_;  // >
+        return out;
+    }
+
+    // BI <params> ID <binary> EI
+    void skipInlineImage() {
+        while (pos_ + 2 < src_.size()) {
+            if (src_[pos_] == 'E' && src_[pos_ + 1] == 'I' &&
+                std::isspace(static_cast<unsigned char>(src_[pos_ - 1])) &&
+                (pos_ + 2 == src_.size() || isDelimiter(src_[pos_ + 2]))) {
+                pos_ += 2;
+                return;
+            }
+            ++pos_;
+        }
+        pos_ = src_.size();
+    }
+
+    const std::string& src_;
+    std::string& text_;
+    size_t maxText_;
+    size_t pos_ = 0;
+    bool inArray_ = false;
+    std::vector<std::string> operands_;
+};
+
+const std::unordered_set<std::string>& stopWords() {
+    static const std::unordered_set<std::string> words = {
+        "a", "an", "and", "are", "as", "at", "be", "been", "but", "by", "for", "from", "has",
+        "have", "he", "her", "his", "i", "in", "into", "is", "it", "its", "me", "my", "of", "on",
+        "or", "our", "she", "so", "than", "that", "the", "their", "them", "then", "there", "these",
+        "they", "this", "to", "was", "we", "were", "which", "while", "who", "will", "with", "you",
+        "your", "am", "also", "etc", "via", "using", "used", "use", "all", "any", "can", "during",
+        "over", "per", "up", "out", "not", "no", "more", "most", "other", "such", "each", "both",
+    };
+    return words;
+}
+
+// Filter names all end in "Decode"; /DecodeParms is not one of them
+size_t countFilters(const std::string& dict) {
+    size_t count = 0;
+    for (size_t at = dict.find("Decode"); at != std::string::npos; at = dict.find("Decode", at + 6)) {
+        if (dict.compare(at, 11, "DecodeParms") != 0) ++count;
+    }
+    return count;
+}
+
+bool tokenChar(char c) {
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '+' || c == '#' || c == '.';
+}
+
+} // anonymous namespace
+
+std::string PdfText::extract(const std::string& pdf, size_t maxText) {
+    std::string text;
+    size_t inflatedTotal = 0;
+    size_t pos = 0;
+
+    while (text.size() < maxText && inflatedTotal < kMaxInflatedTotal) {
+        size_t keyword = pdf.find("stream", pos);
+        if (keyword == std::string::npos) break;
+        pos = keyword + 6;
+        // Skip "endstream" and stray matches; a stream keyword follows a dictionary
+        if (keyword >= 3 && pdf.compare(keyword - 3, 3, "end") == 0) continue;
+        size_t dataStart = pos;
+        if (dataStart < pdf.size() && pdf[dataStart] == '\r') ++dataStart;
+        if (dataStart < pdf.size() && pdf[dataStart] == '\n') ++dataStart;
+        if (dataStart == pos) continue;
+
+        size_t dataEnd = pdf.find("endstream", dataStart);
+        if (dataEnd == std::string::npos) break;
+        pos = dataEnd + 9;
+
+        // The dictionary sits between the object header and the stream keyword
+        size_t objStart = pdf.rfind(" obj", keyword);
+        if (objStart == std::string::npos) continue;
+        std::string dict = pdf.substr(objStart, keyword - objStart);
+        // Fonts, images and cross-reference data never hold page text
+        if (dict.find("/Image") != std::string::npos || dict.find("/FontFile") != std::string::npos ||
+            dict.find("/Length1") != std::string::npos || dict.find("/XRef") != std::string::npos ||
+            dict.find("/ObjStm") != std::string::npos || dict.find("/Metadata") != std::string::npos) {
+            continue;
+        }
+
+        std::string content;
+        if (dict.find("/Filter") != std::string::npos) {
+            // Other filters (and chains) are rare for content streams
+            if (dict.find("/FlateDecode") == std::string::npos || countFilters(dict) != 1) continue;
+            if (!inflateStream(pdf.data() + dataStart, dataEnd - dataStart, content)) continue;
+        } else {
+            content.assign(pdf, dataStart, dataEnd - dataStart);
+        }
+        inflatedTotal += content.size();
+
+        // Cheap check before parsing: page content shows text with BT ... ET
+        if (content.find("BT") == std::string::npos) continue;
+        ContentParser(content, text, maxText).run();
+        text += '\n';
+    }
+
+    if (text.size() > maxText) text.resize(maxText);
+    return text;
+}
+
+std::vector<std::string> PdfText::keywords(const std::string& text, size_t limit) {
+    std::unordered_map<std::string, size_t> counts;
+    std::vector<std::string> order;
+    const auto& stop = stopWords();
+
+    size_t i = 0;
+    while (i < text.size()) {
+        while (i < text.size() && !tokenChar(text[i])) ++i;
+        size_t start = i;
+        while (i < text.size() && tokenChar(text[i])) ++i;
+        std::string token = text.substr(start, i - start);
+
+        // Sentence punctuation, not part of "node.js" or "c++"
+        while (!token.empty() && token.back() == '.') token.pop_back();
+        while (!token.empty() && token.front() == '.') token.erase(0, 1);
+        if (token.size() < 2 || token.size() > 32) continue;
+        std::transform(token.begin(), token.end(), token.begin(),
+                       [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        if (!std::isalpha(static_cast<unsigned char>(token[0]))) continue;  // numbers, dates, phone numbers
+        if (stop.count(token)) continue;
+
+        if (counts[token]++ == 0) order.push_back(token);
+    }
+
+    // Most frequent first; stable so ties keep document order
+    std::stable_sort(order.begin(), order.end(), [&counts](const std::string& a, const std::string& b) {
+        return counts[a] > counts[b];
+    });
+    if (order.size() > limit) order.resize(limit);
+    return order;
+}
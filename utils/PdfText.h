@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Best-effort text from a PDF without an external service: inflates the
+// FlateDecode content streams (zlib) and collects the strings shown by the
+// Tj/TJ/'/" operators. Enough for resumes exported by word processors and
+// LaTeX; fonts with Identity-H encodings and no ASCII mapping, scanned pages
+// and encrypted files yield little or no text.
+class PdfText {
+public:
+    // Stops once `maxText` bytes of text have been collected
+    static std::string extract(const std::string& pdf, size_t maxText = 256 * 1024);
+
+    // Lowercased tokens ("c++", "node.js", "postgresql"), stop words and
+    // numbers dropped, most frequent first
+    static std::vector<std::string> keywords(const std::string& text, size_t limit);
+};
@@ -0,0 +1,167 @@
+#include "RequestTrace.h"
+#include <cstdio>
+
+namespace {
+
+thread_local std::shared_ptr<RequestTrace> currentTrace;
+// Open scopes per phase on this thread, so nested scopes count once
+thread_local int openScopes[static_cast<size_t>(RequestTrace::Phase::Count)] = {};
+
+std::string millis(int64_t micros) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.1f", static_cast<double>(micros) / 1000.0);
+    return buf;
+}
+
+std::string jsonEscape(const std::string& s) {
+    std::string out;
+    for (char c : s) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            out += ' ';
+        } else {
+            out += c;
+        }
+    }
+    return out;
+}
+
+} // anonymous namespace
+
+RequestTrace::RequestTrace(std::string id, bool sampled)
+    : id_(std::move(id)), sampled_(sampled), started_(std::chrono::steady_clock::now()) {}
+
+void RequestTrace::attach(std::shared_ptr<RequestTrace> trace) {
+    currentTrace = std::move(trace);
+}
+
+RequestTrace* RequestTrace::current() {
+    return currentTrace.get();
+}
+
+const char* RequestTrace::phaseName(Phase phase) {
+    switch (phase) {
+        case Phase::Filter: return "filter";
+        case Phase::Db: return "db";
+        case Phase::Transform: return "transform";
+        case Phase::Serialize: return "serialize";
+        default: return "other";
+    }
+}
+
+int64_t RequestTrace::elapsedUs() const {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - started_).count();
+}
+
+void RequestTrace::add(Phase phase, int64_t startUs, int64_t durationUs, std::string detail) {
+    size_t i = static_cast<size_t>(phase);
+    totals_[i].fetch_add(durationUs, std::memory_order_relaxed);
+    counts_[i].fetch_add(1, std::memory_order_relaxed);
+    if (!sampled_) return;
+
+    std::lock_guard<std::mutex> lock(spansMutex_);
+    if (spans_.size() >= kMaxSpans) {
+        ++droppedSpans_;
+        return;
+    }
+    spans_.push_back({phase, std::move(detail), startUs, durationUs});
+}
+
+void RequestTrace::markHandlerStart() {
+    handlerStartUs_ = elapsedUs();
+    add(Phase::Filter, 0, handlerStartUs_);
+}
+
+void RequestTrace::markHandlerEnd() {
+    handlerEndUs_ = elapsedUs();
+}
+
+int64_t RequestTrace::handlerUs() const {
+    if (handlerStartUs_ < 0 || handlerEndUs_ < handlerStartUs_) return -1;
+    return handlerEndUs_ - handlerStartUs_;
+}
+
+int64_t RequestTrace::totalUs(Phase phase) const {
+    return totals_[static_cast<size_t>(phase)].load(std::memory_order_relaxed);
+}
+
+size_t RequestTrace::count(Phase phase) const {
+    return counts_[static_cast<size_t>(phase)].load(std::memory_order_relaxed);
+}
+
+RequestTrace::Scope::Scope(Phase phase, const char* detail)
+    : trace_(currentTrace.get()), phase_(phase), detail_(detail) {
+    if (!trace_) return;
+    counted_ = true;
+    if (openScopes[static_cast<size_t>(phase_)]++ > 0) {
+        trace_ = nullptr;  // the outer scope already covers this time
+        return;
+    }
+    startUs_ = trace_->elapsedUs();
+}
+
+RequestTrace::Scope::~Scope() {
+    if (counted_) --openScopes[static_cast<size_t>(phase_)];
+    if (!trace_) return;
+    trace_->add(phase_, startUs_, trace_->elapsedUs() - startUs_, detail_ ? detail_ : "");
+}
+
+std::string RequestTrace::serverTiming(int64_t requestUs) const {
+    std::string out;
+    int64_t explained = 0;
+    for (size_t i = 0; i < kPhases; ++i) {
+        auto phase = static_cast<Phase>(i);
+        size_t n = count(phase);
+        if (n == 0) continue;
+        int64_t us = totalUs(phase);
+        if (phase != Phase::Filter) explained += us;
+        if (!out.empty()) out += ", ";
+        out += phaseName(phase);
+        out += ";dur=" + millis(us);
+        if (phase == Phase::Db) out += ";desc=\"" + std::to_string(n) + (n == 1 ? " command\"" : " commands\"");
+    }
+    // Filters may issue db commands too (AuthFilter's user lookup), so this
+    // can undercount; it is clamped rather than going negative
+    int64_t handler = handlerUs();
+    if (handler >= 0) {
+        if (!out.empty()) out += ", ";
+        out += "app;dur=" + millis(handler > explained ? handler - explained : 0);
+    }
+    if (!out.empty()) out += ", ";
+    out += "total;dur=" + millis(requestUs);
+    return out;
+}
+
+std::string RequestTrace::timeline(const std::string& method, const std::string& route, int status,
+                                   int64_t requestUs) const {
+    std::string out = "{\"trace\":\"" + jsonEscape(id_) + "\",\"method\":\"" + jsonEscape(method) +
+                      "\",\"route\":\"" + jsonEscape(route) + "\",\"status\":" + std::to_string(status) +
+                      ",\"sampled\":" + (sampled_ ? "true" : "false") + ",\"total_ms\":" + millis(requestUs) +
+                      ",\"phases\":{";
+    for (size_t i = 0; i < kPhases; ++i) {
+        auto phase = static_cast<Phase>(i);
+        if (i > 0) out += ",";
+        out += "\"" + std::string(phaseName(phase)) + "\":{\"ms\":" + millis(totalUs(phase)) +
+               ",\"count\":" + std::to_string(count(phase)) + "}";
+    }
+    out += "}";
+
+    if (sampled_) {
+        std::lock_guard<std::mutex> lock(spansMutex_);
+        out += ",\"spans\":[";
+        for (size_t i = 0; i < spans_.size(); ++i) {
+            const auto& s = spans_[i];
+            if (i > 0) out += ",";
+            out += "{\"phase\":\"" + std::string(phaseName(s.phase)) + "\"";
+            if (!s.detail.empty()) out += ",\"detail\":\"" + jsonEscape(s.detail) + "\"";
+            out += ",\"start_ms\":" + millis(s.startUs) + ",\"ms\":" + millis(s.durationUs) + "}";
+        }
+        out += "]";
+        if (droppedSpans_ > 0) out += ",\"dropped_spans\":" + std::to_string(droppedSpans_);
+    }
+    out += "}";
+    return out;
+}
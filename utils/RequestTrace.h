@@ -0,0 +1,95 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Request-scoped timings. Every request gets per-phase totals (filter, db,
+// transform, serialize) for its Server-Timing header; a sampled request
+// (TRACE_SAMPLE_RATE, default 0.01) also keeps each span for a timeline log.
+//
+// Like MongoMonitor, a trace is bound to the IO thread serving the request,
+// and code deep in a handler finds it through current(). With no trace
+// bound, a Scope costs one thread-local read; when the request is not
+// sampled, it costs two clock reads and an atomic add.
+class RequestTrace {
+public:
+    enum class Phase { Filter, Db, Transform, Serialize, Count };
+
+    struct Span {
+        Phase phase;
+        std::string detail;
+        int64_t startUs;   // from the start of the trace
+        int64_t durationUs;
+    };
+
+    // Spans kept per sampled request; later ones only count toward the totals
+    static constexpr size_t kMaxSpans = 256;
+
+    RequestTrace(std::string id, bool sampled);
+
+    // Binds `trace` to the calling thread until the next call
+    static void attach(std::shared_ptr<RequestTrace> trace);
+    static RequestTrace* current();
+
+    // Times the enclosed code as one span of `phase` on the current trace.
+    // Nested scopes of the same phase (bsonToJson inside a loop inside
+    // another transform) count once.
+    class Scope {
+    public:
+        explicit Scope(Phase phase, const char* detail = nullptr);
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        RequestTrace* trace_;
+        Phase phase_;
+        const char* detail_;
+        bool counted_ = false;
+        int64_t startUs_ = 0;
+    };
+
+    void add(Phase phase, int64_t startUs, int64_t durationUs, std::string detail = {});
+    int64_t elapsedUs() const;
+
+    // Called by RequestTracing around the handler; filters end where it starts
+    void markHandlerStart();
+    void markHandlerEnd();
+    // -1 when the handler never ran (a filter answered, or no route matched)
+    int64_t handlerUs() const;
+
+    const std::string& id() const { return id_; }
+    bool sampled() const { return sampled_; }
+    int64_t totalUs(Phase phase) const;
+    size_t count(Phase phase) const;
+
+    // filter;dur=0.8, db;dur=12.4;desc="5 commands", ..., app;dur=2.1, total;dur=19.9
+    // app is the handler time that db/transform/serialize do not explain
+    std::string serverTiming(int64_t requestUs) const;
+    // One JSON line for the log; spans only when sampled
+    std::string timeline(const std::string& method, const std::string& route, int status,
+                         int64_t requestUs) const;
+
+    static const char* phaseName(Phase phase);
+
+private:
+    static constexpr size_t kPhases = static_cast<size_t>(Phase::Count);
+
+    std::string id_;
+    bool sampled_;
+    std::chrono::steady_clock::time_point started_;
+    std::atomic<int64_t> totals_[kPhases] = {};
+    std::atomic<uint32_t> counts_[kPhases] = {};
+    int64_t handlerStartUs_ = -1;
+    int64_t handlerEndUs_ = -1;
+
+    mutable std::mutex spansMutex_;
+    std::vector<Span> spans_;
+    size_t droppedSpans_ = 0;
+};
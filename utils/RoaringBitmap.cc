@@ -0,0 +1,173 @@
+#include "RoaringBitmap.h"
+#include <algorithm>
+#include <iterator>
+
+void RoaringBitmap::Container::toBitset() {
+    bits.assign(kBitsetWords, 0);
+    for (uint16_t v : values) {
+        bits[v >> 6] |= (uint64_t{1} << (v & 63));
+    }
+    values.clear();
+    values.shrink_to_fit();
+    isBitset = true;
+}
+
+void RoaringBitmap::Container::toArray() {
+    values.clear();
+    values.reserve(card);
+    for (size_t w = 0; w < bits.size(); ++w) {
+        uint64_t word = bits[w];
+        while (word) {
+            values.push_back(static_cast<uint16_t>(w * 64 + __builtin_ctzll(word)));
+            word &= word - 1;
+        }
+    }
+    bits.clear();
+    bits.shrink_to_fit();
+    isBitset = false;
+}
+
+RoaringBitmap::Container* RoaringBitmap::find(uint16_t key) {
+    auto it = std::lower_bound(containers_.begin(), containers_.end(), key,
+                               [](const Container& c, uint16_t k) { return c.key < k; });
+    if (it == containers_.end() || it->key != key) return nullptr;
+    return &*it;
+}
+
+const RoaringBitmap::Container* RoaringBitmap::find(uint16_t key) const {
+    auto it = std::lower_bound(containers_.begin(), containers_.end(), key,
+                               [](const Container& c, uint16_t k) { return c.key < k; });
+    if (it == containers_.end() || it->key != key) return nullptr;
+    return &*it;
+}
+
+void RoaringBitmap::add(uint32_t value) {
+    uint16_t key = static_cast<uint16_t>(value >> 16);
+    uint16_t low = static_cast<uint16_t>(value & 0xFFFF);
+
+    auto it = std::lower_bound(containers_.begin(), containers_.end(), key,
+                               [](const Container& c, uint16_t k) { return c.key < k; });
+    if (it == containers_.end() || it->key != key) {
+        Container c;
+        c.key = key;
+        it = containers_.insert(it, std::move(c));
+    }
+
+    Container& c = *it;
+    if (c.isBitset) {
+        uint64_t mask = uint64_t{1} << (low & 63);
+        if (!(c.bits[low >> 6] & mask)) {
+            c.bits[low >> 6] |= mask;
+            ++c.card;
+        }
+        return;
+    }
+
+    auto pos = std::lower_bound(c.values.begin(), c.values.end(), low);
+    if (pos != c.values.end() && *pos == low) return;
+    c.values.insert(pos, low);
+    ++c.card;
+    if (c.card > kArrayMax) c.toBitset();
+}
+
+void RoaringBitmap::remove(uint32_t value) {
+    uint16_t key = static_cast<uint16_t>(value >> 16);
+    uint16_t low = static_cast<uint16_t>(value & 0xFFFF);
+
+    auto it = std::lower_bound(containers_.begin(), containers_.end(), key,
+                               [](const Container& c, uint16_t k) { return c.key < k; });
+    if (it == containers_.end() || it->key != key) return;
+
+    Container& c = *it;
+    if (c.isBitset) {
+        uint64_t mask = uint64_t{1} << (low & 63);
+        if (!(c.bits[low >> 6] & mask)) return;
+        c.bits[low >> 6] &= ~mask;
+        --c.card;
+        if (c.card <= kArrayMax) c.toArray();
+    } else {
+        auto pos = std::lower_bound(c.values.begin(), c.values.end(), low);
+        if (pos == c.values.end() || *pos != low) return;
+        c.values.erase(pos);
+        --c.card;
+    }
+
+    if (c.card == 0) containers_.erase(it);
+}
+
+bool RoaringBitmap::contains(uint32_t value) const {
+    const Container* c = find(static_cast<uint16_t>(value >> 16));
+    if (!c) return false;
+    uint16_t low = static_cast<uint16_t>(value & 0xFFFF);
+    if (c->isBitset) {
+        return (c->bits[low >> 6] >> (low & 63)) & 1;
+    }
+    return std::binary_search(c->values.begin(), c->values.end(), low);
+}
+
+uint64_t RoaringBitmap::cardinality() const {
+    uint64_t total = 0;
+    for (const auto& c : containers_) total += c.card;
+    return total;
+}
+
+RoaringBitmap::Container RoaringBitmap::intersect(const Container& a, const Container& b) {
+    Container out;
+    out.key = a.key;
+
+    if (a.isBitset && b.isBitset) {
+        out.bits.resize(kBitsetWords);
+        uint32_t card = 0;
+        for (size_t w = 0; w < kBitsetWords; ++w) {
+            uint64_t word = a.bits[w] & b.bits[w];
+            out.bits[w] = word;
+            card += static_cast<uint32_t>(__builtin_popcountll(word));
+        }
+        out.isBitset = true;
+        out.card = card;
+        if (card <= kArrayMax) out.toArray();
+        return out;
+    }
+
+    if (a.isBitset || b.isBitset) {
+        const Container& arr = a.isBitset ? b : a;
+        const Container& set = a.isBitset ? a : b;
+        out.values.reserve(arr.values.size());
+        for (uint16_t v : arr.values) {
+            if ((set.bits[v >> 6] >> (v & 63)) & 1) out.values.push_back(v);
+        }
+        out.card = static_cast<uint32_t>(out.values.size());
+        return out;
+    }
+
+    out.values.reserve(std::min(a.values.size(), b.values.size()));
+    std::set_intersection(a.values.begin(), a.values.end(),
+                          b.values.begin(), b.values.end(),
+                          std::back_inserter(out.values));
+    out.card = static_cast<uint32_t>(out.values.size());
+    return out;
+}
+
+RoaringBitmap RoaringBitmap::intersect(const RoaringBitmap& a, const RoaringBitmap& b) {
+    RoaringBitmap out;
+    size_t i = 0, j = 0;
+    while (i < a.containers_.size() && j < b.containers_.size()) {
+        uint16_t ka = a.containers_[i].key;
+        uint16_t kb = b.containers_[j].key;
+        if (ka < kb) {
+            ++i;
+        } else if (kb < ka) {
+            ++j;
+        } else {
+            Container c = intersect(a.containers_[i], b.containers_[j]);
+            if (c.card > 0) out.containers_.push_back(std::move(c));
+            ++i;
+            ++j;
+        }
+    }
+    return out;
+}
+
+void RoaringBitmap::intersectWith(const RoaringBitmap& other) {
+    *this = intersect(*this, other);
+}
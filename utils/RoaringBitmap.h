@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Compressed bitmap of 32-bit ids, laid out like Roaring: ids are split into
+// 16-bit chunks keyed by their high half, and each chunk stores its low halves
+// either as a sorted array (sparse) or as a 65536-bit bitset (dense).
+class RoaringBitmap {
+public:
+    void add(uint32_t value);
+    void remove(uint32_t value);
+    bool contains(uint32_t value) const;
+    uint64_t cardinality() const;
+    bool empty() const { return containers_.empty(); }
+    void clear() { containers_.clear(); }
+
+    static RoaringBitmap intersect(const RoaringBitmap& a, const RoaringBitmap& b);
+    void intersectWith(const RoaringBitmap& other);
+
+    // Calls fn(id) for every id in ascending order; fn returns false to stop
+    template <typename Fn>
+    void forEach(Fn&& fn) const {
+        for (const auto& c : containers_) {
+            uint32_t high = static_cast<uint32_t>(c.key) << 16;
+            if (c.isBitset) {
+                for (size_t w = 0; w < c.bits.size(); ++w) {
+                    uint64_t word = c.bits[w];
+                    while (word) {
+                        uint32_t bit = static_cast<uint32_t>(__builtin_ctzll(word));
+                        if (!fn(high | static_cast<uint32_t>(w * 64 + bit))) return;
+                        word &= word - 1;
+                    }
+                }
+            } else {
+                for (uint16_t low : c.values) {
+                    if (!fn(high | low)) return;
+                }
+            }
+        }
+    }
+
+private:
+    static constexpr uint32_t kArrayMax = 4096;   // beyond this a bitset is smaller
+    static constexpr size_t kBitsetWords = 1024;  // 65536 bits
+
+    struct Container {
+        uint16_t key = 0;
+        bool isBitset = false;
+        uint32_t card = 0;
+        std::vector<uint16_t> values;  // array form, sorted
+        std::vector<uint64_t> bits;    // bitset form
+
+        void toBitset();
+        void toArray();
+    };
+
+    static Container intersect(const Container& a, const Container& b);
+    Container* find(uint16_t key);
+    const Container* find(uint16_t key) const;
+
+    std::vector<Container> containers_;  // sorted by key
+};
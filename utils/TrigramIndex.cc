@@ -0,0 +1,133 @@
+#include "TrigramIndex.h"
+#include <algorithm>
+#include <cctype>
+
+namespace {
+
+// Queries must share at least this fraction of their trigrams with a document
+constexpr double kMinOverlap = 0.5;
+
+uint32_t pack(unsigned char a, unsigned char b, unsigned char c) {
+    return (static_cast<uint32_t>(a) << 16) | (static_cast<uint32_t>(b) << 8) | c;
+}
+
+} // anonymous namespace
+
+std::string TrigramIndex::normalize(const std::string& text) {
+    // Lowercase, and collapse anything that is not a letter, digit or '@'
+    // into single spaces so "CS-2021/045" and "cs 2021 045" index the same.
+    std::string out;
+    out.reserve(text.size());
+    bool space = true;
+    for (unsigned char ch : text) {
+        if (std::isalnum(ch) || ch == '@' || ch >= 0x80) {
+            out.push_back(static_cast<char>(std::tolower(ch)));
+            space = false;
+        } else if (!space) {
+            out.push_back(' ');
+            space = true;
+        }
+    }
+    if (!out.empty() && out.back() == ' ') out.pop_back();
+    return out;
+}
+
+std::vector<uint32_t> TrigramIndex::trigramsOf(const std::string& normalized) {
+    std::vector<uint32_t> grams;
+    size_t start = 0;
+    while (start < normalized.size()) {
+        size_t end = normalized.find(' ', start);
+        if (end == std::string::npos) end = normalized.size();
+
+        // "  " + word, so the first letters of each word form their own trigrams
+        std::string word = "  " + normalized.substr(start, end - start);
+        for (size_t i = 0; i + 2 < word.size(); ++i) {
+            grams.push_back(pack(word[i], word[i + 1], word[i + 2]));
+        }
+        start = end + 1;
+    }
+    std::sort(grams.begin(), grams.end());
+    grams.erase(std::unique(grams.begin(), grams.end()), grams.end());
+    return grams;
+}
+
+void TrigramIndex::set(uint32_t doc, const std::vector<std::string>& fields) {
+    remove(doc);
+
+    Doc entry;
+    std::string all;
+    for (const auto& field : fields) {
+        std::string norm = normalize(field);
+        if (norm.empty()) continue;
+        all += norm;
+        all += ' ';
+        entry.fields.push_back(std::move(norm));
+    }
+    entry.trigrams = trigramsOf(all);
+
+    for (uint32_t gram : entry.trigrams) {
+        auto& list = postings_[gram];
+        list.insert(std::lower_bound(list.begin(), list.end(), doc), doc);
+    }
+    docs_.emplace(doc, std::move(entry));
+}
+
+void TrigramIndex::remove(uint32_t doc) {
+    auto it = docs_.find(doc);
+    if (it == docs_.end()) return;
+
+    for (uint32_t gram : it->second.trigrams) {
+        auto pit = postings_.find(gram);
+        if (pit == postings_.end()) continue;
+        auto& list = pit->second;
+        auto pos = std::lower_bound(list.begin(), list.end(), doc);
+        if (pos != list.end() && *pos == doc) list.erase(pos);
+        if (list.empty()) postings_.erase(pit);
+    }
+    docs_.erase(it);
+}
+
+std::vector<TrigramIndex::Hit> TrigramIndex::search(const std::string& query, size_t limit) const {
+    std::vector<Hit> hits;
+    std::string norm = normalize(query);
+    if (norm.empty() || limit == 0) return hits;
+
+    auto grams = trigramsOf(norm);
+    if (grams.empty()) return hits;
+
+    // Count shared trigrams per candidate, only touching the query's posting lists
+    std::unordered_map<uint32_t, uint32_t> overlap;
+    for (uint32_t gram : grams) {
+        auto it = postings_.find(gram);
+        if (it == postings_.end()) continue;
+        for (uint32_t doc : it->second) ++overlap[doc];
+    }
+
+    auto needed = static_cast<uint32_t>(grams.size() * kMinOverlap + 0.999);
+    for (const auto& [doc, count] : overlap) {
+        if (count < needed) continue;
+        double score = static_cast<double>(count) / grams.size();
+
+        // Reward exact prefix / substring matches over fuzzy ones
+        const Doc& d = docs_.at(doc);
+        double bonus = 0.0;
+        for (const auto& field : d.fields) {
+            if (field.compare(0, norm.size(), norm) == 0) {
+                bonus = 1.0;
+                break;
+            }
+            size_t pos = field.find(norm);
+            if (pos == std::string::npos) continue;
+            bonus = std::max(bonus, field[pos - 1] == ' ' ? 0.75 : 0.5);
+        }
+        hits.push_back({doc, score + bonus});
+    }
+
+    size_t keep = std::min(limit, hits.size());
+    std::partial_sort(hits.begin(), hits.begin() + keep, hits.end(),
+                      [](const Hit& a, const Hit& b) {
+                          return a.score != b.score ? a.score > b.score : a.doc < b.doc;
+                      });
+    hits.resize(keep);
+    return hits;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Trigram inverted index over short text fields (names, emails, roll numbers).
+// Words are padded at the front only, so a query matches any field whose
+// words start with it ("tam" finds "Tamilarasan") and tolerates typos.
+// Not thread-safe; callers serialize access.
+class TrigramIndex {
+public:
+    struct Hit {
+        uint32_t doc;
+        double score;
+    };
+
+    // Replace the indexed text of a document
+    void set(uint32_t doc, const std::vector<std::string>& fields);
+    void remove(uint32_t doc);
+
+    // Best matches first; score is in (0, 2]
+    std::vector<Hit> search(const std::string& query, size_t limit) const;
+
+    size_t size() const { return docs_.size(); }
+
+    static std::string normalize(const std::string& text);
+
+private:
+    static std::vector<uint32_t> trigramsOf(const std::string& normalized);
+
+    struct Doc {
+        std::vector<std::string> fields;  // normalized
+        std::vector<uint32_t> trigrams;   // unique, sorted
+    };
+
+    std::unordered_map<uint32_t, std::vector<uint32_t>> postings_;  // trigram -> sorted doc ids
+    std::unordered_map<uint32_t, Doc> docs_;
+};
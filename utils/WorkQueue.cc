@@ -0,0 +1,55 @@
+#include "WorkQueue.h"
+#include <iostream>
+
+WorkQueue::WorkQueue(std::string name, size_t workers) : name_(std::move(name)) {
+    if (workers == 0) workers = 1;
+    threads_.reserve(workers);
+    for (size_t i = 0; i < workers; ++i) {
+        threads_.emplace_back([this]() { run(); });
+    }
+}
+
+WorkQueue::~WorkQueue() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    for (auto& t : threads_) {
+        if (t.joinable()) t.join();
+    }
+}
+
+void WorkQueue::post(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tasks_.push_back(std::move(task));
+    }
+    cv_.notify_one();
+}
+
+size_t WorkQueue::depth() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return tasks_.size();
+}
+
+void WorkQueue::run() {
+    for (;;) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this]() { return stopping_ || !tasks_.empty(); });
+            if (stopping_ && tasks_.empty()) return;
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+        }
+
+        try {
+            task();
+        } catch (const std::exception& e) {
+            std::cerr << "Warning: " << name_ << " task failed: " << e.what() << std::endl;
+        } catch (...) {
+            std::cerr << "Warning: " << name_ << " task failed" << std::endl;
+        }
+    }
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Fixed-size pool of worker threads draining a FIFO of tasks.
+// Used for work that must not hold up an HTTP response.
+class WorkQueue {
+public:
+    WorkQueue(std::string name, size_t workers);
+    ~WorkQueue();
+
+    WorkQueue(const WorkQueue&) = delete;
+    WorkQueue& operator=(const WorkQueue&) = delete;
+
+    void post(std::function<void()> task);
+
+    // Tasks waiting for a worker (excludes the ones currently running)
+    size_t depth() const;
+    size_t workers() const { return threads_.size(); }
+
+private:
+    void run();
+
+    std::string name_;
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<std::function<void()>> tasks_;
+    std::vector<std::thread> threads_;
+    bool stopping_ = false;
+};
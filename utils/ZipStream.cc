@@ -0,0 +1,181 @@
+#include "ZipStream.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <ctime>
+
+namespace {
+
+const std::array<uint32_t, 256>& crcTable() {
+    static const std::array<uint32_t, 256> table = [] {
+        std::array<uint32_t, 256> t{};
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            t[i] = c;
+        }
+        return t;
+    }();
+    return table;
+}
+
+uint32_t crc32Update(uint32_t crc, const char* data, size_t length) {
+    const auto& table = crcTable();
+    crc = ~crc;
+    for (size_t i = 0; i < length; ++i) {
+        crc = table[(crc ^ static_cast<unsigned char>(data[i])) & 0xff] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+void put16(std::string& out, uint16_t v) {
+    out += static_cast<char>(v & 0xff);
+    out += static_cast<char>((v >> 8) & 0xff);
+}
+
+void put32(std::string& out, uint32_t v) {
+    for (int i = 0; i < 4; ++i) out += static_cast<char>((v >> (8 * i)) & 0xff);
+}
+
+// Bit 3: sizes and CRC follow the data; bit 11: names are UTF-8
+constexpr uint16_t kFlags = 0x0808;
+constexpr uint16_t kVersion = 20;
+
+} // anonymous namespace
+
+ZipStream::ZipStream(std::vector<Entry> entries) : entries_(std::move(entries)) {
+    std::time_t now = std::time(nullptr);
+    std::tm tm{};
+    localtime_r(&now, &tm);
+    dosTime_ = static_cast<uint16_t>((tm.tm_hour << 11) | (tm.tm_min << 5) | (tm.tm_sec / 2));
+    dosDate_ = static_cast<uint16_t>(((tm.tm_year - 80) << 9) | ((tm.tm_mon + 1) << 5) | tm.tm_mday);
+    written_.reserve(entries_.size());
+}
+
+void ZipStream::beginEntry() {
+    const auto& entry = entries_[index_];
+    Written w;
+    w.offset = static_cast<uint32_t>(offset_);
+    written_.push_back(w);
+
+    put32(pending_, 0x04034b50);
+    put16(pending_, kVersion);
+    put16(pending_, kFlags);
+    put16(pending_, 0);  // stored
+    put16(pending_, dosTime_);
+    put16(pending_, dosDate_);
+    put32(pending_, 0);  // crc, compressed and uncompressed size: in the descriptor
+    put32(pending_, 0);
+    put32(pending_, 0);
+    put16(pending_, static_cast<uint16_t>(entry.name.size()));
+    put16(pending_, 0);
+    pending_ += entry.name;
+
+    crc_ = 0;
+    entrySize_ = 0;
+    dataPos_ = 0;
+    if (!entry.path.empty()) file_.open(entry.path, std::ios::binary);
+}
+
+void ZipStream::endEntry() {
+    if (file_.is_open()) file_.close();
+    file_.clear();
+
+    auto& w = written_.back();
+    w.crc = crc_;
+    w.size = static_cast<uint32_t>(entrySize_);
+
+    put32(pending_, 0x08074b50);
+    put32(pending_, w.crc);
+    put32(pending_, w.size);
+    put32(pending_, w.size);
+    ++index_;
+}
+
+void ZipStream::writeDirectory() {
+    uint64_t start = offset_;
+    for (size_t i = 0; i < written_.size(); ++i) {
+        const auto& entry = entries_[i];
+        const auto& w = written_[i];
+        put32(pending_, 0x02014b50);
+        put16(pending_, kVersion);
+        put16(pending_, kVersion);
+        put16(pending_, kFlags);
+        put16(pending_, 0);
+        put16(pending_, dosTime_);
+        put16(pending_, dosDate_);
+        put32(pending_, w.crc);
+        put32(pending_, w.size);
+        put32(pending_, w.size);
+        put16(pending_, static_cast<uint16_t>(entry.name.size()));
+        put16(pending_, 0);  // extra
+        put16(pending_, 0);  // comment
+        put16(pending_, 0);  // disk
+        put16(pending_, 0);  // internal attributes
+        put32(pending_, 0);  // external attributes
+        put32(pending_, w.offset);
+        pending_ += entry.name;
+    }
+    uint64_t directorySize = pending_.size();
+
+    put32(pending_, 0x06054b50);
+    put16(pending_, 0);
+    put16(pending_, 0);
+    put16(pending_, static_cast<uint16_t>(written_.size()));
+    put16(pending_, static_cast<uint16_t>(written_.size()));
+    put32(pending_, static_cast<uint32_t>(directorySize));
+    put32(pending_, static_cast<uint32_t>(start));
+    put16(pending_, 0);
+}
+
+size_t ZipStream::read(char* buf, size_t size) {
+    size_t filled = 0;
+    while (filled < size) {
+        if (pendingPos_ < pending_.size()) {
+            size_t n = std::min(size - filled, pending_.size() - pendingPos_);
+            std::memcpy(buf + filled, pending_.data() + pendingPos_, n);
+            pendingPos_ += n;
+            filled += n;
+            offset_ += n;
+            continue;
+        }
+        pending_.clear();
+        pendingPos_ = 0;
+
+        if (state_ == State::Done) break;
+        if (state_ == State::Header) {
+            if (index_ >= entries_.size()) {
+                writeDirectory();
+                state_ = State::Done;
+            } else {
+                beginEntry();
+                state_ = State::Body;
+            }
+            continue;
+        }
+
+        // Body: straight from the file (or inline data) into the caller's buffer
+        const auto& entry = entries_[index_];
+        size_t n = 0;
+        if (!entry.path.empty()) {
+            if (file_) {
+                file_.read(buf + filled, static_cast<std::streamsize>(size - filled));
+                n = static_cast<size_t>(file_.gcount());
+            }
+        } else if (dataPos_ < entry.data.size()) {
+            n = std::min(size - filled, entry.data.size() - dataPos_);
+            std::memcpy(buf + filled, entry.data.data() + dataPos_, n);
+            dataPos_ += n;
+        }
+        if (n > 0) {
+            crc_ = crc32Update(crc_, buf + filled, n);
+            entrySize_ += n;
+            filled += n;
+            offset_ += n;
+            continue;
+        }
+        endEntry();
+        state_ = State::Header;
+    }
+    return filled;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Produces a ZIP archive incrementally, for pull-style streamed responses.
+// Entries use the store method (PDFs are already compressed) with a data
+// descriptor, so each CRC-32 is computed while the file is copied out and
+// nothing is staged on disk. Memory is the entry list plus one read buffer.
+// No ZIP64: callers keep the archive under 4 GiB.
+class ZipStream {
+public:
+    struct Entry {
+        std::string name;
+        std::string path;   // file to copy; empty means `data` is the content
+        std::string data;
+    };
+
+    // Fixed header bytes an entry adds beyond its name and content
+    static constexpr uint64_t kEntryOverhead = 30 + 16 + 46;
+    static constexpr uint64_t kMaxArchiveSize = 0xFFFFFFFFull;
+
+    explicit ZipStream(std::vector<Entry> entries);
+
+    // Copies up to `size` bytes of archive into `buf`; 0 once it is complete
+    size_t read(char* buf, size_t size);
+
+private:
+    struct Written {
+        uint32_t crc = 0;
+        uint32_t size = 0;
+        uint32_t offset = 0;
+    };
+
+    enum class State { Header, Body, Done };
+
+    void beginEntry();
+    void endEntry();
+    void writeDirectory();
+
+    std::vector<Entry> entries_;
+    std::vector<Written> written_;
+    size_t index_ = 0;
+    State state_ = State::Header;
+
+    std::string pending_;
+    size_t pendingPos_ = 0;
+
+    std::ifstream file_;
+    size_t dataPos_ = 0;
+    uint32_t crc_ = 0;
+    uint64_t entrySize_ = 0;
+    uint64_t offset_ = 0;
+    uint16_t dosTime_ = 0;
+    uint16_t dosDate_ = 0;
+};